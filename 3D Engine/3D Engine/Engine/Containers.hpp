@@ -5,7 +5,9 @@
 
 #include "Containers/Array.hpp"
 #include "Containers/Array2D.hpp"
+#include "Containers/DArray.hpp"
 #include "Containers/DList.hpp"
+#include "Containers/HashMap.hpp"
 #include "Containers/SList.hpp"
 
 #endif // !CONTAINERS_HPP
\ No newline at end of file
@@ -0,0 +1,221 @@
+#ifndef CONTAINERS_DARRAY_HPP
+#define CONTAINERS_DARRAY_HPP
+#pragma warning(push)
+#pragma warning(disable : 6386)
+#include <cstddef>
+#include <utility>
+
+// a class used to create dynamically sized 1d arrays stored in one contiguous block
+// @templ typename T: the type that the array will store
+template<typename T>
+class DArray {
+
+	/// array, size and capacity
+	T* arr;
+	size_t sz;
+	size_t cap;
+
+	// moves the values into a new block of the given capacity
+	void Reallocate(size_t new_cap) {
+		T* new_arr = new T[new_cap];
+
+		// move the values over
+		for (size_t i = 0; i < sz; ++i)
+			new_arr[i] = std::move(arr[i]);
+
+		// delete the old array
+		if (arr) delete[] arr;
+
+		arr = new_arr;
+		cap = new_cap;
+	}
+
+public:
+
+	/// default constructor
+	DArray() : arr(nullptr), sz(0), cap(0) { }
+
+	/// constructors
+
+	explicit DArray(size_t capacity_) : arr(nullptr), sz(0), cap(0) {
+		reserve(capacity_);
+	}
+
+
+	/// copy constructor & operator
+
+	DArray(const DArray& other) : arr(nullptr), sz(0), cap(0) {
+		reserve(other.sz);
+
+		// copy the values in the array
+		for (size_t i = 0; i < other.sz; ++i)
+			arr[i] = other.arr[i];
+		sz = other.sz;
+	}
+
+	DArray& operator=(const DArray& other) {
+		if (this == &other) return *this;
+
+		clear();
+		reserve(other.sz);
+
+		// copy the values in the array
+		for (size_t i = 0; i < other.sz; ++i)
+			arr[i] = other.arr[i];
+		sz = other.sz;
+
+		return *this;
+	}
+
+
+	/// move constructor & operator
+
+	DArray(DArray&& other) noexcept : arr(other.arr), sz(other.sz), cap(other.cap) {
+		// free the other array
+		other.arr = nullptr;
+		other.sz = 0;
+		other.cap = 0;
+	}
+
+	DArray& operator=(DArray&& other) noexcept {
+		if (arr) delete[] arr;
+
+		// take the other array
+		arr = other.arr;
+		sz = other.sz;
+		cap = other.cap;
+
+		// free the other array
+		other.arr = nullptr;
+		other.sz = 0;
+		other.cap = 0;
+
+		return *this;
+	}
+
+
+	/// destructor
+	~DArray() {
+		// delete array
+		if (arr) delete[] arr;
+		arr = nullptr;
+		sz = 0;
+		cap = 0;
+	}
+
+
+	/// iteration
+
+	T* begin() noexcept {
+		return arr;
+	}
+
+	T* end() noexcept {
+		return arr + sz;
+	}
+
+	const T* begin() const noexcept {
+		return arr;
+	}
+
+	const T* end() const noexcept {
+		return arr + sz;
+	}
+
+
+	/// operators
+
+	T& operator[](size_t index) {
+		return arr[index];
+	}
+
+	const T& operator[](size_t index) const {
+		return arr[index];
+	}
+
+	T* operator*() {
+		return arr;
+	}
+
+
+	/// functions
+
+	size_t size() const {
+		return sz;
+	}
+
+	size_t capacity() const {
+		return cap;
+	}
+
+	bool empty() const {
+		return sz == 0;
+	}
+
+	T* data() {
+		return arr;
+	}
+
+	const T* data() const {
+		return arr;
+	}
+
+	// return reference to the last value
+	// precondition: array is not empty
+	T& back() {
+		return arr[sz - 1];
+	}
+
+	// makes sure the array can hold at least new_cap values without reallocating
+	void reserve(size_t new_cap) {
+		if (new_cap > cap) Reallocate(new_cap);
+	}
+
+	// changes the number of values, new values are left default constructed
+	void resize(size_t new_size) {
+		reserve(new_size);
+		sz = new_size;
+	}
+
+	// changes the number of values and sets any new values to fill
+	void resize(size_t new_size, const T& fill) {
+		reserve(new_size);
+		for (size_t i = sz; i < new_size; ++i)
+			arr[i] = fill;
+		sz = new_size;
+	}
+
+	// removes all values but keeps the memory
+	void clear() {
+		sz = 0;
+	}
+
+	// inserts a value at the end of the array
+	void push_back(const T& value) {
+		// double the capacity when full
+		if (sz == cap) Reallocate(cap ? cap * 2 : 8);
+		arr[sz++] = value;
+	}
+
+	// removes the last value
+	// precondition: array is not empty
+	void pop_back() {
+		--sz;
+	}
+
+	// removes the value at index by moving the last value into its place
+	// this does not keep the order of the array
+	void swap_remove(size_t index) {
+		if (index != sz - 1)
+			arr[index] = std::move(arr[sz - 1]);
+		--sz;
+	}
+
+	void fill(const T& value) {
+		for (size_t i = 0; i < sz; ++i)
+			arr[i] = value;
+	}
+};
+
+#pragma warning(pop)
+#endif // !CONTAINERS_DARRAY_HPP
\ No newline at end of file
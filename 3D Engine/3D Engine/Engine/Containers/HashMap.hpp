@@ -0,0 +1,192 @@
+#ifndef CONTAINERS_HASHMAP_HPP
+#define CONTAINERS_HASHMAP_HPP
+#pragma warning(push)
+#pragma warning(disable : 6386)
+#include <cstddef>
+#include <utility>
+
+// a class used to map integer keys to values
+// stored in one open addressed table with linear probing so lookups stay in contiguous memory
+// @templ typename K: the key type, must be an integer type
+// @templ typename V: the type that the map will store
+template<typename K, typename V>
+class HashMap {
+
+	/// table
+	K* keys;
+	V* values;
+	unsigned char* used;
+	size_t sz;
+	size_t cap;
+
+	// mixes the bits of the key so close keys spread across the table
+	static size_t Hash(const K& key) {
+		unsigned long long h = static_cast<unsigned long long>(key);
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ULL;
+		h ^= h >> 33;
+		return static_cast<size_t>(h);
+	}
+
+	// finds the slot the key is in or the empty slot it would go in
+	size_t Slot(const K& key) const {
+		size_t mask = cap - 1;
+		size_t i = Hash(key) & mask;
+		while (used[i] && keys[i] != key)
+			i = (i + 1) & mask;
+		return i;
+	}
+
+	// moves every value into a new table of the given capacity
+	// precondition: new_cap is a power of 2
+	void Rehash(size_t new_cap) {
+		K* old_keys = keys;
+		V* old_values = values;
+		unsigned char* old_used = used;
+		size_t old_cap = cap;
+
+		keys = new K[new_cap];
+		values = new V[new_cap];
+		used = new unsigned char[new_cap];
+		for (size_t i = 0; i < new_cap; ++i)
+			used[i] = 0;
+		cap = new_cap;
+
+		// reinsert the old values
+		for (size_t i = 0; i < old_cap; ++i) {
+			if (!old_used[i]) continue;
+			size_t s = Slot(old_keys[i]);
+			keys[s] = old_keys[i];
+			values[s] = std::move(old_values[i]);
+			used[s] = 1;
+		}
+
+		if (old_keys) delete[] old_keys;
+		if (old_values) delete[] old_values;
+		if (old_used) delete[] old_used;
+	}
+
+public:
+
+	/// default constructor
+	HashMap() : keys(nullptr), values(nullptr), used(nullptr), sz(0), cap(0) { }
+
+	HashMap(const HashMap&) = delete;
+	HashMap& operator=(const HashMap&) = delete;
+
+	/// destructor
+	~HashMap() {
+		if (keys) delete[] keys;
+		if (values) delete[] values;
+		if (used) delete[] used;
+		keys = nullptr;
+		values = nullptr;
+		used = nullptr;
+		sz = 0;
+		cap = 0;
+	}
+
+
+	/// functions
+
+	size_t size() const {
+		return sz;
+	}
+
+	bool empty() const {
+		return sz == 0;
+	}
+
+	// makes sure the map can hold count values without growing
+	void reserve(size_t count) {
+		// keep the table at most half full
+		size_t new_cap = 16;
+		while (new_cap < count * 2)
+			new_cap *= 2;
+		if (new_cap > cap) Rehash(new_cap);
+	}
+
+	// removes all values but keeps the memory
+	void clear() {
+		for (size_t i = 0; i < cap; ++i)
+			used[i] = 0;
+		sz = 0;
+	}
+
+	// returns a pointer to the value, nullptr if the key is not in the map
+	V* find(const K& key) {
+		if (sz == 0) return nullptr;
+		size_t s = Slot(key);
+		return used[s] ? &values[s] : nullptr;
+	}
+
+	const V* find(const K& key) const {
+		if (sz == 0) return nullptr;
+		size_t s = Slot(key);
+		return used[s] ? &values[s] : nullptr;
+	}
+
+	bool contains(const K& key) const {
+		return find(key) != nullptr;
+	}
+
+	// inserts or overwrites the value for key
+	// returns true if the key was not already in the map
+	bool insert(const K& key, const V& value) {
+		if ((sz + 1) * 2 > cap) reserve(sz + 1);
+
+		size_t s = Slot(key);
+		bool added = !used[s];
+		keys[s] = key;
+		values[s] = value;
+		used[s] = 1;
+		if (added) ++sz;
+		return added;
+	}
+
+	// returns the value for key, inserting a default value if it is not in the map
+	V& operator[](const K& key) {
+		if ((sz + 1) * 2 > cap) reserve(sz + 1);
+
+		size_t s = Slot(key);
+		if (!used[s]) {
+			keys[s] = key;
+			values[s] = V();
+			used[s] = 1;
+			++sz;
+		}
+		return values[s];
+	}
+
+	// removes the key from the map
+	// returns true if the key was in the map
+	bool erase(const K& key) {
+		if (sz == 0) return false;
+		size_t mask = cap - 1;
+		size_t i = Slot(key);
+		if (!used[i]) return false;
+
+		// shift the following values back so no probe chain is broken
+		size_t j = i;
+		while (true) {
+			j = (j + 1) & mask;
+			if (!used[j]) break;
+
+			// only move the value if its home slot is not between i and j
+			size_t home = Hash(keys[j]) & mask;
+			if (i <= j ? (i < home && home <= j) : (i < home || home <= j)) continue;
+
+			keys[i] = keys[j];
+			values[i] = std::move(values[j]);
+			i = j;
+		}
+		used[i] = 0;
+		--sz;
+		return true;
+	}
+};
+
+#pragma warning(pop)
+#endif // !CONTAINERS_HASHMAP_HPP
\ No newline at end of file
@@ -0,0 +1,7 @@
+#ifndef JOBS_HPP
+#define JOBS_HPP
+
+// includes all the job headers
+#include "Jobs/JobSystem.hpp"
+
+#endif // !JOBS_HPP
\ No newline at end of file
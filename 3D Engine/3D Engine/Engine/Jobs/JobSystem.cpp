@@ -0,0 +1,154 @@
+#include "JobSystem.hpp"
+
+namespace Jobs {
+
+	// the queue index of the worker running on this thread, 0 for threads that are not workers
+	static thread_local unsigned int threadQueue = 0;
+	static thread_local const JobSystem* threadSystem = nullptr;
+
+	JobSystem::JobSystem(unsigned int threadCount) : queues(nullptr), queueCount(0), quit(false), queued(0) {
+		if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+		if (threadCount == 0) threadCount = 1;
+
+		queueCount = threadCount;
+		queues = new Queue[queueCount];
+		for (unsigned int i = 0; i < queueCount; ++i)
+			queues[i].ring.resize(64);
+
+		// queue 0 belongs to the callers, each worker gets its own
+		workers.resize(threadCount - 1);
+		for (unsigned int i = 0; i < threadCount - 1; ++i)
+			workers[i] = std::thread(&JobSystem::WorkerLoop, this, i + 1);
+	}
+
+	JobSystem::~JobSystem() {
+		{
+			std::lock_guard<std::mutex> guard(sleepLock);
+			quit = true;
+		}
+		sleepSignal.notify_all();
+		for (std::thread& worker : workers)
+			worker.join();
+		workers.clear();
+
+		delete[] queues;
+		queues = nullptr;
+	}
+
+	JobSystem& JobSystem::Default() {
+		static JobSystem system;
+		return system;
+	}
+
+	unsigned int JobSystem::QueueIndex() const {
+		return threadSystem == this ? threadQueue : 0;
+	}
+
+	void JobSystem::Run(void(*func)(void*, size_t, size_t), void* data, size_t begin, size_t end, std::atomic<unsigned int>& counter) {
+		Job job;
+		job.func = func;
+		job.data = data;
+		job.begin = begin;
+		job.end = end;
+		job.counter = &counter;
+
+		// without workers the job just runs here
+		if (workers.empty()) {
+			Execute(job);
+			return;
+		}
+		Push(job);
+	}
+
+	void JobSystem::Push(const Job& job) {
+		Queue& q = queues[QueueIndex()];
+		{
+			std::lock_guard<std::mutex> guard(q.lock);
+
+			// grow the ring, unwrapping it into the new block
+			if (q.count == q.ring.size()) {
+				DArray<Job> ring(q.ring.size() * 2);
+				ring.resize(q.ring.size() * 2);
+				for (size_t i = 0; i < q.count; ++i)
+					ring[i] = q.ring[(q.head + i) % q.ring.size()];
+				q.ring = std::move(ring);
+				q.head = 0;
+			}
+
+			q.ring[(q.head + q.count) % q.ring.size()] = job;
+			++q.count;
+			++queued;
+		}
+
+		// take the sleep lock so a worker cant miss the signal between checking and waiting
+		{
+			std::lock_guard<std::mutex> guard(sleepLock);
+		}
+		sleepSignal.notify_one();
+	}
+
+	bool JobSystem::PopBack(const unsigned int& queue, Job& job) {
+		Queue& q = queues[queue];
+		std::lock_guard<std::mutex> guard(q.lock);
+		if (q.count == 0) return false;
+
+		--q.count;
+		job = q.ring[(q.head + q.count) % q.ring.size()];
+		--queued;
+		return true;
+	}
+
+	bool JobSystem::StealFront(const unsigned int& queue, Job& job) {
+		Queue& q = queues[queue];
+		std::lock_guard<std::mutex> guard(q.lock);
+		if (q.count == 0) return false;
+
+		job = q.ring[q.head];
+		q.head = (q.head + 1) % q.ring.size();
+		--q.count;
+		--queued;
+		return true;
+	}
+
+	bool JobSystem::TryGetJob(Job& job) {
+		unsigned int own = QueueIndex();
+		if (PopBack(own, job)) return true;
+
+		// steal starting from the next queue so thieves spread out
+		for (unsigned int i = 1; i < queueCount; ++i)
+			if (StealFront((own + i) % queueCount, job)) return true;
+		return false;
+	}
+
+	void JobSystem::Execute(const Job& job) {
+		job.func(job.data, job.begin, job.end);
+		job.counter->fetch_sub(1, std::memory_order_release);
+	}
+
+	void JobSystem::Wait(std::atomic<unsigned int>& counter) {
+		Job job;
+		while (counter.load(std::memory_order_acquire) != 0) {
+			if (TryGetJob(job)) Execute(job);
+			else std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::WorkerLoop(const unsigned int& queue) {
+		threadQueue = queue;
+		threadSystem = this;
+
+		Job job;
+		while (true) {
+			if (TryGetJob(job)) {
+				Execute(job);
+				continue;
+			}
+
+			// sleep until a job is pushed
+			std::unique_lock<std::mutex> guard(sleepLock);
+			sleepSignal.wait(guard, [this]() { return quit || queued.load() != 0; });
+			if (quit) return;
+		}
+	}
+
+}
\ No newline at end of file
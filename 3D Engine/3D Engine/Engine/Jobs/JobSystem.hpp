@@ -0,0 +1,117 @@
+#ifndef JOBS_JOB_SYSTEM_HPP
+#define JOBS_JOB_SYSTEM_HPP
+#include "../Containers/DArray.hpp"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace Jobs {
+
+	// runs func over [begin, end) of a range
+	// counter is lowered by one when the job is done
+	struct Job {
+		void(*func)(void* data, size_t begin, size_t end);
+		void* data;
+		size_t begin;
+		size_t end;
+		std::atomic<unsigned int>* counter;
+	};
+
+	// a pool of worker threads that each have their own queue of jobs
+	// a thread takes new jobs from the back of its own queue and steals old jobs from the front of the others
+	// threads waiting on jobs run other jobs instead of blocking so jobs can start more jobs
+	class JobSystem {
+
+		// a double ended queue stored in a ring, guarded by a lock
+		struct Queue {
+			std::mutex lock;
+			DArray<Job> ring;
+			size_t head;
+			size_t count;
+
+			Queue() : head(0), count(0) { }
+		};
+
+		// queue 0 is shared by every thread that is not a worker
+		Queue* queues;
+		unsigned int queueCount;
+		DArray<std::thread> workers;
+
+		// idle workers sleep until there are jobs
+		std::atomic<bool> quit;
+		std::atomic<unsigned int> queued;
+		std::mutex sleepLock;
+		std::condition_variable sleepSignal;
+
+		// the queue of the calling thread
+		unsigned int QueueIndex() const;
+
+		void Push(const Job& job);
+		bool PopBack(const unsigned int& queue, Job& job);
+		bool StealFront(const unsigned int& queue, Job& job);
+
+		// takes a job from this threads queue or steals one
+		bool TryGetJob(Job& job);
+		static void Execute(const Job& job);
+
+		void WorkerLoop(const unsigned int& queue);
+
+		template<typename F>
+		static void RunRange(void* data, size_t begin, size_t end) {
+			(*static_cast<const F*>(data))(begin, end);
+		}
+
+	public:
+
+		// starts threadCount - 1 workers, the calling thread is the last one
+		// a threadCount of 0 uses every hardware thread
+		explicit JobSystem(unsigned int threadCount = 0);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		/// functions
+
+		// the number of threads that run jobs, including the one waiting on them
+		unsigned int GetThreadCount() const { return static_cast<unsigned int>(workers.size()) + 1; }
+
+		// queues a job, the counter must have been raised by one for it
+		void Run(void(*func)(void*, size_t, size_t), void* data, size_t begin, size_t end, std::atomic<unsigned int>& counter);
+
+		// runs jobs until the counter is zero
+		void Wait(std::atomic<unsigned int>& counter);
+
+		// calls func(begin, end) on chunks of [0, count) spread over the threads and waits for them
+		// chunks are never smaller than grain
+		template<typename F>
+		void ParallelFor(const size_t& count, size_t grain, const F& func) {
+			if (count == 0) return;
+			if (grain == 0) grain = 1;
+
+			// a few chunks per thread so stealing can even out uneven work
+			size_t chunks = GetThreadCount() * 4;
+			if (count / grain < chunks) chunks = count / grain;
+			if (chunks <= 1) {
+				func(static_cast<size_t>(0), count);
+				return;
+			}
+
+			std::atomic<unsigned int> counter(static_cast<unsigned int>(chunks - 1));
+			for (size_t c = 1; c < chunks; ++c)
+				Run(RunRange<F>, const_cast<F*>(&func), count * c / chunks, count * (c + 1) / chunks, counter);
+
+			// run the first chunk here then help with the rest
+			func(static_cast<size_t>(0), count / chunks);
+			Wait(counter);
+		}
+
+		// the job system shared by the engine, sized to the hardware
+		static JobSystem& Default();
+
+	};
+
+}
+
+#endif // !JOBS_JOB_SYSTEM_HPP
\ No newline at end of file
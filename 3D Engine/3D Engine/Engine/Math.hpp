@@ -6,6 +6,11 @@
 #include "Math/Vector.hpp"
 #include "Math/Matrix.hpp"
 #include "Math/Quaternion.hpp"
+#include "Math/Transform.hpp"
 #include "Math/Bounds.hpp"
+#include "Math/SIMD.hpp"
+#include "Math/BatchTransform.hpp"
+#include "Math/Fast.hpp"
+#include "Math/BoundsBatch.hpp"
 
 #endif // !MATH_HPP
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include "BatchTransform.hpp"
+#include "SIMD.hpp"
+#include "../Jobs/JobSystem.hpp"
+
+namespace Math {
+
+	// the top three rows of a matrix, every vector transform here comes down to one
+	struct Affine {
+		float m[12];
+		// normalize the results, for normals
+		bool normalize;
+	};
+
+	static Affine MakeAffine(const Matrix4& matrix, const bool& translate) {
+		Affine a;
+		for (int i = 0; i < 12; ++i)
+			a.m[i] = matrix.m[i];
+		if (!translate) a.m[3] = a.m[7] = a.m[11] = 0.0f;
+		a.normalize = false;
+		return a;
+	}
+
+	static Affine MakeAffine(const Matrix3& matrix) {
+		Affine a;
+		for (int r = 0; r < 3; ++r) {
+			a.m[r * 4] = matrix.m[r * 3];
+			a.m[r * 4 + 1] = matrix.m[r * 3 + 1];
+			a.m[r * 4 + 2] = matrix.m[r * 3 + 2];
+			a.m[r * 4 + 3] = 0.0f;
+		}
+		a.normalize = false;
+		return a;
+	}
+
+	// the inverse transpose of the rotation and scale part
+	static Affine MakeNormalAffine(const Matrix4& matrix) {
+		const float* m = matrix.m;
+		Matrix3 upper(m[0], m[1], m[2], m[4], m[5], m[6], m[8], m[9], m[10]);
+		Affine a = MakeAffine(upper.Inverse().Transpose());
+		a.normalize = true;
+		return a;
+	}
+
+	// runs func(begin, end) over the array, split over the job system when it is long
+	template<typename F>
+	static void Run(const size_t& count, Jobs::JobSystem* jobs, const F& func) {
+		if (count < BatchParallelCount) {
+			func(static_cast<size_t>(0), count);
+			return;
+		}
+		if (!jobs) jobs = &Jobs::JobSystem::Default();
+		jobs->ParallelFor(count, BatchParallelCount / 4, func);
+	}
+
+	/// scalar kernels
+
+	static void AffineScalar(const Affine& a, float& x, float& y, float& z) {
+		const float* m = a.m;
+		Vector3 r(m[0] * x + m[1] * y + m[2] * z + m[3],
+				  m[4] * x + m[5] * y + m[6] * z + m[7],
+				  m[8] * x + m[9] * y + m[10] * z + m[11]);
+		if (a.normalize) r = Vector3::Normalize(r);
+		x = r.x; y = r.y; z = r.z;
+	}
+
+	static void AffineKernelScalar(const Affine& a, const Vector3* in, Vector3* out, const size_t& begin, const size_t& end) {
+		for (size_t i = begin; i < end; ++i) {
+			float x = in[i].x, y = in[i].y, z = in[i].z;
+			AffineScalar(a, x, y, z);
+			out[i] = Vector3(x, y, z);
+		}
+	}
+
+	static void AffineKernelScalar(const Affine& a, const float* x, const float* y, const float* z,
+								   float* outX, float* outY, float* outZ, const size_t& begin, const size_t& end) {
+		for (size_t i = begin; i < end; ++i) {
+			float px = x[i], py = y[i], pz = z[i];
+			AffineScalar(a, px, py, pz);
+			outX[i] = px; outY[i] = py; outZ[i] = pz;
+		}
+	}
+
+	static void Vector4KernelScalar(const Matrix4& matrix, const Vector4* in, Vector4* out, const size_t& begin, const size_t& end) {
+		for (size_t i = begin; i < end; ++i)
+			out[i] = matrix * in[i];
+	}
+
+	/// avx2 kernels
+
+	// the rows of an affine splatted across the lanes
+	struct AffineLanes {
+		__m256 m[12];
+	};
+
+	MATH_TARGET_AVX2
+	static void SplatAffine(const Affine& a, AffineLanes& lanes) {
+		for (int i = 0; i < 12; ++i)
+			lanes.m[i] = _mm256_set1_ps(a.m[i]);
+	}
+
+	// transforms 8 vectors stored one axis per register
+	MATH_TARGET_AVX2
+	static void AffineAVX2(const AffineLanes& l, const bool& normalize, __m256& x, __m256& y, __m256& z) {
+		__m256 rx = _mm256_fmadd_ps(l.m[2], z, _mm256_fmadd_ps(l.m[1], y, _mm256_fmadd_ps(l.m[0], x, l.m[3])));
+		__m256 ry = _mm256_fmadd_ps(l.m[6], z, _mm256_fmadd_ps(l.m[5], y, _mm256_fmadd_ps(l.m[4], x, l.m[7])));
+		__m256 rz = _mm256_fmadd_ps(l.m[10], z, _mm256_fmadd_ps(l.m[9], y, _mm256_fmadd_ps(l.m[8], x, l.m[11])));
+
+		if (normalize) {
+			// vectors too short to normalize become zero like Vector3::Normalize
+			__m256 length = _mm256_sqrt_ps(_mm256_fmadd_ps(rz, rz, _mm256_fmadd_ps(ry, ry, _mm256_mul_ps(rx, rx))));
+			__m256 valid = _mm256_cmp_ps(length, _mm256_set1_ps(REALLY_SMALL), _CMP_GE_OQ);
+			rx = _mm256_and_ps(valid, _mm256_div_ps(rx, length));
+			ry = _mm256_and_ps(valid, _mm256_div_ps(ry, length));
+			rz = _mm256_and_ps(valid, _mm256_div_ps(rz, length));
+		}
+
+		x = rx; y = ry; z = rz;
+	}
+
+	MATH_TARGET_AVX2
+	static void AffineKernelAVX2(const Affine& a, const Vector3* in, Vector3* out, const size_t& begin, const size_t& end) {
+		AffineLanes lanes;
+		SplatAffine(a, lanes);
+
+		size_t i = begin;
+		for (; i + 8 <= end; i += 8) {
+			// everything is loaded before storing so in and out can be the same
+			__m256 x, y, z;
+			SIMD::LoadVector3x8(&in[i].x, x, y, z);
+			AffineAVX2(lanes, a.normalize, x, y, z);
+			SIMD::StoreVector3x8(&out[i].x, x, y, z);
+		}
+		AffineKernelScalar(a, in, out, i, end);
+	}
+
+	MATH_TARGET_AVX2
+	static void AffineKernelAVX2(const Affine& a, const float* x, const float* y, const float* z,
+								 float* outX, float* outY, float* outZ, const size_t& begin, const size_t& end) {
+		AffineLanes lanes;
+		SplatAffine(a, lanes);
+
+		size_t i = begin;
+		for (; i + 8 <= end; i += 8) {
+			__m256 px = _mm256_loadu_ps(x + i);
+			__m256 py = _mm256_loadu_ps(y + i);
+			__m256 pz = _mm256_loadu_ps(z + i);
+			AffineAVX2(lanes, a.normalize, px, py, pz);
+			_mm256_storeu_ps(outX + i, px);
+			_mm256_storeu_ps(outY + i, py);
+			_mm256_storeu_ps(outZ + i, pz);
+		}
+		AffineKernelScalar(a, x, y, z, outX, outY, outZ, i, end);
+	}
+
+	MATH_TARGET_AVX2
+	static void Vector4KernelAVX2(const Matrix4& matrix, const Vector4* in, Vector4* out, const size_t& begin, const size_t& end) {
+		// the columns of the matrix in both halves, so each half transforms one vector
+		const float* m = matrix.m;
+		__m256 c0 = _mm256_setr_ps(m[0], m[4], m[8], m[12], m[0], m[4], m[8], m[12]);
+		__m256 c1 = _mm256_setr_ps(m[1], m[5], m[9], m[13], m[1], m[5], m[9], m[13]);
+		__m256 c2 = _mm256_setr_ps(m[2], m[6], m[10], m[14], m[2], m[6], m[10], m[14]);
+		__m256 c3 = _mm256_setr_ps(m[3], m[7], m[11], m[15], m[3], m[7], m[11], m[15]);
+
+		size_t i = begin;
+		for (; i + 2 <= end; i += 2) {
+			__m256 v = _mm256_loadu_ps(&in[i].x);
+			__m256 r = _mm256_mul_ps(_mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)), c0);
+			r = _mm256_fmadd_ps(_mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), c1, r);
+			r = _mm256_fmadd_ps(_mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), c2, r);
+			r = _mm256_fmadd_ps(_mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)), c3, r);
+			_mm256_storeu_ps(&out[i].x, r);
+		}
+		Vector4KernelScalar(matrix, in, out, i, end);
+	}
+
+	/// dispatch
+
+	static void TransformAffine(const Affine& a, const Vector3* in, Vector3* out, const size_t& count, Jobs::JobSystem* jobs) {
+		const bool avx2 = SIMD::HasAVX2();
+		Run(count, jobs, [&a, in, out, avx2](size_t begin, size_t end) {
+			if (avx2) AffineKernelAVX2(a, in, out, begin, end);
+			else AffineKernelScalar(a, in, out, begin, end);
+		});
+	}
+
+	static void TransformAffine(const Affine& a, const float* x, const float* y, const float* z,
+								float* outX, float* outY, float* outZ, const size_t& count, Jobs::JobSystem* jobs) {
+		const bool avx2 = SIMD::HasAVX2();
+		Run(count, jobs, [&a, x, y, z, outX, outY, outZ, avx2](size_t begin, size_t end) {
+			if (avx2) AffineKernelAVX2(a, x, y, z, outX, outY, outZ, begin, end);
+			else AffineKernelScalar(a, x, y, z, outX, outY, outZ, begin, end);
+		});
+	}
+
+	void TransformPoints(const Matrix4& matrix, const Vector3* in, Vector3* out, const size_t& count, Jobs::JobSystem* jobs) {
+		TransformAffine(MakeAffine(matrix, true), in, out, count, jobs);
+	}
+
+	void TransformDirections(const Matrix4& matrix, const Vector3* in, Vector3* out, const size_t& count, Jobs::JobSystem* jobs) {
+		TransformAffine(MakeAffine(matrix, false), in, out, count, jobs);
+	}
+
+	void TransformNormals(const Matrix4& matrix, const Vector3* in, Vector3* out, const size_t& count, Jobs::JobSystem* jobs) {
+		TransformAffine(MakeNormalAffine(matrix), in, out, count, jobs);
+	}
+
+	void TransformVectors(const Matrix3& matrix, const Vector3* in, Vector3* out, const size_t& count, Jobs::JobSystem* jobs) {
+		TransformAffine(MakeAffine(matrix), in, out, count, jobs);
+	}
+
+	void TransformVectors(const Matrix4& matrix, const Vector4* in, Vector4* out, const size_t& count, Jobs::JobSystem* jobs) {
+		const bool avx2 = SIMD::HasAVX2();
+		const Matrix4* m = &matrix;
+		Run(count, jobs, [m, in, out, avx2](size_t begin, size_t end) {
+			if (avx2) Vector4KernelAVX2(*m, in, out, begin, end);
+			else Vector4KernelScalar(*m, in, out, begin, end);
+		});
+	}
+
+	void TransformPoints(const Matrix4& matrix, const float* x, const float* y, const float* z,
+						 float* outX, float* outY, float* outZ, const size_t& count, Jobs::JobSystem* jobs) {
+		TransformAffine(MakeAffine(matrix, true), x, y, z, outX, outY, outZ, count, jobs);
+	}
+
+	void TransformDirections(const Matrix4& matrix, const float* x, const float* y, const float* z,
+							 float* outX, float* outY, float* outZ, const size_t& count, Jobs::JobSystem* jobs) {
+		TransformAffine(MakeAffine(matrix, false), x, y, z, outX, outY, outZ, count, jobs);
+	}
+
+	void TransformNormals(const Matrix4& matrix, const float* x, const float* y, const float* z,
+						  float* outX, float* outY, float* outZ, const size_t& count, Jobs::JobSystem* jobs) {
+		TransformAffine(MakeNormalAffine(matrix), x, y, z, outX, outY, outZ, count, jobs);
+	}
+
+}
\ No newline at end of file
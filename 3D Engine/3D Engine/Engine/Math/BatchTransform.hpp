@@ -0,0 +1,45 @@
+#ifndef MATH_BATCH_TRANSFORM_HPP
+#define MATH_BATCH_TRANSFORM_HPP
+#include "Vector.hpp"
+#include "Matrix.hpp"
+#include <cstddef>
+
+namespace Jobs {
+	class JobSystem;
+}
+
+namespace Math {
+
+	/// transforms whole arrays of vectors through one matrix
+	/// 8 at a time with avx2 when the cpu has it, one at a time otherwise
+	/// arrays longer than BatchParallelCount are split over the job system, nullptr uses Jobs::JobSystem::Default()
+	/// out can be the same array as in
+
+	// arrays shorter than this run on the calling thread
+	static const size_t BatchParallelCount = 32768;
+
+	/// arrays of vectors
+
+	// out[i] = matrix * in[i] as a point, the same as Matrix4 * Vector3
+	void TransformPoints(const Matrix4& matrix, const Vector3* in, Vector3* out, const size_t& count, Jobs::JobSystem* jobs = nullptr);
+	// like TransformPoints without the translation
+	void TransformDirections(const Matrix4& matrix, const Vector3* in, Vector3* out, const size_t& count, Jobs::JobSystem* jobs = nullptr);
+	// transforms by the inverse transpose so normals stay at right angles to scaled surfaces, the results are normalized
+	void TransformNormals(const Matrix4& matrix, const Vector3* in, Vector3* out, const size_t& count, Jobs::JobSystem* jobs = nullptr);
+	// out[i] = matrix * in[i]
+	void TransformVectors(const Matrix3& matrix, const Vector3* in, Vector3* out, const size_t& count, Jobs::JobSystem* jobs = nullptr);
+	// out[i] = matrix * in[i] with w
+	void TransformVectors(const Matrix4& matrix, const Vector4* in, Vector4* out, const size_t& count, Jobs::JobSystem* jobs = nullptr);
+
+	/// arrays of each axis
+
+	void TransformPoints(const Matrix4& matrix, const float* x, const float* y, const float* z,
+						 float* outX, float* outY, float* outZ, const size_t& count, Jobs::JobSystem* jobs = nullptr);
+	void TransformDirections(const Matrix4& matrix, const float* x, const float* y, const float* z,
+							 float* outX, float* outY, float* outZ, const size_t& count, Jobs::JobSystem* jobs = nullptr);
+	void TransformNormals(const Matrix4& matrix, const float* x, const float* y, const float* z,
+						  float* outX, float* outY, float* outZ, const size_t& count, Jobs::JobSystem* jobs = nullptr);
+
+}
+
+#endif // !MATH_BATCH_TRANSFORM_HPP
\ No newline at end of file
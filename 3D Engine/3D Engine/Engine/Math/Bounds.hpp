@@ -60,6 +60,61 @@ namespace Math {
 			return true;
 		}
 
+		static bool Contains(const Bounds3D& outer, const Bounds3D& inner) {
+			// checks if inner min < outer min and inner max > outer max
+			if (inner.min.x < outer.min.x || inner.max.x > outer.max.x) return false;
+			if (inner.min.y < outer.min.y || inner.max.y > outer.max.y) return false;
+			if (inner.min.z < outer.min.z || inner.max.z > outer.max.z) return false;
+
+			// if none of the prev returned then return true
+			return true;
+		}
+
+		static Bounds3D Combine(const Bounds3D& b0, const Bounds3D& b1) {
+			return Bounds3D(
+				Vector3(fminf(b0.min.x, b1.min.x), fminf(b0.min.y, b1.min.y), fminf(b0.min.z, b1.min.z)),
+				Vector3(fmaxf(b0.max.x, b1.max.x), fmaxf(b0.max.y, b1.max.y), fmaxf(b0.max.z, b1.max.z))
+			);
+		}
+
+		static Bounds3D Expand(const Bounds3D& b, const float& amount) {
+			Vector3 a(amount);
+			return Bounds3D(b.min - a, b.max + a);
+		}
+
+		// checks if the segment from origin along a direction for length passes through b
+		// inverseDirection is 1 / direction on each axis, distance is where it enters b or 0 if origin is inside
+		static bool Raycast(const Bounds3D& b, const Vector3& origin, const Vector3& inverseDirection, const float& length, float& distance) {
+			float enter = 0.0f, exit = length;
+			for (int axis = 0; axis < 3; ++axis) {
+				// the distances to the two planes of this axis
+				float t0 = (b.min[axis] - origin[axis]) * inverseDirection[axis];
+				float t1 = (b.max[axis] - origin[axis]) * inverseDirection[axis];
+				if (t0 > t1) { float t = t0; t0 = t1; t1 = t; }
+
+				enter = fmaxf(enter, t0);
+				exit = fminf(exit, t1);
+				if (enter > exit) return false;
+			}
+			distance = enter;
+			return true;
+		}
+
+		/// member functions
+
+		Vector3 Center() const {
+			return (min + max) * 0.5f;
+		}
+
+		Vector3 Size() const {
+			return max - min;
+		}
+
+		float SurfaceArea() const {
+			Vector3 s = max - min;
+			return 2.0f * (s.x * s.y + s.y * s.z + s.z * s.x);
+		}
+
 	};
 
 }
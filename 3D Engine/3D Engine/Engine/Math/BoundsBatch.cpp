@@ -0,0 +1,161 @@
+#include "BoundsBatch.hpp"
+#include "SIMD.hpp"
+
+namespace Math {
+
+	// the index of the lowest set bit, bits can't be 0
+	static unsigned int LowestBit(const unsigned int& bits) {
+		#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, bits);
+		return static_cast<unsigned int>(index);
+		#else
+		return static_cast<unsigned int>(__builtin_ctz(bits));
+		#endif
+	}
+
+	/// scalar kernels
+
+	// 1 when box i overlaps bounds, the compares are anded together instead of returning early
+	static unsigned int OverlapScalar(const Bounds3D& b, const PackedBounds3D& boxes, const size_t& i) {
+		return static_cast<unsigned int>(
+			(boxes.MaxX()[i] >= b.min.x) & (boxes.MinX()[i] <= b.max.x) &
+			(boxes.MaxY()[i] >= b.min.y) & (boxes.MinY()[i] <= b.max.y) &
+			(boxes.MaxZ()[i] >= b.min.z) & (boxes.MinZ()[i] <= b.max.z));
+	}
+
+	static void MaskKernelScalar(const Bounds3D& bounds, const PackedBounds3D& boxes, unsigned int* mask) {
+		const size_t count = boxes.size();
+		for (size_t w = 0; w < (count + 31) / 32; ++w)
+			mask[w] = 0;
+		for (size_t i = 0; i < count; ++i)
+			mask[i / 32] |= OverlapScalar(bounds, boxes, i) << (i % 32);
+	}
+
+	static void IndexKernelScalar(const Bounds3D& bounds, const PackedBounds3D& boxes, const size_t& begin, const size_t& end, DArray<unsigned int>& results) {
+		for (size_t i = begin; i < end; ++i)
+			if (OverlapScalar(bounds, boxes, i)) results.push_back(static_cast<unsigned int>(i));
+	}
+
+	/// avx2 kernels
+
+	// a box splatted across the lanes
+	struct BoundsLanes {
+		__m256 minX, minY, minZ;
+		__m256 maxX, maxY, maxZ;
+	};
+
+	MATH_TARGET_AVX2
+	static void SplatBounds(const Bounds3D& b, BoundsLanes& lanes) {
+		lanes.minX = _mm256_set1_ps(b.min.x); lanes.minY = _mm256_set1_ps(b.min.y); lanes.minZ = _mm256_set1_ps(b.min.z);
+		lanes.maxX = _mm256_set1_ps(b.max.x); lanes.maxY = _mm256_set1_ps(b.max.y); lanes.maxZ = _mm256_set1_ps(b.max.z);
+	}
+
+	// bit k is set when box i + k overlaps
+	MATH_TARGET_AVX2
+	static unsigned int OverlapAVX2(const BoundsLanes& l, const PackedBounds3D& boxes, const size_t& i) {
+		__m256 x = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(boxes.MaxX() + i), l.minX, _CMP_GE_OQ),
+								 _mm256_cmp_ps(_mm256_loadu_ps(boxes.MinX() + i), l.maxX, _CMP_LE_OQ));
+		__m256 y = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(boxes.MaxY() + i), l.minY, _CMP_GE_OQ),
+								 _mm256_cmp_ps(_mm256_loadu_ps(boxes.MinY() + i), l.maxY, _CMP_LE_OQ));
+		__m256 z = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(boxes.MaxZ() + i), l.minZ, _CMP_GE_OQ),
+								 _mm256_cmp_ps(_mm256_loadu_ps(boxes.MinZ() + i), l.maxZ, _CMP_LE_OQ));
+		return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_and_ps(x, _mm256_and_ps(y, z))));
+	}
+
+	MATH_TARGET_AVX2
+	static void MaskKernelAVX2(const Bounds3D& bounds, const PackedBounds3D& boxes, unsigned int* mask) {
+		BoundsLanes lanes;
+		SplatBounds(bounds, lanes);
+
+		// four groups of 8 fill a word
+		const size_t count = boxes.size();
+		size_t i = 0;
+		for (; i + 32 <= count; i += 32) {
+			mask[i / 32] = OverlapAVX2(lanes, boxes, i)
+				| (OverlapAVX2(lanes, boxes, i + 8) << 8)
+				| (OverlapAVX2(lanes, boxes, i + 16) << 16)
+				| (OverlapAVX2(lanes, boxes, i + 24) << 24);
+		}
+		if (i == count) return;
+
+		mask[i / 32] = 0;
+		for (; i + 8 <= count; i += 8)
+			mask[i / 32] |= OverlapAVX2(lanes, boxes, i) << (i % 32);
+		for (; i < count; ++i)
+			mask[i / 32] |= OverlapScalar(bounds, boxes, i) << (i % 32);
+	}
+
+	MATH_TARGET_AVX2
+	static void IndexKernelAVX2(const Bounds3D& bounds, const PackedBounds3D& boxes, const size_t& begin, const size_t& end, DArray<unsigned int>& results) {
+		BoundsLanes lanes;
+		SplatBounds(bounds, lanes);
+
+		size_t i = begin;
+		for (; i + 8 <= end; i += 8) {
+			// only loops over the hits, most groups have none
+			unsigned int bits = OverlapAVX2(lanes, boxes, i);
+			while (bits) {
+				results.push_back(static_cast<unsigned int>(i) + LowestBit(bits));
+				bits &= bits - 1;
+			}
+		}
+		IndexKernelScalar(bounds, boxes, i, end, results);
+	}
+
+	/// dispatch
+
+	static void OverlapRange(const bool& avx2, const Bounds3D& bounds, const PackedBounds3D& boxes, const size_t& begin, const size_t& end, DArray<unsigned int>& results) {
+		if (avx2) IndexKernelAVX2(bounds, boxes, begin, end, results);
+		else IndexKernelScalar(bounds, boxes, begin, end, results);
+	}
+
+	void OverlapMask(const Bounds3D& bounds, const PackedBounds3D& boxes, unsigned int* mask) {
+		if (SIMD::HasAVX2()) MaskKernelAVX2(bounds, boxes, mask);
+		else MaskKernelScalar(bounds, boxes, mask);
+	}
+
+	void Overlap(const Bounds3D& bounds, const PackedBounds3D& boxes, DArray<unsigned int>& results) {
+		OverlapRange(SIMD::HasAVX2(), bounds, boxes, 0, boxes.size(), results);
+	}
+
+	void Overlap(const Bounds3D& bounds, const PackedBounds3D& boxes, const size_t& begin, const size_t& end, DArray<unsigned int>& results) {
+		OverlapRange(SIMD::HasAVX2(), bounds, boxes, begin, end, results);
+	}
+
+	void OverlapPairs(const PackedBounds3D& a, const PackedBounds3D& b, DArray<IndexPair>& pairs) {
+		const bool avx2 = SIMD::HasAVX2();
+		const size_t countA = a.size(), countB = b.size();
+		DArray<unsigned int> hits;
+
+		// a tile of b stays in the cache while every box of a is tested against it
+		for (size_t tile = 0; tile < countB; tile += OverlapTileSize) {
+			size_t tileEnd = tile + OverlapTileSize < countB ? tile + OverlapTileSize : countB;
+			for (size_t i = 0; i < countA; ++i) {
+				hits.clear();
+				OverlapRange(avx2, a.Get(i), b, tile, tileEnd, hits);
+				for (size_t h = 0; h < hits.size(); ++h)
+					pairs.push_back(IndexPair(static_cast<unsigned int>(i), hits[h]));
+			}
+		}
+	}
+
+	void OverlapPairs(const PackedBounds3D& boxes, DArray<IndexPair>& pairs) {
+		const bool avx2 = SIMD::HasAVX2();
+		const size_t count = boxes.size();
+		DArray<unsigned int> hits;
+
+		// the same tiles as above, each box is only tested against the boxes after it
+		for (size_t tile = 0; tile < count; tile += OverlapTileSize) {
+			size_t tileEnd = tile + OverlapTileSize < count ? tile + OverlapTileSize : count;
+			for (size_t i = 0; i + 1 < tileEnd; ++i) {
+				size_t begin = i + 1 > tile ? i + 1 : tile;
+				hits.clear();
+				OverlapRange(avx2, boxes.Get(i), boxes, begin, tileEnd, hits);
+				for (size_t h = 0; h < hits.size(); ++h)
+					pairs.push_back(IndexPair(static_cast<unsigned int>(i), hits[h]));
+			}
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef MATH_BOUNDS_BATCH_HPP
+#define MATH_BOUNDS_BATCH_HPP
+#include "Bounds.hpp"
+#include "../Containers/DArray.hpp"
+#include <cstddef>
+
+namespace Math {
+
+	/// overlap tests of one box against many, or many against many, without any branches per box
+	/// 8 boxes at a time with avx2 when the cpu has it, one at a time otherwise
+	/// boxes that touch count as overlapping, the same as Bounds3D::Intersects
+
+	// bounds stored one component per array so the batch tests can load 8 of them at once
+	class PackedBounds3D {
+
+		DArray<float> minX, minY, minZ;
+		DArray<float> maxX, maxY, maxZ;
+
+	public:
+
+		PackedBounds3D() { }
+
+		/// functions
+
+		size_t size() const { return minX.size(); }
+		bool empty() const { return minX.empty(); }
+
+		void push_back(const Bounds3D& bounds) {
+			minX.push_back(bounds.min.x); minY.push_back(bounds.min.y); minZ.push_back(bounds.min.z);
+			maxX.push_back(bounds.max.x); maxY.push_back(bounds.max.y); maxZ.push_back(bounds.max.z);
+		}
+		void swap_remove(const size_t& index) {
+			minX.swap_remove(index); minY.swap_remove(index); minZ.swap_remove(index);
+			maxX.swap_remove(index); maxY.swap_remove(index); maxZ.swap_remove(index);
+		}
+		// new boxes are empty
+		void resize(const size_t& size_) {
+			const size_t old = size();
+			minX.resize(size_); minY.resize(size_); minZ.resize(size_);
+			maxX.resize(size_); maxY.resize(size_); maxZ.resize(size_);
+			for (size_t i = old; i < size_; ++i)
+				SetEmpty(i);
+		}
+		void clear() {
+			minX.clear(); minY.clear(); minZ.clear();
+			maxX.clear(); maxY.clear(); maxZ.clear();
+		}
+
+		/// getters
+
+		Bounds3D Get(const size_t& index) const {
+			return Bounds3D(Vector3(minX[index], minY[index], minZ[index]), Vector3(maxX[index], maxY[index], maxZ[index]));
+		}
+		const float* MinX() const { return minX.data(); }
+		const float* MinY() const { return minY.data(); }
+		const float* MinZ() const { return minZ.data(); }
+		const float* MaxX() const { return maxX.data(); }
+		const float* MaxY() const { return maxY.data(); }
+		const float* MaxZ() const { return maxZ.data(); }
+
+		/// setters
+
+		void Set(const size_t& index, const Bounds3D& bounds) {
+			minX[index] = bounds.min.x; minY[index] = bounds.min.y; minZ[index] = bounds.min.z;
+			maxX[index] = bounds.max.x; maxY[index] = bounds.max.y; maxZ[index] = bounds.max.z;
+		}
+		// an inside out box that never overlaps anything, for slots that are not in use
+		void SetEmpty(const size_t& index) {
+			minX[index] = minY[index] = minZ[index] = HUGE_VALF;
+			maxX[index] = maxY[index] = maxZ[index] = -HUGE_VALF;
+		}
+
+	};
+
+	// the indices of two overlapping boxes
+	struct IndexPair {
+		unsigned int a, b;
+
+		IndexPair() : a(0), b(0) { }
+		IndexPair(const unsigned int& a_, const unsigned int& b_) : a(a_), b(b_) { }
+	};
+
+	/// one against many
+
+	// sets bit i of mask when boxes i overlaps bounds and clears the rest
+	// mask needs (boxes.size() + 31) / 32 words
+	void OverlapMask(const Bounds3D& bounds, const PackedBounds3D& boxes, unsigned int* mask);
+	// appends the index of every box that overlaps bounds to results, in order
+	void Overlap(const Bounds3D& bounds, const PackedBounds3D& boxes, DArray<unsigned int>& results);
+	// the same for boxes [begin, end)
+	void Overlap(const Bounds3D& bounds, const PackedBounds3D& boxes, const size_t& begin, const size_t& end, DArray<unsigned int>& results);
+
+	/// many against many
+
+	// the number of boxes of b tested against all of a at a time, small enough to stay in the l1 cache
+	static const size_t OverlapTileSize = 512;
+
+	// appends every overlapping pair with a from a and b from b
+	void OverlapPairs(const PackedBounds3D& a, const PackedBounds3D& b, DArray<IndexPair>& pairs);
+	// appends every overlapping pair of boxes from the same array once, with a < b
+	void OverlapPairs(const PackedBounds3D& boxes, DArray<IndexPair>& pairs);
+
+}
+
+#endif // !MATH_BOUNDS_BATCH_HPP
\ No newline at end of file
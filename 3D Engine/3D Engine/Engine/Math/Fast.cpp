@@ -0,0 +1,228 @@
+#include "Fast.hpp"
+
+namespace Math {
+
+	namespace Fast {
+
+		/// avx2 kernels
+
+		// a polynomial splatted across the lanes
+		struct PolynomialLanes {
+			int count;
+			__m256 c[9];
+		};
+
+		MATH_TARGET_AVX2
+		static void SplatPolynomial(const Polynomial& p, PolynomialLanes& lanes) {
+			lanes.count = p.count;
+			for (int k = 0; k < p.count; ++k)
+				lanes.c[k] = _mm256_set1_ps(p.c[k]);
+		}
+
+		MATH_TARGET_AVX2
+		static __m256 HornerAVX2(const PolynomialLanes& p, const __m256& x) {
+			__m256 r = p.c[p.count - 1];
+			for (int k = p.count - 2; k >= 0; --k)
+				r = _mm256_fmadd_ps(r, x, p.c[k]);
+			return r;
+		}
+
+		// sin and cos of 8 angles, the same steps as the scalar SinCos with the branches turned into blends
+		MATH_TARGET_AVX2
+		static void SinCosAVX2(const PolynomialLanes& sinPoly, const PolynomialLanes& cosPoly, const __m256& x, __m256& outSin, __m256& outCos) {
+			__m256i k = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(M_2_PI)));
+			__m256 kf = _mm256_cvtepi32_ps(k);
+			__m256 r = _mm256_fnmadd_ps(kf, _mm256_set1_ps(HalfPiHi), x);
+			r = _mm256_fnmadd_ps(kf, _mm256_set1_ps(HalfPiMid), r);
+			r = _mm256_fnmadd_ps(kf, _mm256_set1_ps(HalfPiLo), r);
+			__m256 r2 = _mm256_mul_ps(r, r);
+
+			__m256 s = _mm256_mul_ps(r, HornerAVX2(sinPoly, r2));
+			__m256 c = HornerAVX2(cosPoly, r2);
+
+			// odd quarter turns swap sin and cos
+			__m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(k, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+			__m256 ss = _mm256_blendv_ps(s, c, swap);
+			__m256 cc = _mm256_blendv_ps(c, s, swap);
+
+			// bit 1 of k, or of k + 1 for cos, moved up to the sign bit
+			__m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(k, _mm256_set1_epi32(2)), 30));
+			__m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(k, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+			outSin = _mm256_xor_ps(ss, sinSign);
+			outCos = _mm256_xor_ps(cc, cosSign);
+		}
+
+		MATH_TARGET_AVX2
+		static void SinCosKernelAVX2(const float* in, float* outSin, float* outCos, const size_t& count, const Accuracy& accuracy) {
+			PolynomialLanes sinPoly, cosPoly;
+			SplatPolynomial(SinPolynomials[static_cast<int>(accuracy)], sinPoly);
+			SplatPolynomial(CosPolynomials[static_cast<int>(accuracy)], cosPoly);
+
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8) {
+				__m256 s, c;
+				SinCosAVX2(sinPoly, cosPoly, _mm256_loadu_ps(in + i), s, c);
+				if (outSin) _mm256_storeu_ps(outSin + i, s);
+				if (outCos) _mm256_storeu_ps(outCos + i, c);
+			}
+			for (; i < count; ++i) {
+				float s, c;
+				SinCos(in[i], s, c, accuracy);
+				if (outSin) outSin[i] = s;
+				if (outCos) outCos[i] = c;
+			}
+		}
+
+		MATH_TARGET_AVX2
+		static void Atan2KernelAVX2(const float* y, const float* x, float* out, const size_t& count, const Accuracy& accuracy) {
+			PolynomialLanes poly;
+			SplatPolynomial(AtanPolynomials[static_cast<int>(accuracy)], poly);
+			const __m256 signMask = _mm256_set1_ps(-0.0f);
+			const __m256 zero = _mm256_setzero_ps();
+			const __m256 halfPi = _mm256_set1_ps(M_PI_2);
+			const __m256 pi = _mm256_set1_ps(M_PI);
+
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8) {
+				__m256 vy = _mm256_loadu_ps(y + i);
+				__m256 vx = _mm256_loadu_ps(x + i);
+				__m256 ax = _mm256_andnot_ps(signMask, vx);
+				__m256 ay = _mm256_andnot_ps(signMask, vy);
+				__m256 hi = _mm256_max_ps(ax, ay);
+				__m256 lo = _mm256_min_ps(ax, ay);
+
+				// both 0 gives 0 instead of 0 / 0
+				__m256 t = _mm256_and_ps(_mm256_div_ps(lo, hi), _mm256_cmp_ps(hi, zero, _CMP_GT_OQ));
+				__m256 r = _mm256_mul_ps(t, HornerAVX2(poly, _mm256_mul_ps(t, t)));
+				r = _mm256_blendv_ps(r, _mm256_sub_ps(halfPi, r), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+				// blendv picks by the sign bit so -0 counts as negative like the scalar version
+				r = _mm256_blendv_ps(r, _mm256_sub_ps(pi, r), vx);
+				r = _mm256_xor_ps(r, _mm256_and_ps(vy, signMask));
+				_mm256_storeu_ps(out + i, r);
+			}
+			for (; i < count; ++i)
+				out[i] = Atan2(y[i], x[i], accuracy);
+		}
+
+		MATH_TARGET_AVX2
+		static void ExpKernelAVX2(const float* in, float* out, const size_t& count, const Accuracy& accuracy) {
+			PolynomialLanes poly;
+			SplatPolynomial(ExpPolynomials[static_cast<int>(accuracy)], poly);
+
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8) {
+				__m256 v = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(in + i), _mm256_set1_ps(ExpMax)), _mm256_set1_ps(ExpMin));
+				__m256i n = _mm256_cvtps_epi32(_mm256_mul_ps(v, _mm256_set1_ps(M_LOG2E)));
+				__m256 nf = _mm256_cvtepi32_ps(n);
+				__m256 r = _mm256_fnmadd_ps(nf, _mm256_set1_ps(Ln2Hi), v);
+				r = _mm256_fnmadd_ps(nf, _mm256_set1_ps(Ln2Lo), r);
+
+				__m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23));
+				_mm256_storeu_ps(out + i, _mm256_mul_ps(HornerAVX2(poly, r), scale));
+			}
+			for (; i < count; ++i)
+				out[i] = Exp(in[i], accuracy);
+		}
+
+		// 1 / sqrt(x) of 8 values, full accuracy divides and the others refine the rsqrt estimate
+		MATH_TARGET_AVX2
+		static __m256 RsqrtAVX2(const __m256& x, const Accuracy& accuracy) {
+			if (accuracy == Accuracy::Full) return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(x));
+
+			__m256 r = _mm256_rsqrt_ps(x);
+			if (accuracy == Accuracy::Medium) {
+				__m256 halfX = _mm256_mul_ps(_mm256_set1_ps(0.5f), x);
+				r = _mm256_mul_ps(r, _mm256_fnmadd_ps(_mm256_mul_ps(halfX, r), r, _mm256_set1_ps(1.5f)));
+			}
+			return r;
+		}
+
+		MATH_TARGET_AVX2
+		static void RsqrtKernelAVX2(const float* in, float* out, const size_t& count, const Accuracy& accuracy) {
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+				_mm256_storeu_ps(out + i, RsqrtAVX2(_mm256_loadu_ps(in + i), accuracy));
+			for (; i < count; ++i)
+				out[i] = Rsqrt(in[i], accuracy);
+		}
+
+		MATH_TARGET_AVX2
+		static void NormalizeKernelAVX2(const Vector3* in, Vector3* out, const size_t& count, const Accuracy& accuracy) {
+			const __m256 small = _mm256_set1_ps(REALLY_SMALL * REALLY_SMALL);
+
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8) {
+				__m256 x, y, z;
+				SIMD::LoadVector3x8(&in[i].x, x, y, z);
+
+				// vectors too short to normalize become zero like Vector3::Normalize
+				__m256 magSq = _mm256_fmadd_ps(z, z, _mm256_fmadd_ps(y, y, _mm256_mul_ps(x, x)));
+				__m256 inv = _mm256_and_ps(RsqrtAVX2(magSq, accuracy), _mm256_cmp_ps(magSq, small, _CMP_GE_OQ));
+				SIMD::StoreVector3x8(&out[i].x, _mm256_mul_ps(x, inv), _mm256_mul_ps(y, inv), _mm256_mul_ps(z, inv));
+			}
+			for (; i < count; ++i)
+				out[i] = Normalize(in[i], accuracy);
+		}
+
+		/// array functions
+
+		void Sin(const float* in, float* out, const size_t& count, const Accuracy& accuracy) {
+			SinCos(in, out, nullptr, count, accuracy);
+		}
+
+		void Cos(const float* in, float* out, const size_t& count, const Accuracy& accuracy) {
+			SinCos(in, nullptr, out, count, accuracy);
+		}
+
+		void SinCos(const float* in, float* outSin, float* outCos, const size_t& count, const Accuracy& accuracy) {
+			if (SIMD::HasAVX2()) {
+				SinCosKernelAVX2(in, outSin, outCos, count, accuracy);
+				return;
+			}
+			for (size_t i = 0; i < count; ++i) {
+				float s, c;
+				SinCos(in[i], s, c, accuracy);
+				if (outSin) outSin[i] = s;
+				if (outCos) outCos[i] = c;
+			}
+		}
+
+		void Atan2(const float* y, const float* x, float* out, const size_t& count, const Accuracy& accuracy) {
+			if (SIMD::HasAVX2()) {
+				Atan2KernelAVX2(y, x, out, count, accuracy);
+				return;
+			}
+			for (size_t i = 0; i < count; ++i)
+				out[i] = Atan2(y[i], x[i], accuracy);
+		}
+
+		void Exp(const float* in, float* out, const size_t& count, const Accuracy& accuracy) {
+			if (SIMD::HasAVX2()) {
+				ExpKernelAVX2(in, out, count, accuracy);
+				return;
+			}
+			for (size_t i = 0; i < count; ++i)
+				out[i] = Exp(in[i], accuracy);
+		}
+
+		void Rsqrt(const float* in, float* out, const size_t& count, const Accuracy& accuracy) {
+			if (SIMD::HasAVX2()) {
+				RsqrtKernelAVX2(in, out, count, accuracy);
+				return;
+			}
+			for (size_t i = 0; i < count; ++i)
+				out[i] = Rsqrt(in[i], accuracy);
+		}
+
+		void Normalize(const Vector3* in, Vector3* out, const size_t& count, const Accuracy& accuracy) {
+			if (SIMD::HasAVX2()) {
+				NormalizeKernelAVX2(in, out, count, accuracy);
+				return;
+			}
+			for (size_t i = 0; i < count; ++i)
+				out[i] = Normalize(in[i], accuracy);
+		}
+
+	}
+
+}
\ No newline at end of file
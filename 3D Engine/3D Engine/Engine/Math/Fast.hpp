@@ -0,0 +1,279 @@
+#ifndef MATH_FAST_HPP
+#define MATH_FAST_HPP
+#include "CommonMath.hpp"
+#include "Vector.hpp"
+#include "SIMD.hpp"
+#include <cstddef>
+#include <cstring>
+
+namespace Math {
+
+	/// polynomial sin, cos, atan2, exp and rsqrt for code that calls them in bulk
+	/// angles are in radians, unlike Math::Sin and the others in CommonMath
+	/// every function takes an accuracy, the max errors against double precision are
+	///
+	///             Low      Medium   Full
+	///   Sin/Cos   2.0e-3   1.1e-5   1.0e-7   absolute, for |x| < 8192
+	///   Atan2     6.1e-4   2.0e-6   3.5e-7   absolute
+	///   Exp       1.8e-3   2.8e-6   1.2e-7   relative, x is clamped to [-87, 88]
+	///   Rsqrt     3.7e-4   3.0e-7   1.2e-7   relative
+	///
+	/// Tests/FastMath checks these and times them against the c library
+	///
+	/// the array versions do 8 at a time with avx2 when the cpu has it and match the scalar ones
+	/// up to the rounding of fused multiply adds, out can be the same array as in
+	/// the scalar versions can also take the accuracy as a template argument, Fast::Sin<Accuracy::Low>(x),
+	/// the others switch on it once and are just as fast when it is a constant
+	namespace Fast {
+
+		enum class Accuracy : unsigned char { Low, Medium, Full };
+
+		// a polynomial with its lowest power first
+		struct Polynomial {
+			int count;
+			float c[9];
+		};
+
+		// sin(r) / r on [-pi/4, pi/4] in terms of r^2, one per accuracy
+		static constexpr Polynomial SinPolynomials[3] = {
+			{ 2, { 9.990314245e-01f, -1.603440195e-01f } },
+			{ 3, { 9.999949932e-01f, -1.666016132e-01f, 8.121557534e-03f } },
+			{ 4, { 1.0f, -1.666663736e-01f, 8.331584744e-03f, -1.946211705e-04f } },
+		};
+		// cos(r) on [-pi/4, pi/4] in terms of r^2
+		static constexpr Polynomial CosPolynomials[3] = {
+			{ 2, { 9.980797172e-01f, -4.748232067e-01f } },
+			{ 3, { 9.999900460e-01f, -4.997081757e-01f, 4.039859399e-02f } },
+			{ 5, { 1.0f, -0.5f, 4.166661575e-02f, -1.388661913e-03f, 2.437993680e-05f } },
+		};
+		// atan(t) / t on [0, 1] in terms of t^2
+		static constexpr Polynomial AtanPolynomials[3] = {
+			{ 3, { 9.953579307e-01f, -2.886902392e-01f, 7.933903486e-02f } },
+			{ 6, { 9.999772310e-01f, -3.326228261e-01f, 1.935403794e-01f, -1.164264828e-01f, 5.264734849e-02f, -1.171913464e-02f } },
+			{ 9, { 9.999998808e-01f, -3.333259821e-01f, 1.998590678e-01f, -1.416122913e-01f, 1.049894616e-01f,
+				   -7.234857976e-02f, 3.978123143e-02f, -1.440136228e-02f, 2.456725575e-03f } },
+		};
+		// exp(r) on [-ln2/2, ln2/2]
+		static constexpr Polynomial ExpPolynomials[3] = {
+			{ 3, { 1.000443101e+00f, 1.014860988e+00f, 4.962585568e-01f } },
+			{ 5, { 9.999992847e-01f, 9.999634027e-01f, 5.000435710e-01f, 1.679090708e-01f, 4.145860672e-02f } },
+			{ 7, { 1.0f, 1.0f, 4.999999106e-01f, 1.666641980e-01f, 4.166822508e-02f, 8.374815807e-03f, 1.383684576e-03f } },
+		};
+
+		// pi/2 and ln2 split so that k * hi is exact, keeps the reduced value accurate for large k
+		static const float HalfPiHi = 1.5703125f;
+		static const float HalfPiMid = 4.837512969970703125e-4f;
+		static const float HalfPiLo = 7.54978995489188216e-8f;
+		static const float Ln2Hi = 0.693359375f;
+		static const float Ln2Lo = -2.12194440e-4f;
+
+		// exp clamps to this range so 2^n stays a normal float
+		static const float ExpMin = -87.0f;
+		static const float ExpMax = 88.0f;
+
+		// the first Count coefficients of c at x, the count is a template argument so there is no loop left
+		template<int Count>
+		inline float Horner(const float* c, const float& x) {
+			return Horner<Count - 1>(c + 1, x) * x + c[0];
+		}
+		template<>
+		inline float Horner<1>(const float* c, const float&) {
+			return c[0];
+		}
+
+		// rounds to the nearest int without a branch, halves go to even like the avx2 kernels
+		// both follow the current rounding mode, which is to nearest even unless something changed it
+		inline int Round(const float& x) {
+			#if MATH_SSE
+			return _mm_cvtss_si32(_mm_set_ss(x));
+			#else
+			return static_cast<int>(lrintf(x));
+			#endif
+		}
+
+		// the bits of a float, the signs and quadrants below are fixed with these instead of branches
+		// since they are different for every input and would be mispredicted half the time
+		inline unsigned int ToBits(const float& f) {
+			unsigned int bits;
+			memcpy(&bits, &f, sizeof(float));
+			return bits;
+		}
+		inline float FromBits(const unsigned int& bits) {
+			float f;
+			memcpy(&f, &bits, sizeof(float));
+			return f;
+		}
+		static const unsigned int SignBit = 0x80000000u;
+
+		/// scalar functions
+
+		// sin and cos of x together for about the cost of one
+		template<Accuracy A>
+		inline void SinCos(const float& x, float& outSin, float& outCos) {
+			// x = k * pi/2 + r with r in [-pi/4, pi/4]
+			int k = Round(x * M_2_PI);
+			float kf = static_cast<float>(k);
+			float r = ((x - kf * HalfPiHi) - kf * HalfPiMid) - kf * HalfPiLo;
+			float r2 = r * r;
+
+			constexpr int a = static_cast<int>(A);
+			float s = r * Horner<SinPolynomials[a].count>(SinPolynomials[a].c, r2);
+			float c = Horner<CosPolynomials[a].count>(CosPolynomials[a].c, r2);
+
+			// each quarter turn swaps sin and cos and flips one of them
+			unsigned int swap = 0u - static_cast<unsigned int>(k & 1);
+			unsigned int sinBits = ToBits(s), cosBits = ToBits(c);
+			outSin = FromBits(((sinBits & ~swap) | (cosBits & swap)) ^ (static_cast<unsigned int>(k & 2) << 30));
+			outCos = FromBits(((cosBits & ~swap) | (sinBits & swap)) ^ (static_cast<unsigned int>((k + 1) & 2) << 30));
+		}
+		template<Accuracy A>
+		inline float Sin(const float& x) {
+			float s, c;
+			SinCos<A>(x, s, c);
+			return s;
+		}
+		template<Accuracy A>
+		inline float Cos(const float& x) {
+			float s, c;
+			SinCos<A>(x, s, c);
+			return c;
+		}
+
+		// the angle of (x, y) in [-pi, pi], signed zeros give the same results as atan2f
+		template<Accuracy A>
+		inline float Atan2(const float& y, const float& x) {
+			float ax = fabsf(x);
+			float ay = fabsf(y);
+			float hi = ax > ay ? ax : ay;
+			float lo = ax > ay ? ay : ax;
+
+			// atan of the smaller over the larger so the polynomial only covers [0, 1], both 0 gives 0
+			float t = hi > 0.0f ? lo / hi : 0.0f;
+			constexpr int a = static_cast<int>(A);
+			float r = t * Horner<AtanPolynomials[a].count>(AtanPolynomials[a].c, t * t);
+
+			// pi/2 - r when y was the larger, then pi - r when x is negative, then the sign of y
+			unsigned int steep = ay > ax ? 1u : 0u;
+			r = FromBits(ToBits(r) ^ (steep << 31)) + static_cast<float>(steep) * M_PI_2;
+			unsigned int xSign = ToBits(x) >> 31;
+			r = FromBits(ToBits(r) ^ (xSign << 31)) + static_cast<float>(xSign) * M_PI;
+			return FromBits(ToBits(r) ^ (ToBits(y) & SignBit));
+		}
+
+		template<Accuracy A>
+		inline float Exp(const float& x) {
+			// x = n * ln2 + r, so exp(x) = 2^n * exp(r)
+			float v = Clamp(x, ExpMin, ExpMax);
+			int n = Round(v * M_LOG2E);
+			float nf = static_cast<float>(n);
+			float r = (v - nf * Ln2Hi) - nf * Ln2Lo;
+
+			// 2^n is written straight into the exponent bits
+			int bits = (n + 127) << 23;
+			float scale;
+			memcpy(&scale, &bits, sizeof(float));
+			constexpr int a = static_cast<int>(A);
+			return Horner<ExpPolynomials[a].count>(ExpPolynomials[a].c, r) * scale;
+		}
+
+		// 1 / sqrt(x) for x > 0
+		template<Accuracy A>
+		inline float Rsqrt(const float& x) {
+			if (A == Accuracy::Full) return 1.0f / sqrtf(x);
+
+			#if MATH_SSE
+			float r = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+			#else
+			// the bit trick guess is only good to about 3e-2 and one newton step gets 2e-3,
+			// it takes two to be at least as close as rsqrtss
+			int bits;
+			memcpy(&bits, &x, sizeof(float));
+			bits = 0x5f375a86 - (bits >> 1);
+			float r;
+			memcpy(&r, &bits, sizeof(float));
+			r = r * (1.5f - 0.5f * x * r * r);
+			r = r * (1.5f - 0.5f * x * r * r);
+			#endif
+
+			// one newton step roughly doubles the correct bits
+			if (A == Accuracy::Medium) r = r * (1.5f - 0.5f * x * r * r);
+			return r;
+		}
+
+		// like Vector3::Normalize, vectors too short to normalize become zero
+		template<Accuracy A>
+		inline Vector3 Normalize(const Vector3& vec) {
+			float magSq = vec.x * vec.x + vec.y * vec.y + vec.z * vec.z;
+			if (magSq < REALLY_SMALL * REALLY_SMALL) return Vector3(0.0f);
+			float inv = Rsqrt<A>(magSq);
+			return Vector3(vec.x * inv, vec.y * inv, vec.z * inv);
+		}
+
+		// the same with the accuracy picked at run time
+		inline void SinCos(const float& x, float& outSin, float& outCos, const Accuracy& accuracy = Accuracy::Medium) {
+			switch (accuracy) {
+			case Accuracy::Low: SinCos<Accuracy::Low>(x, outSin, outCos); break;
+			case Accuracy::Medium: SinCos<Accuracy::Medium>(x, outSin, outCos); break;
+			default: SinCos<Accuracy::Full>(x, outSin, outCos); break;
+			}
+		}
+		inline float Sin(const float& x, const Accuracy& accuracy = Accuracy::Medium) {
+			switch (accuracy) {
+			case Accuracy::Low: return Sin<Accuracy::Low>(x);
+			case Accuracy::Medium: return Sin<Accuracy::Medium>(x);
+			default: return Sin<Accuracy::Full>(x);
+			}
+		}
+		inline float Cos(const float& x, const Accuracy& accuracy = Accuracy::Medium) {
+			switch (accuracy) {
+			case Accuracy::Low: return Cos<Accuracy::Low>(x);
+			case Accuracy::Medium: return Cos<Accuracy::Medium>(x);
+			default: return Cos<Accuracy::Full>(x);
+			}
+		}
+		inline float Atan2(const float& y, const float& x, const Accuracy& accuracy = Accuracy::Medium) {
+			switch (accuracy) {
+			case Accuracy::Low: return Atan2<Accuracy::Low>(y, x);
+			case Accuracy::Medium: return Atan2<Accuracy::Medium>(y, x);
+			default: return Atan2<Accuracy::Full>(y, x);
+			}
+		}
+		inline float Exp(const float& x, const Accuracy& accuracy = Accuracy::Medium) {
+			switch (accuracy) {
+			case Accuracy::Low: return Exp<Accuracy::Low>(x);
+			case Accuracy::Medium: return Exp<Accuracy::Medium>(x);
+			default: return Exp<Accuracy::Full>(x);
+			}
+		}
+		inline float Rsqrt(const float& x, const Accuracy& accuracy = Accuracy::Medium) {
+			switch (accuracy) {
+			case Accuracy::Low: return Rsqrt<Accuracy::Low>(x);
+			case Accuracy::Medium: return Rsqrt<Accuracy::Medium>(x);
+			default: return Rsqrt<Accuracy::Full>(x);
+			}
+		}
+		inline Vector3 Normalize(const Vector3& vec, const Accuracy& accuracy = Accuracy::Medium) {
+			switch (accuracy) {
+			case Accuracy::Low: return Normalize<Accuracy::Low>(vec);
+			case Accuracy::Medium: return Normalize<Accuracy::Medium>(vec);
+			default: return Normalize<Accuracy::Full>(vec);
+			}
+		}
+
+		/// array functions
+
+		void Sin(const float* in, float* out, const size_t& count, const Accuracy& accuracy = Accuracy::Medium);
+		void Cos(const float* in, float* out, const size_t& count, const Accuracy& accuracy = Accuracy::Medium);
+		// either output can be nullptr
+		void SinCos(const float* in, float* outSin, float* outCos, const size_t& count, const Accuracy& accuracy = Accuracy::Medium);
+		// out[i] = Atan2(y[i], x[i])
+		void Atan2(const float* y, const float* x, float* out, const size_t& count, const Accuracy& accuracy = Accuracy::Medium);
+		void Exp(const float* in, float* out, const size_t& count, const Accuracy& accuracy = Accuracy::Medium);
+		void Rsqrt(const float* in, float* out, const size_t& count, const Accuracy& accuracy = Accuracy::Medium);
+		void Normalize(const Vector3* in, Vector3* out, const size_t& count, const Accuracy& accuracy = Accuracy::Medium);
+
+	}
+
+}
+
+#endif // !MATH_FAST_HPP
\ No newline at end of file
@@ -187,6 +187,7 @@ namespace Math {
 	};
 
 
+	// each row loads into an sse register, unaligned like Vector4
 	struct Matrix4 {
 		// the data
 		float m[16];
@@ -234,6 +235,21 @@ namespace Math {
 		Matrix4 operator*(const Matrix4& other) const {
 			Matrix4 temp;
 
+			#if MATH_SSE
+			// each row of the result is the rows of other scaled by one row of this
+			// added in the same order as the scalar version so both give the same bits
+			__m128 r0 = _mm_loadu_ps(other.m);
+			__m128 r1 = _mm_loadu_ps(other.m + 4);
+			__m128 r2 = _mm_loadu_ps(other.m + 8);
+			__m128 r3 = _mm_loadu_ps(other.m + 12);
+			for (int i = 0; i < 16; i += 4) {
+				__m128 row = _mm_mul_ps(_mm_set1_ps(m[i]), r0);
+				row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i + 1]), r1));
+				row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i + 2]), r2));
+				row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i + 3]), r3));
+				_mm_storeu_ps(temp.m + i, row);
+			}
+			#else
 			// 00 01 02 03
 			// 04 05 06 07
 			// 08 09 10 11
@@ -263,24 +279,40 @@ namespace Math {
 			temp.m[14] = m[12] * other.m[2] + m[13] * other.m[6] + m[14] * other.m[10] + m[15] * other.m[14];
 			temp.m[15] = m[12] * other.m[3] + m[13] * other.m[7] + m[14] * other.m[11] + m[15] * other.m[15];
 
+			#endif
+
 			//return the new matrix
 			return temp;
 		}
 		Matrix4 operator+(const Matrix4& other) const {
+			#if MATH_SSE
+			Matrix4 temp;
+			for (int i = 0; i < 16; i += 4)
+				_mm_storeu_ps(temp.m + i, _mm_add_ps(_mm_loadu_ps(m + i), _mm_loadu_ps(other.m + i)));
+			return temp;
+			#else
 			return Matrix4(
 				m[0] + other.m[0], m[1] + other.m[1], m[2] + other.m[2], m[3] + other.m[3],
 				m[4] + other.m[4], m[5] + other.m[5], m[6] + other.m[6], m[7] + other.m[7],
 				m[8] + other.m[8], m[9] + other.m[9], m[10] + other.m[10], m[11] + other.m[11],
 				m[12] + other.m[12], m[13] + other.m[13], m[14] + other.m[14], m[15] + other.m[15]
 			);
+			#endif
 		}
 		Matrix4 operator-(const Matrix4& other) const {
+			#if MATH_SSE
+			Matrix4 temp;
+			for (int i = 0; i < 16; i += 4)
+				_mm_storeu_ps(temp.m + i, _mm_sub_ps(_mm_loadu_ps(m + i), _mm_loadu_ps(other.m + i)));
+			return temp;
+			#else
 			return Matrix4(
 				m[0] - other.m[0], m[1] - other.m[1], m[2] - other.m[2], m[3] - other.m[3],
 				m[4] - other.m[4], m[5] - other.m[5], m[6] - other.m[6], m[7] - other.m[7],
 				m[8] - other.m[8], m[9] - other.m[9], m[10] - other.m[10], m[11] - other.m[11],
 				m[12] - other.m[12], m[13] - other.m[13], m[14] - other.m[14], m[15] - other.m[15]
 			);
+			#endif
 		}
 		Vector3 operator*(const Vector3& vec) const {
 			Vector3 res;
@@ -303,24 +335,28 @@ namespace Math {
 			return res;
 		}
 		Vector4 operator*(const Vector4& vec) const {
+			#if MATH_SSE
+			// multiply every row by the vector then transpose so each lane adds up one row
+			__m128 v = vec.Load();
+			__m128 r0 = _mm_mul_ps(_mm_loadu_ps(m), v);
+			__m128 r1 = _mm_mul_ps(_mm_loadu_ps(m + 4), v);
+			__m128 r2 = _mm_mul_ps(_mm_loadu_ps(m + 8), v);
+			__m128 r3 = _mm_mul_ps(_mm_loadu_ps(m + 12), v);
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			return Vector4(_mm_add_ps(_mm_add_ps(_mm_add_ps(r0, r1), r2), r3));
+			#else
 			Vector4 v;
 
-			v.x = m[0] * vec.x + m[1] * vec.y + m[2] * vec.z + m[3];
-			v.y = m[4] * vec.x + m[5] * vec.y + m[6] * vec.z + m[7];
-			v.z = m[8] * vec.x + m[9] * vec.y + m[10] * vec.z + m[11];
-			v.w = m[12] * vec.x + m[13] * vec.y + m[14] * vec.z + m[15];
+			v.x = m[0] * vec.x + m[1] * vec.y + m[2] * vec.z + m[3] * vec.w;
+			v.y = m[4] * vec.x + m[5] * vec.y + m[6] * vec.z + m[7] * vec.w;
+			v.z = m[8] * vec.x + m[9] * vec.y + m[10] * vec.z + m[11] * vec.w;
+			v.w = m[12] * vec.x + m[13] * vec.y + m[14] * vec.z + m[15] * vec.w;
 
 			return v;
+			#endif
 		}
 		friend Vector4 operator*(const Vector4& vec, const Matrix4& mat) {
-			Vector4 v;
-
-			v.x = mat.m[0] * vec.x + mat.m[1] * vec.y + mat.m[2] * vec.z + mat.m[3];
-			v.y = mat.m[4] * vec.x + mat.m[5] * vec.y + mat.m[6] * vec.z + mat.m[7];
-			v.z = mat.m[8] * vec.x + mat.m[9] * vec.y + mat.m[10] * vec.z + mat.m[11];
-			v.w = mat.m[12] * vec.x + mat.m[13] * vec.y + mat.m[14] * vec.z + mat.m[15];
-
-			return v;
+			return mat * vec;
 		}
 
 		const float& operator[](const unsigned int& index) const {
@@ -332,12 +368,26 @@ namespace Math {
 
 		/// member functions
 		Matrix4 Transpose() const {
+			#if MATH_SSE
+			__m128 r0 = _mm_loadu_ps(m);
+			__m128 r1 = _mm_loadu_ps(m + 4);
+			__m128 r2 = _mm_loadu_ps(m + 8);
+			__m128 r3 = _mm_loadu_ps(m + 12);
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			Matrix4 temp;
+			_mm_storeu_ps(temp.m, r0);
+			_mm_storeu_ps(temp.m + 4, r1);
+			_mm_storeu_ps(temp.m + 8, r2);
+			_mm_storeu_ps(temp.m + 12, r3);
+			return temp;
+			#else
 			return Matrix4(
 				m[0], m[4], m[8], m[12],
 				m[1], m[5], m[9], m[13],
 				m[2], m[6], m[10], m[14],
 				m[3], m[7], m[11], m[15]
 			);
+			#endif
 		}
 		float Determinant() const {
 			// calculates and returns the determinant
@@ -347,6 +397,9 @@ namespace Math {
 				- m[3] * (m[4] * (m[9] * m[14] - m[10] * m[13]) - m[5] * (m[8] * m[14] - m[10] * m[12]) + m[6] * (m[8] * m[13] - m[9] * m[12]));
 		}
 		Matrix4 Inverse() const {
+			#if MATH_SSE
+			return InverseSSE();
+			#else
 			Matrix4 m0;
 
 			// calculate adjugate
@@ -413,7 +466,124 @@ namespace Math {
 			m0.m[15] *= det;
 
 			return m0;
+			#endif
+		}
+
+		// inverts a matrix whose last row is 0 0 0 1, cheaper than Inverse
+		// only the 3x3 part is inverted and the translation is moved back through it
+		Matrix4 InverseAffine() const {
+			// the cofactors of the 3x3 part
+			float c0 = m[5] * m[10] - m[6] * m[9];
+			float c1 = m[6] * m[8] - m[4] * m[10];
+			float c2 = m[4] * m[9] - m[5] * m[8];
+			float det = m[0] * c0 + m[1] * c1 + m[2] * c2;
+
+			#if _DEBUG
+			if (det == 0.0f) throw "determinant was 0";
+			#endif
+
+			float inv = 1.0f / det;
+			Matrix4 m0(
+				c0 * inv, (m[2] * m[9] - m[1] * m[10]) * inv, (m[1] * m[6] - m[2] * m[5]) * inv, 0.0f,
+				c1 * inv, (m[0] * m[10] - m[2] * m[8]) * inv, (m[2] * m[4] - m[0] * m[6]) * inv, 0.0f,
+				c2 * inv, (m[1] * m[8] - m[0] * m[9]) * inv, (m[0] * m[5] - m[1] * m[4]) * inv, 0.0f,
+				0.0f, 0.0f, 0.0f, 1.0f
+			);
+			m0.m[3] = -(m0.m[0] * m[3] + m0.m[1] * m[7] + m0.m[2] * m[11]);
+			m0.m[7] = -(m0.m[4] * m[3] + m0.m[5] * m[7] + m0.m[6] * m[11]);
+			m0.m[11] = -(m0.m[8] * m[3] + m0.m[9] * m[7] + m0.m[10] * m[11]);
+			return m0;
+		}
+		// inverts a matrix that only rotates and translates, the rotation is just transposed
+		Matrix4 InverseRigid() const {
+			return Matrix4(
+				m[0], m[4], m[8], -(m[0] * m[3] + m[4] * m[7] + m[8] * m[11]),
+				m[1], m[5], m[9], -(m[1] * m[3] + m[5] * m[7] + m[9] * m[11]),
+				m[2], m[6], m[10], -(m[2] * m[3] + m[6] * m[7] + m[10] * m[11]),
+				0.0f, 0.0f, 0.0f, 1.0f
+			);
+		}
+
+		#if MATH_SSE
+		// inverts the matrix as four 2x2 blocks
+		// |A B|-1                    |X Y|
+		// |C D|    = 1 / determinant |Z W|, where each of X Y Z W is built from the adjugates of the blocks
+		// the rounding is different from the scalar version so the results can be a few ulps apart
+		Matrix4 InverseSSE() const {
+			__m128 r0 = _mm_loadu_ps(m);
+			__m128 r1 = _mm_loadu_ps(m + 4);
+			__m128 r2 = _mm_loadu_ps(m + 8);
+			__m128 r3 = _mm_loadu_ps(m + 12);
+
+			// the 2x2 blocks stored as 00 01 10 11
+			__m128 a = _mm_movelh_ps(r0, r1);
+			__m128 b = _mm_movehl_ps(r1, r0);
+			__m128 c = _mm_movelh_ps(r2, r3);
+			__m128 d = _mm_movehl_ps(r3, r2);
+
+			// the determinants of the blocks as |A| |B| |C| |D|
+			__m128 dets = _mm_sub_ps(
+				_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+				_mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0))));
+			__m128 detA = _mm_shuffle_ps(dets, dets, _MM_SHUFFLE(0, 0, 0, 0));
+			__m128 detB = _mm_shuffle_ps(dets, dets, _MM_SHUFFLE(1, 1, 1, 1));
+			__m128 detC = _mm_shuffle_ps(dets, dets, _MM_SHUFFLE(2, 2, 2, 2));
+			__m128 detD = _mm_shuffle_ps(dets, dets, _MM_SHUFFLE(3, 3, 3, 3));
+
+			// adj(D) * C and adj(A) * B
+			__m128 dc = Mat2AdjMul(d, c);
+			__m128 ab = Mat2AdjMul(a, b);
+
+			// adjugates of the blocks of the inverse
+			__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, dc));
+			__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, ab));
+			__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, ab));
+			__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, dc));
+
+			// |M| = |A||D| + |B||C| - trace(adj(A) * B * adj(D) * C)
+			__m128 tr = _mm_mul_ps(ab, _mm_shuffle_ps(dc, dc, _MM_SHUFFLE(3, 1, 2, 0)));
+			tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(2, 3, 0, 1)));
+			tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, _MM_SHUFFLE(1, 0, 3, 2)));
+			__m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+			#if _DEBUG
+			if (_mm_cvtss_f32(det) == 0.0f) throw "determinant was 0";
+			#endif
+
+			// the signs of the adjugate go in with the determinant
+			__m128 invDet = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+			x = _mm_mul_ps(x, invDet);
+			y = _mm_mul_ps(y, invDet);
+			z = _mm_mul_ps(z, invDet);
+			w = _mm_mul_ps(w, invDet);
+
+			// take the adjugates of the blocks and put them back in rows
+			Matrix4 temp;
+			_mm_storeu_ps(temp.m, _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+			_mm_storeu_ps(temp.m + 4, _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+			_mm_storeu_ps(temp.m + 8, _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+			_mm_storeu_ps(temp.m + 12, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+			return temp;
+		}
+
+		/// 2x2 blocks stored as 00 01 10 11
+
+		// a * b
+		static __m128 Mat2Mul(const __m128& a, const __m128& b) {
+			return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))),
+							  _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+		}
+		// adj(a) * b
+		static __m128 Mat2AdjMul(const __m128& a, const __m128& b) {
+			return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b),
+							  _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+		}
+		// a * adj(b)
+		static __m128 Mat2MulAdj(const __m128& a, const __m128& b) {
+			return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))),
+							  _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
 		}
+		#endif
 
 		/// static member functions
 		static Matrix4 Identity() {
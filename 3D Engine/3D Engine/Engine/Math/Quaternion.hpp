@@ -1,9 +1,11 @@
 #ifndef MATH_QUATERNION_HPP
 #define MATH_QUATERNION_HPP
 #include "CommonMath.hpp"
+#include "Vector.hpp"
 
 namespace Math {
 
+	// loads into an sse register with the lanes w x y z, unaligned like Vector4
 	struct Quaternion {
 
 		float w, x, y, z;
@@ -12,16 +14,53 @@ namespace Math {
 		Quaternion(float w_, float x_, float y_, float z_)
 			: w(w_), x(x_), y(y_), z(z_) { }
 
+		#if MATH_SSE
+		/// sse conversions
+		explicit Quaternion(const __m128& q) { _mm_storeu_ps(&w, q); }
+		__m128 Load() const { return _mm_loadu_ps(&w); }
+		#endif
+
 		/// operators
-		Quaternion operator*(Quaternion other) {
-			Vector3 ot(other.x, other.y, other.z);
-			Vector3 ts(x, y, z);
-			Vector3 ve = w * ot + other.w * ts + Vector3::Cross(ts, ot);
-			return Quaternion(ve.x, ve.y, ve.z, w * other.w - Vector3::Dot(ts, ot));
+		Quaternion operator*(const Quaternion& other) const {
+			#if MATH_SSE
+			// the product is other scaled by each lane of this, shuffled and with some signs flipped
+			__m128 b = other.Load();
+			__m128 res = _mm_mul_ps(_mm_set1_ps(w), b);
+			__m128 bx = _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f));
+			__m128 by = _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)), _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f));
+			__m128 bz = _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)), _mm_setr_ps(-0.0f, -0.0f, 0.0f, 0.0f));
+			res = _mm_add_ps(res, _mm_mul_ps(_mm_set1_ps(x), bx));
+			res = _mm_add_ps(res, _mm_mul_ps(_mm_set1_ps(y), by));
+			res = _mm_add_ps(res, _mm_mul_ps(_mm_set1_ps(z), bz));
+			return Quaternion(res);
+			#else
+			return Quaternion(
+				w * other.w - x * other.x - y * other.y - z * other.z,
+				w * other.x + x * other.w + y * other.z - z * other.y,
+				w * other.y - x * other.z + y * other.w + z * other.x,
+				w * other.z + x * other.y - y * other.x + z * other.w
+			);
+			#endif
 		}
-		Vector3 operator*(const Vector3& vec) {
-			Quaternion res = *this * Quaternion(vec.x, vec.y, vec.z, 0.0f) * Conjugate(*this);
-			return Vector3(res.x, res.y, res.z);
+		// rotates the vector, the quaternion has to be normalized
+		// v + 2w(u x v) + 2u x (u x v) where u is the vector part, cheaper than q * v * q^-1
+		Vector3 operator*(const Vector3& vec) const {
+			#if MATH_SSE
+			__m128 q = Load();
+			__m128 u = _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 3, 2, 1));
+			__m128 v = _mm_setr_ps(vec.x, vec.y, vec.z, 0.0f);
+			__m128 t = Cross(u, v);
+			t = _mm_add_ps(t, t);
+			__m128 res = _mm_add_ps(_mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(w), t)), Cross(u, t));
+			alignas(16) float out[4];
+			_mm_store_ps(out, res);
+			return Vector3(out[0], out[1], out[2]);
+			#else
+			Vector3 u(x, y, z);
+			Vector3 t = Vector3::Cross(u, vec);
+			t += t;
+			return vec + w * t + Vector3::Cross(u, t);
+			#endif
 		}
 
 		/// member functions
@@ -37,6 +76,16 @@ namespace Math {
 		}
 
 		/// static member functions
+		#if MATH_SSE
+		// the cross product of the xyz lanes, the w lane comes out 0
+		static __m128 Cross(const __m128& a, const __m128& b) {
+			__m128 ayzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+			__m128 bzxy = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+			__m128 azxy = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+			__m128 byzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+			return _mm_sub_ps(_mm_mul_ps(ayzx, bzxy), _mm_mul_ps(azxy, byzx));
+		}
+		#endif
 		static Quaternion Normalize(const Quaternion& q) {
 			Quaternion res = q;
 			float mag = res.Magnitude();
@@ -60,6 +109,37 @@ namespace Math {
 			res.y = res.y / mags;
 			res.z = res.z / mags;
 			res.w = res.w / mags;
+			return res;
+		}
+		static float Dot(const Quaternion& q0, const Quaternion& q1) {
+			return q0.w * q1.w + q0.x * q1.x + q0.y * q1.y + q0.z * q1.z;
+		}
+		// blends the components and normalizes, cheap and close to Slerp for small angles
+		// takes the shorter way around, q and -q are the same rotation
+		static Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, const float& t) {
+			float s = Dot(q0, q1) < 0.0f ? -t : t;
+			Quaternion res(q0.w + (q1.w * s - q0.w * t), q0.x + (q1.x * s - q0.x * t),
+						   q0.y + (q1.y * s - q0.y * t), q0.z + (q1.z * s - q0.z * t));
+			return Normalize(res);
+		}
+		// turns at a constant speed from q0 to q1 the shorter way around
+		// precondition: q0 and q1 are normalized
+		static Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, const float& t) {
+			float cosAngle = Dot(q0, q1);
+			float sign = 1.0f;
+			if (cosAngle < 0.0f) {
+				cosAngle = -cosAngle;
+				sign = -1.0f;
+			}
+
+			// nearly the same rotation, sin of the angle is too small to divide by
+			if (cosAngle > 0.9995f) return Nlerp(q0, q1, t);
+
+			float angle = acosf(cosAngle);
+			float invSin = 1.0f / sinf(angle);
+			float s0 = sinf((1.0f - t) * angle) * invSin;
+			float s1 = sinf(t * angle) * invSin * sign;
+			return Quaternion(q0.w * s0 + q1.w * s1, q0.x * s0 + q1.x * s1, q0.y * s0 + q1.y * s1, q0.z * s0 + q1.z * s1);
 		}
 		static Quaternion Eular(const float& x, const float& y, const float& z) {
 			float cy = cosf(DEG_TO_RAD(z) * 0.5f);
@@ -0,0 +1,137 @@
+#ifndef MATH_SIMD_HPP
+#define MATH_SIMD_HPP
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+// marks a function that uses avx2/fma so it can be built without turning them on for the whole project
+// only call these functions after checking Math::SIMD::HasAVX2()
+// define MATH_NO_AVX2 before including the math headers to make HasAVX2 false so only the scalar kernels run
+#if defined(_MSC_VER)
+#define MATH_TARGET_AVX2
+#else
+#define MATH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+// Vector4, Matrix4 and Quaternion use sse when the compiler targets it, sse2 is always there on x64
+// define MATH_NO_SSE before including the math headers to build the scalar versions instead
+#if !defined(MATH_NO_SSE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MATH_SSE 1
+#else
+#define MATH_SSE 0
+#endif
+
+namespace Math {
+
+	namespace SIMD {
+
+		// the instruction sets the cpu and os support
+		struct CPUFeatures {
+			bool sse41;
+			bool avx;
+			bool avx2;
+			bool fma;
+		};
+
+		static void CPUID(int info[4], const int& leaf, const int& subleaf) {
+			#if defined(_MSC_VER)
+			__cpuidex(info, leaf, subleaf);
+			#else
+			unsigned int a, b, c, d;
+			__cpuid_count(leaf, subleaf, a, b, c, d);
+			info[0] = static_cast<int>(a); info[1] = static_cast<int>(b);
+			info[2] = static_cast<int>(c); info[3] = static_cast<int>(d);
+			#endif
+		}
+
+		static unsigned long long XGetBV() {
+			#if defined(_MSC_VER)
+			return _xgetbv(0);
+			#else
+			unsigned int a, d;
+			__asm__ volatile("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+			return (static_cast<unsigned long long>(d) << 32) | a;
+			#endif
+		}
+
+		static CPUFeatures DetectFeatures() {
+			CPUFeatures features = { false, false, false, false };
+			int info[4];
+
+			CPUID(info, 0, 0);
+			int maxLeaf = info[0];
+			if (maxLeaf < 1) return features;
+
+			CPUID(info, 1, 0);
+			features.sse41 = (info[2] & (1 << 19)) != 0;
+			features.fma = (info[2] & (1 << 12)) != 0;
+
+			// avx also needs the os to save the ymm registers
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			bool avx = (info[2] & (1 << 28)) != 0;
+			features.avx = avx && osxsave && (XGetBV() & 6) == 6;
+
+			if (maxLeaf >= 7) {
+				CPUID(info, 7, 0);
+				features.avx2 = features.avx && (info[1] & (1 << 5)) != 0;
+			}
+			features.fma = features.fma && features.avx;
+
+			return features;
+		}
+
+		// the features are only detected once
+		static const CPUFeatures& GetFeatures() {
+			static const CPUFeatures features = DetectFeatures();
+			return features;
+		}
+
+		// checks for avx2 and fma together since the 8 wide kernels use both
+		static bool HasAVX2() {
+			#if defined(MATH_NO_AVX2)
+			return false;
+			#else
+			return GetFeatures().avx2 && GetFeatures().fma;
+			#endif
+		}
+
+		// loads 8 packed x y z vectors as 6 groups of 4 floats and shuffles them into one register per axis
+		MATH_TARGET_AVX2
+		static void LoadVector3x8(const float* p, __m256& x, __m256& y, __m256& z) {
+			__m256 m03 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 12), 1);
+			__m256 m14 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 4)), _mm_loadu_ps(p + 16), 1);
+			__m256 m25 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 8)), _mm_loadu_ps(p + 20), 1);
+
+			__m256 xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+			__m256 yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+			x = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+			y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+			z = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+		}
+
+		// the reverse of LoadVector3x8
+		MATH_TARGET_AVX2
+		static void StoreVector3x8(float* p, const __m256& x, const __m256& y, const __m256& z) {
+			__m256 rxy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+			__m256 ryz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+			__m256 rzx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+			__m256 r03 = _mm256_shuffle_ps(rxy, rzx, _MM_SHUFFLE(2, 0, 2, 0));
+			__m256 r14 = _mm256_shuffle_ps(ryz, rxy, _MM_SHUFFLE(3, 1, 2, 0));
+			__m256 r25 = _mm256_shuffle_ps(rzx, ryz, _MM_SHUFFLE(3, 1, 3, 1));
+
+			_mm_storeu_ps(p, _mm256_castps256_ps128(r03));
+			_mm_storeu_ps(p + 4, _mm256_castps256_ps128(r14));
+			_mm_storeu_ps(p + 8, _mm256_castps256_ps128(r25));
+			_mm_storeu_ps(p + 12, _mm256_extractf128_ps(r03, 1));
+			_mm_storeu_ps(p + 16, _mm256_extractf128_ps(r14, 1));
+			_mm_storeu_ps(p + 20, _mm256_extractf128_ps(r25, 1));
+		}
+
+	}
+
+}
+
+#endif // !MATH_SIMD_HPP
\ No newline at end of file
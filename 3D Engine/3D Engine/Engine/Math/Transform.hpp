@@ -0,0 +1,99 @@
+#ifndef MATH_TRANSFORM_HPP
+#define MATH_TRANSFORM_HPP
+#include "Vector.hpp"
+#include "Matrix.hpp"
+#include "Quaternion.hpp"
+
+namespace Math {
+
+	// a position, rotation and scale applied in the order scale, rotate, translate
+	// the matrix is only rebuilt when it is asked for after something changed
+	// compose and inverse are exact for uniform scale, with non uniform scale and a rotation
+	// the result would need shear so only the scale of each axis is carried over
+	class Transform {
+
+		Vector3 position;
+		Quaternion rotation;
+		Vector3 scale;
+
+		mutable Matrix4 matrix;
+		mutable bool matrixDirty;
+
+	public:
+
+		Transform()
+			: position(), rotation(1.0f, 0.0f, 0.0f, 0.0f), scale(1.0f, 1.0f, 1.0f), matrixDirty(true) { }
+		Transform(const Vector3& position_, const Quaternion& rotation_)
+			: position(position_), rotation(rotation_), scale(1.0f, 1.0f, 1.0f), matrixDirty(true) { }
+		Transform(const Vector3& position_, const Quaternion& rotation_, const Vector3& scale_)
+			: position(position_), rotation(rotation_), scale(scale_), matrixDirty(true) { }
+
+		/// getters
+		const Vector3& GetPosition() const { return position; }
+		const Quaternion& GetRotation() const { return rotation; }
+		const Vector3& GetScale() const { return scale; }
+		// scale, then rotate, then translate, built from the quaternion without any trig
+		const Matrix4& GetMatrix() const {
+			if (matrixDirty) {
+				float xx = rotation.x * rotation.x, yy = rotation.y * rotation.y, zz = rotation.z * rotation.z;
+				float xy = rotation.x * rotation.y, xz = rotation.x * rotation.z, yz = rotation.y * rotation.z;
+				float wx = rotation.w * rotation.x, wy = rotation.w * rotation.y, wz = rotation.w * rotation.z;
+				matrix = Matrix4(
+					(1.0f - 2.0f * (yy + zz)) * scale.x, 2.0f * (xy - wz) * scale.y, 2.0f * (xz + wy) * scale.z, position.x,
+					2.0f * (xy + wz) * scale.x, (1.0f - 2.0f * (xx + zz)) * scale.y, 2.0f * (yz - wx) * scale.z, position.y,
+					2.0f * (xz - wy) * scale.x, 2.0f * (yz + wx) * scale.y, (1.0f - 2.0f * (xx + yy)) * scale.z, position.z,
+					0.0f, 0.0f, 0.0f, 1.0f
+				);
+				matrixDirty = false;
+			}
+			return matrix;
+		}
+		// the inverse of GetMatrix, the rotation is transposed instead of doing a full inverse
+		Matrix4 GetInverseMatrix() const {
+			if (scale.x == 1.0f && scale.y == 1.0f && scale.z == 1.0f)
+				return GetMatrix().InverseRigid();
+			return GetMatrix().InverseAffine();
+		}
+
+		/// setters
+		void SetPosition(const Vector3& position_) { position = position_; matrixDirty = true; }
+		void SetRotation(const Quaternion& rotation_) { rotation = rotation_; matrixDirty = true; }
+		void SetScale(const Vector3& scale_) { scale = scale_; matrixDirty = true; }
+
+		/// functions
+
+		// takes a point from local space into the space this transform is in
+		Vector3 TransformPoint(const Vector3& point) const {
+			return position + rotation * Vector3::Scale(scale, point);
+		}
+		// like TransformPoint without the position
+		Vector3 TransformDirection(const Vector3& dir) const {
+			return rotation * Vector3::Scale(scale, dir);
+		}
+		// takes a point back into local space
+		Vector3 InverseTransformPoint(const Vector3& point) const {
+			Vector3 local = Quaternion::Conjugate(rotation) * (point - position);
+			return Vector3(local.x / scale.x, local.y / scale.y, local.z / scale.z);
+		}
+
+		// undoes this transform, the rotation has to be normalized
+		// only exact for uniform scale, with non uniform scale use GetInverseMatrix
+		Transform Inverse() const {
+			Quaternion inv = Quaternion::Conjugate(rotation);
+			Vector3 invScale(1.0f / scale.x, 1.0f / scale.y, 1.0f / scale.z);
+			return Transform(Vector3::Scale(invScale, inv * -position), inv, invScale);
+		}
+
+		/// operators
+
+		// applies other first and then this, the same as multiplying their matrices
+		// only when this transform's scale is uniform, otherwise the shear the product would have is dropped
+		Transform operator*(const Transform& other) const {
+			return Transform(TransformPoint(other.position), rotation * other.rotation, Vector3::Scale(scale, other.scale));
+		}
+
+	};
+
+}
+
+#endif // !MATH_TRANSFORM_HPP
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef MATH_FLOAT_VECTOR_HPP
 #define MATH_FLOAT_VECTOR_HPP
 #include "CommonMath.hpp"
+#include "SIMD.hpp"
 
 namespace Math {
 
@@ -197,11 +198,20 @@ namespace Math {
 			return direction + normal * Dot(-direction, normal) * 2.0f;
 		}
 		static Vector3 Cross(const Vector3& v0, const Vector3& v1) {
-			return Vector3(v0.y * v1.z + v0.z * v1.y, v0.x * v1.z - v0.z * v1.x, v0.x * v1.y + v0.y * v1.x);
+			return Vector3(v0.y * v1.z - v0.z * v1.y, v0.z * v1.x - v0.x * v1.z, v0.x * v1.y - v0.y * v1.x);
+		}
+		// multiplies each axis of a by the same axis of b
+		static Vector3 Scale(const Vector3& a, const Vector3& b) {
+			return Vector3(a.x * b.x, a.y * b.y, a.z * b.z);
+		}
+		static Vector3 Lerp(const Vector3& a, const Vector3& b, const float& t) {
+			return Vector3((b.x - a.x) * t + a.x, (b.y - a.y) * t + a.y, (b.z - a.z) * t + a.z);
 		}
 
 	};
 
+	// loads into an sse register with unaligned loads, new and DArray only give 8 byte alignment
+	// on 32 bit windows so the math types can't count on 16
 	struct Vector4 {
 		float x, y, z, w;
 
@@ -222,6 +232,12 @@ namespace Math {
 		Vector4(const float& x_, const Vector3& vec)
 			: x(x_), y(vec.x), z(vec.y), w(vec.z) { }
 
+		#if MATH_SSE
+		/// sse conversions
+		explicit Vector4(const __m128& vec) { _mm_storeu_ps(&x, vec); }
+		__m128 Load() const { return _mm_loadu_ps(&x); }
+		#endif
+
 		/// member functions
 		float Magnitude() const {
 			return sqrtf(x * x + y * y + z * z + w * w);
@@ -231,6 +247,49 @@ namespace Math {
 		}
 
 		/// operators
+		#if MATH_SSE
+		Vector4 operator+(const Vector4& other) const {
+			return Vector4(_mm_add_ps(Load(), other.Load()));
+		}
+		Vector4 operator-(const Vector4& other) const {
+			return Vector4(_mm_sub_ps(Load(), other.Load()));
+		}
+		Vector4 operator*(const float& scalar) const {
+			return Vector4(_mm_mul_ps(Load(), _mm_set1_ps(scalar)));
+		}
+		friend Vector4 operator*(const float& scalar, const Vector4& vec) {
+			return Vector4(_mm_mul_ps(vec.Load(), _mm_set1_ps(scalar)));
+		}
+		Vector4 operator/(const float& divisor) const {
+			if (divisor == 0.0f) return Vector4(0.0f);
+			return Vector4(_mm_div_ps(Load(), _mm_set1_ps(divisor)));
+		}
+		friend Vector4 operator/(const float& divisor, const Vector4& vec) {
+			if (divisor == 0.0f) return Vector4(0.0f);
+			return Vector4(_mm_div_ps(vec.Load(), _mm_set1_ps(divisor)));
+		}
+		Vector4& operator+=(const Vector4& other) {
+			_mm_storeu_ps(&x, _mm_add_ps(Load(), other.Load()));
+			return *this;
+		}
+		Vector4& operator-=(const Vector4& other) {
+			_mm_storeu_ps(&x, _mm_sub_ps(Load(), other.Load()));
+			return *this;
+		}
+		Vector4& operator*=(const float& scalar) {
+			_mm_storeu_ps(&x, _mm_mul_ps(Load(), _mm_set1_ps(scalar)));
+			return *this;
+		}
+		Vector4& operator/=(const float& divisor) {
+			if (divisor == 0.0f) _mm_storeu_ps(&x, _mm_setzero_ps());
+			else _mm_storeu_ps(&x, _mm_div_ps(Load(), _mm_set1_ps(divisor)));
+			return *this;
+		}
+		Vector4 operator-() const {
+			// flip the sign bits
+			return Vector4(_mm_xor_ps(Load(), _mm_set1_ps(-0.0f)));
+		}
+		#else
 		Vector4 operator+(const Vector4& other) const {
 			return Vector4(x + other.x, y + other.y, z + other.z, w + other.w);
 		}
@@ -286,6 +345,7 @@ namespace Math {
 		Vector4 operator-() const {
 			return Vector4(-x, -y, -z, -w);
 		}
+		#endif
 		bool operator==(const Vector4& other) const {
 			return x == other.x && y == other.y && z == other.z && w == other.w;
 		}
@@ -301,12 +361,20 @@ namespace Math {
 
 		/// static member functions
 		static Vector4 Normalize(const Vector4& vec) {
-			float mag = sqrtf(vec.x * vec.x + vec.y * vec.y + vec.z * vec.z + vec.w * vec.w);
+			float mag = sqrtf(Dot(vec, vec));
 			if (NearlyZero(mag, REALLY_SMALL)) return Vector4(0.0f);
-			return Vector4(vec.x / mag, vec.y / mag, vec.z / mag, vec.w / mag);
+			return vec / mag;
 		}
 		static float Dot(const Vector4& v0, const Vector4& v1) {
+			#if MATH_SSE
+			// adds the lanes as (x + y) + (z + w) so it can be a few ulps off the scalar sum
+			__m128 m = _mm_mul_ps(v0.Load(), v1.Load());
+			m = _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+			m = _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+			return _mm_cvtss_f32(m);
+			#else
 			return v0.x * v1.x + v0.y * v1.y + v0.z * v1.z + v0.w * v1.w;
+			#endif
 		}
 		static Vector4 Relfect(const Vector4& direction, Vector4 normal) {
 			return direction + normal * Dot(-direction, normal) * 2.0f;
@@ -0,0 +1,8 @@
+#ifndef MEMORY_HPP
+#define MEMORY_HPP
+
+// includes all the memory headers
+#include "Memory/PoolAllocator.hpp"
+#include "Memory/SlabAllocator.hpp"
+
+#endif // !MEMORY_HPP
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "PoolAllocator.hpp"
+#include <new>
+#include <cstdlib>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace Memory {
+
+	// on windows the pages come straight from VirtualAlloc, which starts every allocation on a 64KB boundary
+	// so a chunk needs no extra space to line it up, _aligned_malloc would ask for size + ChunkSize
+	void* AllocateChunk(const size_t& size) {
+		#if defined(_WIN32)
+		void* chunk = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+		#else
+		void* chunk = nullptr;
+		if (posix_memalign(&chunk, ChunkSize, size) != 0) chunk = nullptr;
+		#endif
+		if (!chunk) throw std::bad_alloc();
+		return chunk;
+	}
+
+	void FreeChunk(void* chunk) {
+		#if defined(_WIN32)
+		VirtualFree(chunk, 0, MEM_RELEASE);
+		#else
+		free(chunk);
+		#endif
+	}
+
+	PoolAllocator::PoolAllocator(const size_t& blockSize) : chunks(nullptr), freeList(nullptr) {
+		stats.blockSize = 0;
+		stats.blocksPerChunk = 0;
+		stats.chunkCount = 0;
+		stats.usedBlocks = 0;
+		stats.peakBlocks = 0;
+		stats.allocations = 0;
+		SetBlockSize(blockSize);
+	}
+
+	PoolAllocator::~PoolAllocator() {
+		Release();
+	}
+
+	void PoolAllocator::SetBlockSize(const size_t& blockSize_) {
+		Release();
+
+		// blocks have to fit a free list link and stay aligned
+		size_t blockSize = blockSize_ < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize_;
+		blockSize = (blockSize + BlockAlignment - 1) & ~(BlockAlignment - 1);
+
+		stats.blockSize = blockSize;
+		stats.blocksPerChunk = (ChunkSize - ChunkHeaderSize) / blockSize;
+		#if _DEBUG
+		if (stats.blocksPerChunk == 0) throw "the block size is too big for a chunk";
+		#endif
+	}
+
+	void PoolAllocator::AddChunk() {
+		char* memory = static_cast<char*>(AllocateChunk(ChunkSize));
+
+		ChunkHeader* chunk = reinterpret_cast<ChunkHeader*>(memory);
+		chunk->pool = this;
+		chunk->prev = nullptr;
+		chunk->next = chunks;
+		if (chunks) chunks->prev = chunk;
+		chunks = chunk;
+		++stats.chunkCount;
+
+		// push the blocks backwards so they are handed out in address order
+		char* blocks = memory + ChunkHeaderSize;
+		for (size_t i = stats.blocksPerChunk; i > 0; --i) {
+			FreeBlock* block = reinterpret_cast<FreeBlock*>(blocks + (i - 1) * stats.blockSize);
+			block->next = freeList;
+			freeList = block;
+		}
+	}
+
+	void* PoolAllocator::Allocate() {
+		if (!freeList) AddChunk();
+
+		FreeBlock* block = freeList;
+		freeList = block->next;
+
+		++stats.allocations;
+		++stats.usedBlocks;
+		if (stats.usedBlocks > stats.peakBlocks) stats.peakBlocks = stats.usedBlocks;
+		return block;
+	}
+
+	void PoolAllocator::Free(void* block) {
+		if (!block) return;
+		#if _DEBUG
+		if (ChunkOf(block)->pool != this) throw "the block was not allocated by this pool";
+		#endif
+
+		FreeBlock* freed = static_cast<FreeBlock*>(block);
+		freed->next = freeList;
+		freeList = freed;
+		--stats.usedBlocks;
+	}
+
+	void PoolAllocator::Release() {
+		while (chunks) {
+			ChunkHeader* next = chunks->next;
+			FreeChunk(chunks);
+			chunks = next;
+		}
+		freeList = nullptr;
+		stats.chunkCount = 0;
+		stats.usedBlocks = 0;
+	}
+
+}
\ No newline at end of file
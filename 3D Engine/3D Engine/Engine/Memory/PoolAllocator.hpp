@@ -0,0 +1,101 @@
+#ifndef MEMORY_POOL_ALLOCATOR_HPP
+#define MEMORY_POOL_ALLOCATOR_HPP
+#include <cstddef>
+#include <cstdint>
+
+namespace Memory {
+
+	// memory is taken from the system in chunks of this size aligned to this size
+	// so the chunk a block is in can be found by masking the block's address
+	static const size_t ChunkSize = 64 * 1024;
+	// the blocks of a chunk start after the chunk header
+	static const size_t ChunkHeaderSize = 64;
+	// every block is aligned to this
+	static const size_t BlockAlignment = 16;
+
+	class PoolAllocator;
+
+	// sits at the start of every chunk
+	struct ChunkHeader {
+		// the pool the chunk belongs to, nullptr for a chunk that holds one large block
+		PoolAllocator* pool;
+		ChunkHeader* prev;
+		ChunkHeader* next;
+	};
+
+	// gets a block of memory aligned to ChunkSize from the system, throws std::bad_alloc if there is none
+	void* AllocateChunk(const size_t& size);
+	void FreeChunk(void* chunk);
+
+	// the header of the chunk that block is in
+	// precondition: block came from a pool or slab allocator
+	inline ChunkHeader* ChunkOf(void* block) {
+		return reinterpret_cast<ChunkHeader*>(reinterpret_cast<uintptr_t>(block) & ~static_cast<uintptr_t>(ChunkSize - 1));
+	}
+
+	// how much of a pool is in use
+	struct PoolStats {
+		size_t blockSize;
+		size_t blocksPerChunk;
+		size_t chunkCount;
+		// blocks that are allocated right now
+		size_t usedBlocks;
+		// the most blocks that were allocated at once
+		size_t peakBlocks;
+		// every allocation the pool has made
+		size_t allocations;
+	};
+
+	// hands out blocks of one size from chunks, freed blocks go on a free list and are reused first
+	// the chunks are only given back to the system when the pool is released or destroyed
+	// not thread safe
+	class PoolAllocator {
+
+		// a free block stores the next free block in itself
+		struct FreeBlock {
+			FreeBlock* next;
+		};
+
+		ChunkHeader* chunks;
+		FreeBlock* freeList;
+		PoolStats stats;
+
+		// takes a new chunk from the system and puts its blocks on the free list
+		void AddChunk();
+
+	public:
+
+		explicit PoolAllocator(const size_t& blockSize = BlockAlignment);
+		~PoolAllocator();
+
+		PoolAllocator(const PoolAllocator&) = delete;
+		PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+		/// functions
+
+		// gets a block of GetBlockSize() bytes
+		void* Allocate();
+
+		// puts the block back on the free list
+		// precondition: block came from this pool
+		void Free(void* block);
+
+		// gives every chunk back to the system at once
+		// every block the pool handed out is invalid after this
+		void Release();
+
+		/// getters
+
+		const PoolStats& GetStats() const { return stats; }
+		size_t GetBlockSize() const { return stats.blockSize; }
+
+		/// setters
+
+		// changes the size of the blocks, releases the pool first
+		void SetBlockSize(const size_t& blockSize_);
+
+	};
+
+}
+
+#endif // !MEMORY_POOL_ALLOCATOR_HPP
\ No newline at end of file
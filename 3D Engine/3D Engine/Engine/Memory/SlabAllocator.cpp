@@ -0,0 +1,73 @@
+#include "SlabAllocator.hpp"
+
+namespace Memory {
+
+	SlabAllocator::SlabAllocator() : largeBlocks(nullptr), largeCount(0) {
+		for (size_t i = 0; i < SizeClassCount; ++i)
+			pools[i].SetBlockSize((i + 1) * BlockAlignment);
+	}
+
+	SlabAllocator::~SlabAllocator() {
+		Release();
+	}
+
+	void* SlabAllocator::Allocate(const size_t& size) {
+		if (size <= MaxBlockSize) return pools[SizeClass(size)].Allocate();
+
+		// big blocks get a chunk of their own so they can be freed the same way
+		char* memory = static_cast<char*>(AllocateChunk(ChunkHeaderSize + size));
+		ChunkHeader* chunk = reinterpret_cast<ChunkHeader*>(memory);
+		chunk->pool = nullptr;
+		chunk->prev = nullptr;
+		chunk->next = largeBlocks;
+		if (largeBlocks) largeBlocks->prev = chunk;
+		largeBlocks = chunk;
+		++largeCount;
+
+		return memory + ChunkHeaderSize;
+	}
+
+	void SlabAllocator::Free(void* block) {
+		if (!block) return;
+
+		ChunkHeader* chunk = ChunkOf(block);
+		if (chunk->pool) {
+			chunk->pool->Free(block);
+			return;
+		}
+
+		// unlink the large block
+		if (chunk->prev) chunk->prev->next = chunk->next;
+		else largeBlocks = chunk->next;
+		if (chunk->next) chunk->next->prev = chunk->prev;
+		--largeCount;
+		FreeChunk(chunk);
+	}
+
+	void SlabAllocator::Release() {
+		for (size_t i = 0; i < SizeClassCount; ++i)
+			pools[i].Release();
+
+		while (largeBlocks) {
+			ChunkHeader* next = largeBlocks->next;
+			FreeChunk(largeBlocks);
+			largeBlocks = next;
+		}
+		largeCount = 0;
+	}
+
+	size_t SlabAllocator::GetChunkCount() const {
+		size_t count = largeCount;
+		for (size_t i = 0; i < SizeClassCount; ++i)
+			count += pools[i].GetStats().chunkCount;
+		return count;
+	}
+
+	size_t SlabAllocator::GetUsedBlocks() const {
+		size_t count = largeCount;
+		for (size_t i = 0; i < SizeClassCount; ++i)
+			count += pools[i].GetStats().usedBlocks;
+		return count;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef MEMORY_SLAB_ALLOCATOR_HPP
+#define MEMORY_SLAB_ALLOCATOR_HPP
+#include "PoolAllocator.hpp"
+#include <new>
+#include <utility>
+
+namespace Memory {
+
+	// hands out memory of any size from a pool per size class
+	// sizes are rounded up to a multiple of BlockAlignment, sizes past MaxBlockSize get a chunk of their own
+	// a block can be freed without knowing its size because its chunk header says which pool it came from
+	// not thread safe
+	class SlabAllocator {
+	public:
+
+		static const size_t SizeClassCount = 32;
+		static const size_t MaxBlockSize = SizeClassCount * BlockAlignment;
+
+	private:
+
+		PoolAllocator pools[SizeClassCount];
+
+		/// blocks too big for the pools
+		ChunkHeader* largeBlocks;
+		size_t largeCount;
+
+	public:
+
+		SlabAllocator();
+		~SlabAllocator();
+
+		SlabAllocator(const SlabAllocator&) = delete;
+		SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+		/// functions
+
+		// gets a block of at least size bytes aligned to BlockAlignment
+		void* Allocate(const size_t& size);
+
+		// gives the block back to the pool it came from
+		// precondition: block came from this allocator
+		void Free(void* block);
+
+		// gives every chunk back to the system at once
+		// every block the allocator handed out is invalid after this, no destructors are run
+		void Release();
+
+		// constructs a T in a block
+		template<typename T, typename... Args>
+		T* New(Args&&... args) {
+			static_assert(alignof(T) <= BlockAlignment, "the type needs more alignment than the blocks have");
+			void* block = Allocate(sizeof(T));
+			return new (block) T(std::forward<Args>(args)...);
+		}
+
+		// destroys the object and frees its block
+		// T can be a base class as long as its destructor is virtual
+		template<typename T>
+		void Delete(T* object) {
+			if (!object) return;
+			object->~T();
+			Free(object);
+		}
+
+		/// getters
+
+		// the pool that blocks of size bytes come from, nullptr if they are too big for the pools
+		const PoolAllocator* GetPool(const size_t& size) const {
+			return size <= MaxBlockSize ? &pools[SizeClass(size)] : nullptr;
+		}
+		const PoolAllocator& GetPoolAt(const size_t& sizeClass) const { return pools[sizeClass]; }
+		size_t GetLargeBlockCount() const { return largeCount; }
+		// the chunks taken from the system by every pool and large block
+		size_t GetChunkCount() const;
+		// the blocks in use across every pool and large block
+		size_t GetUsedBlocks() const;
+
+		// the size class of a size
+		// precondition: size <= MaxBlockSize
+		static size_t SizeClass(const size_t& size) {
+			return size == 0 ? 0 : (size - 1) / BlockAlignment;
+		}
+
+	};
+
+}
+
+#endif // !MEMORY_SLAB_ALLOCATOR_HPP
\ No newline at end of file
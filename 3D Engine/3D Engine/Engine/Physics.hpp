@@ -3,11 +3,32 @@
 
 /// includes all of the physics headers
 
+#include "Physics/World.hpp"
+
 #include "Physics/Body.hpp"
 #include "Physics/Rigidbody.hpp"
 #include "Physics/Staticbody.hpp"
 
+#include "Physics/Broadphase.hpp"
+#include "Physics/Broadphases/DynamicTree.hpp"
+#include "Physics/Broadphases/SweepAndPrune.hpp"
+#include "Physics/Broadphases/HashGrid.hpp"
+
+#include "Physics/Narrowphase.hpp"
+#include "Physics/ContactCache.hpp"
+#include "Physics/ContactSolver.hpp"
+#include "Physics/ContinuousCollision.hpp"
+#include "Physics/SceneQuery.hpp"
+#include "Physics/CommandQueue.hpp"
+#include "Physics/BodySnapshot.hpp"
+#include "Physics/PhysicsThread.hpp"
+#include "Physics/Islands.hpp"
+#include "Physics/GravityField.hpp"
+#include "Physics/WellTree.hpp"
+#include "Physics/WellGrid.hpp"
+
 #include "Physics/Collider.hpp"
+#include "Physics/ColliderTables.hpp"
 #include "Physics/Colliders/SphereCollider.hpp"
 
 #include "Physics/PhysicsProperty.hpp"
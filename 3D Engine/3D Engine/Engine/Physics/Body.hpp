@@ -2,45 +2,64 @@
 #define PHYSICS_BODY_HPP
 #include "../Math/Vector.hpp"
 #include "../Math/Bounds.hpp"
-#include "../Containers/SList.hpp"
+#include "../Math/Quaternion.hpp"
+#include "../Math/Transform.hpp"
+#include "../Memory/SlabAllocator.hpp"
+#include "BodyStorage.hpp"
 #include "Collider.hpp"
 #include "PhysicsProperty.hpp"
 
 namespace Physics {
 
+	class World;
+
 	class Body {
 	protected:
+		friend World;
+		friend Collider;
+
+		// the storage that holds this bodies state
+		BodyStorage* storage;
+
+		// the handle of this body in the storage
+		BodyHandle handle;
 
-		// is this body actve
-		bool simulated;
+		// the allocator of the world, the collider and properties are made in it
+		Memory::SlabAllocator* allocator;
 
 		// the attached collider
 		Collider* collider;
 
-		// the list of physics properties
-		SList<PhysicsProperty*> properties;
+		// the attached physics properties indexed by their PropertyType, nullptr if there is none
+		PhysicsProperty* properties[PropertyTypeCount];
 
-		Math::Bounds3D bounds;
-		Math::Vector3 position;
-		Math::Vector3 rotation;
+		// the dense index of this body in the storage
+		unsigned int Index() const { return storage->GetIndex(handle); }
 
-		float friction;
-		float bounce;
-		float mass;
-		float density;
+		// marks the bounds dirty and wakes the body if it is dynamic
+		// other bodies wake the sleeping bodies around them when their bounds are refit
+		void Moved() {
+			unsigned int i = Index();
+			storage->flags[i] |= BodyFlags::BoundsDirty;
+			if (storage->flags[i] & BodyFlags::Dynamic) SetAwake(true);
+		}
 
 	public:
 
-		Body() : simulated(true), collider(nullptr), bounds(0.0f, 0.0f), position(0.0f), friction(0.0f), bounce(0.0f), mass(1.0f), density(1.0f) { }
+		Body() : storage(nullptr), allocator(nullptr), collider(nullptr) {
+			for (size_t i = 0; i < PropertyTypeCount; ++i)
+				properties[i] = nullptr;
+		}
 		virtual ~Body() = 0 {
 			// delete the collider
-			if (collider) delete collider;
+			allocator->Delete(collider);
 			collider = nullptr;
 
 			// delete the properties
-			for (PhysicsProperty* pp : properties)
-				delete pp;
-			properties.clear();
+			for (size_t i = 0; i < PropertyTypeCount; ++i) {
+				allocator->Delete(properties[i]);
+				properties[i] = nullptr;
+			}
 		}
 
 		/// setting/adding/removing components
@@ -49,15 +68,18 @@ namespace Physics {
 		template<typename C> 
 		C* SetCollider() {
 			// delete old collider
-			if (collider) delete collider;
+			allocator->Delete(collider);
 
 			// create a collider of type C and attach it
-			C* coll = new C();
+			C* coll = allocator->New<C>();
 			collider = coll;
 			collider->body = this;
+			unsigned int i = Index();
+			storage->flags[i] |= BodyFlags::HasCollider;
+			storage->AttachShape(i, collider->GetCollisionShape());
 
-			// update bounds
-			UpdateBounds();
+			// copy the collider into its shape table and update bounds
+			collider->UpdateBounds();
 
 			// return the collider as type C
 			return coll;
@@ -66,96 +88,164 @@ namespace Physics {
 		// deletes the currently attached collider
 		void DestroyCollider() {
 			// delete old collider
-			if (collider) delete collider;
+			allocator->Delete(collider);
+			collider = nullptr;
+
+			unsigned int i = Index();
+			unsigned char& f = storage->flags[i];
+			f = static_cast<unsigned char>(f & ~BodyFlags::HasCollider);
+			storage->DetachShape(i);
 		}
 
 		// creates a PhysicsProperty of type P
+		// a body has at most one property of each type, an old one of the same type is deleted
 		template<typename P>
 		P* CreateProperty() {
+			const size_t slot = static_cast<size_t>(P::Type);
+			if (properties[slot]) DeleteProperty(properties[slot]);
+
 			// create property of type P and attach
-			P* prop = new P();
+			P* prop = allocator->New<P>();
 			PhysicsProperty* pp = prop;
 			pp->body = this;
-			properties.push_back(pp);
+			pp->type = P::Type;
+			properties[slot] = pp;
+			storage->AddProperty(pp);
 
 			// return the property as type P
 			return prop;
 		}
 
-		// finds a property of type P
+		// finds the property of type P, nullptr if the body doesnt have one
 		template<typename P>
-		P* GetProperty() {
-			for (PhysicsProperty* prop : properties)
-				if (P* p = dynamic_cast<P*>(prop))
-					return p;
+		P* GetProperty() const {
+			return static_cast<P*>(properties[static_cast<size_t>(P::Type)]);
+		}
 
-			// if it could not find the property then return nullptr
-			return nullptr;
+		// checks if the body has a property of type P
+		template<typename P>
+		bool HasProperty() const {
+			return properties[static_cast<size_t>(P::Type)] != nullptr;
 		}
 
 		// delete the property
 		bool DeleteProperty(PhysicsProperty* prop) {
-			SList<PhysicsProperty*>::Iterator iter = properties.begin();
-			while (iter != properties.end()) {
-				if (*iter == prop) {
-					// delete and remove the property
-					delete prop;
-					properties.erase(iter);
-
-					// return true as it deleted the property
-					return true;
-				}
-			}
+			if (!prop) return false;
 
-			// return false if it couldnt find the property
-			return false;
+			// return false if the property isnt attached to this body
+			const size_t slot = static_cast<size_t>(prop->type);
+			if (slot >= PropertyTypeCount || properties[slot] != prop) return false;
+
+			// delete and remove the property
+			storage->RemoveProperty(prop);
+			properties[slot] = nullptr;
+			allocator->Delete(prop);
+			return true;
+		}
+
+		// delete the property of type P
+		template<typename P>
+		bool DeleteProperty() {
+			return DeleteProperty(properties[static_cast<size_t>(P::Type)]);
 		}
 
 
 		/// getters
 
-		bool GetSimulated() const { return simulated; }
+		bool GetSimulated() const { return (storage->flags[Index()] & BodyFlags::Simulated) != 0; }
+		bool IsAwake() const { return (storage->flags[Index()] & BodyFlags::Awake) != 0; }
+		BodyHandle GetHandle() const { return handle; }
 		Collider* GetCollider() const { return collider; }
 		template<typename C> 
 		C* GetCollider() const { return static_cast<C*>(collider); }
-		Math::Bounds3D GetBounds() const { return bounds; }
-		Math::Vector3 GetPosition() const { return position; }
-		Math::Vector3 GetRotation() const { return rotation; }
-		float GetFriction() const { return friction; }
-		float GetBounce() const { return bounce; }
-		float GetMass() const { return mass; }
-		float GetDensity() const { return density; }
+		Math::Bounds3D GetBounds() const {
+			// bounds that have not been refit yet are worked out on the spot
+			unsigned int i = Index();
+			if (storage->flags[i] & BodyFlags::BoundsDirty) return storage->ComputeBounds(i);
+			return storage->bounds[i];
+		}
+		Math::Vector3 GetPosition() const { return storage->positions[Index()]; }
+		Math::Quaternion GetRotation() const { return storage->rotations[Index()]; }
+		// the position and rotation of the body, colliders are placed relative to this
+		Math::Transform GetTransform() const {
+			unsigned int i = Index();
+			return Math::Transform(storage->positions[i], storage->rotations[i]);
+		}
+		float GetFriction() const { return storage->frictions[Index()]; }
+		float GetBounce() const { return storage->bounces[Index()]; }
+		float GetMass() const { return storage->masses[Index()]; }
+		float GetDensity() const { return storage->densities[Index()]; }
 
 		/// setters
 
-		void SetSimulated(const bool& simulated_) { simulated = simulated_; }
+		void SetSimulated(const bool& simulated_) {
+			unsigned char& f = storage->flags[Index()];
+			f = static_cast<unsigned char>(simulated_ ? (f | BodyFlags::Simulated) : (f & ~BodyFlags::Simulated));
+			if (simulated_) SetAwake(true);
+		}
+		// only dynamic bodies can sleep, a body put to sleep stops moving
+		void SetAwake(const bool& awake_) {
+			unsigned int i = Index();
+			unsigned char& f = storage->flags[i];
+			if (!(f & BodyFlags::Dynamic)) return;
+
+			storage->sleepTimes[i] = 0.0f;
+			if (awake_) {
+				f |= BodyFlags::Awake;
+			} else {
+				f = static_cast<unsigned char>(f & ~BodyFlags::Awake);
+				storage->velocities[i] = Math::Vector3(0.0f);
+				storage->angularVelocities[i] = Math::Vector3(0.0f);
+			}
+		}
+		// a body moved by hand is drawn where it was put instead of sliding there
 		void SetPosition(const Math::Vector3& position_) {
-			position = position_; UpdateBounds();
+			unsigned int i = Index();
+			storage->positions[i] = position_;
+			storage->previousPositions[i] = position_;
+			Moved();
 		}
-		void SetRotation(const Math::Vector3& rotation_) {
-			rotation = rotation_; UpdateBounds();
+		void SetRotation(const Math::Quaternion& rotation_) {
+			unsigned int i = Index();
+			storage->rotations[i] = rotation_;
+			storage->previousRotations[i] = rotation_;
+			Moved();
 		}
 		void SetFriction(const float& friction_) {
+			float& friction = storage->frictions[Index()];
 			friction = friction_;
 			if (friction <= 0.0f) friction = 0.0f;
 		}
 		void SetBounce(const float& bounce_) {
+			float& bounce = storage->bounces[Index()];
 			bounce = bounce_;
 			if (bounce <= 0.0f) bounce = 0.0f;
 		}
 		void SetMass(const float& mass_) {
+			unsigned int i = Index();
+			float& mass = storage->masses[i];
 			mass = mass_;
 			if (mass <= 0.00001f) mass = 0.00001f;
+
+			// only dynamic bodies can be pushed around
+			storage->inverseMasses[i] = (storage->flags[i] & BodyFlags::Dynamic) ? 1.0f / mass : 0.0f;
 		}
 		void SetDensity(const float& density_) {
+			float& density = storage->densities[Index()];
 			density = density_;
 			if (density <= 0.00001f) density = 0.00001f;
 		}
 
 		/// member functions
 
+		// marks the bounds to be refit by the world at the start of the next timestep
 		void UpdateBounds() {
-			bounds = collider->GetBounds(position, rotation);
+			storage->flags[Index()] |= BodyFlags::BoundsDirty;
+		}
+
+		// wakes every sleeping body touching region at the start of the next timestep
+		void WakeRegion(const Math::Bounds3D& region) {
+			storage->wakeRegions.push_back(region);
 		}
 
 
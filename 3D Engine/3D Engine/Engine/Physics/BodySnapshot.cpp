@@ -0,0 +1,41 @@
+#include "BodySnapshot.hpp"
+
+namespace Physics {
+
+	void BodySnapshot::Capture(const BodyStorage& storage, const float& alpha_, Jobs::JobSystem* jobs) {
+		const size_t count = storage.size();
+		alpha = alpha_;
+
+		handles.resize(count);
+		previousPositions.resize(count);
+		positions.resize(count);
+		previousRotations.resize(count);
+		rotations.resize(count);
+
+		// the handle map is only as big as the highest handle index
+		unsigned int highest = 0;
+		for (size_t i = 0; i < count; ++i) {
+			unsigned int index = storage.handles[i].index + 1;
+			if (index > highest) highest = index;
+		}
+		slots.resize(highest);
+		slots.fill(BodyHandle::Invalid);
+		for (size_t i = 0; i < count; ++i)
+			slots[storage.handles[i].index] = static_cast<unsigned int>(i);
+
+		const BodyStorage* s = &storage;
+		auto copy = [this, s](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				handles[i] = s->handles[i];
+				previousPositions[i] = s->previousPositions[i];
+				positions[i] = s->positions[i];
+				previousRotations[i] = s->previousRotations[i];
+				rotations[i] = s->rotations[i];
+			}
+		};
+
+		if (jobs) jobs->ParallelFor(count, 1024, copy);
+		else copy(0, count);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef PHYSICS_BODY_SNAPSHOT_HPP
+#define PHYSICS_BODY_SNAPSHOT_HPP
+#include "../Math/Vector.hpp"
+#include "../Math/Quaternion.hpp"
+#include "../Containers/DArray.hpp"
+#include "../Jobs/JobSystem.hpp"
+#include "BodyStorage.hpp"
+
+namespace Physics {
+
+	// a read only copy of where every body was before and after the last timestep of a world
+	// lets other threads draw the bodies while the world steps, positions and rotations are blended by alpha
+	class BodySnapshot {
+
+		DArray<BodyHandle> handles;
+		DArray<Math::Vector3> previousPositions;
+		DArray<Math::Vector3> positions;
+		DArray<Math::Quaternion> previousRotations;
+		DArray<Math::Quaternion> rotations;
+
+		// maps a handle index to the body's index in the snapshot, BodyHandle::Invalid if it isnt in it
+		DArray<unsigned int> slots;
+
+		// the world's interpolation alpha when the snapshot was taken
+		float alpha;
+
+	public:
+
+		BodySnapshot() : alpha(0.0f) { }
+
+		/// functions
+
+		// copies the transforms of every body in the storage
+		// jobs can be nullptr to copy on the calling thread
+		void Capture(const BodyStorage& storage, const float& alpha_, Jobs::JobSystem* jobs);
+
+		// the number of bodies in the snapshot
+		size_t size() const { return handles.size(); }
+
+		// finds the index of the body in the snapshot
+		// returns false if the body wasnt in the world when the snapshot was taken
+		bool Find(const BodyHandle& handle, unsigned int& index) const {
+			if (handle.index >= slots.size()) return false;
+			index = slots[handle.index];
+			return index != BodyHandle::Invalid && handles[index] == handle;
+		}
+
+		// blends the position from before the last timestep at 0 to after it at 1
+		Math::Vector3 GetPosition(const unsigned int& index, const float& alpha_) const {
+			return Math::Vector3::Lerp(previousPositions[index], positions[index], alpha_);
+		}
+		Math::Quaternion GetRotation(const unsigned int& index, const float& alpha_) const {
+			return Math::Quaternion::Nlerp(previousRotations[index], rotations[index], alpha_);
+		}
+
+		// blends the transform of the body, returns false if it isnt in the snapshot
+		bool Interpolate(const BodyHandle& handle, const float& alpha_, Math::Vector3& position, Math::Quaternion& rotation) const {
+			unsigned int index;
+			if (!Find(handle, index)) return false;
+			position = GetPosition(index, alpha_);
+			rotation = GetRotation(index, alpha_);
+			return true;
+		}
+
+		/// getters
+
+		const BodyHandle& GetHandle(const unsigned int& index) const { return handles[index]; }
+		float GetAlpha() const { return alpha; }
+
+	};
+
+}
+
+#endif // !PHYSICS_BODY_SNAPSHOT_HPP
\ No newline at end of file
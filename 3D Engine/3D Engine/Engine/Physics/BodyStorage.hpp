@@ -0,0 +1,276 @@
+#ifndef PHYSICS_BODY_STORAGE_HPP
+#define PHYSICS_BODY_STORAGE_HPP
+#include "../Math/Vector.hpp"
+#include "../Math/Quaternion.hpp"
+#include "../Math/Bounds.hpp"
+#include "../Containers/DArray.hpp"
+#include "PhysicsProperty.hpp"
+#include "Collider.hpp"
+#include "ColliderTables.hpp"
+
+namespace Physics {
+
+	class Body;
+
+	// a generational handle to a body
+	// the generation goes up every time the slot is reused so old handles stop being valid
+	struct BodyHandle {
+		unsigned int index;
+		unsigned int generation;
+
+		static const unsigned int Invalid = 0xffffffff;
+
+		BodyHandle() : index(Invalid), generation(0) { }
+		BodyHandle(const unsigned int& index_, const unsigned int& generation_)
+			: index(index_), generation(generation_) { }
+
+		bool IsNull() const { return index == Invalid; }
+
+		bool operator==(const BodyHandle& other) const {
+			return index == other.index && generation == other.generation;
+		}
+		bool operator!=(const BodyHandle& other) const {
+			return index != other.index || generation != other.generation;
+		}
+	};
+
+	// per body state bits
+	struct BodyFlags {
+		enum : unsigned char {
+			Simulated = 1 << 0,		// the body takes part in the simulation
+			Dynamic = 1 << 1,		// the body is moved by the integrator
+			HasCollider = 1 << 2,	// the body has a collider attached
+			InBroadphase = 1 << 3,	// the body has been inserted into the broadphase
+			Awake = 1 << 4,			// the body is moving, sleeping bodies are skipped until something wakes them
+			BoundsDirty = 1 << 5,	// the body moved or its collider changed, the bounds are refit at the start of the next timestep
+			Continuous = 1 << 6,	// the body is swept through the broadphase when it moves faster than its continuous speed
+		};
+	};
+
+	// stores the state of every body in a world as contiguous columns
+	// the columns are packed, a body's dense index changes when another body is removed
+	// so anything outside of the world should hold a BodyHandle instead
+	class BodyStorage {
+
+		// maps a handle index to a dense index
+		// free slots store the next free slot in dense
+		struct Slot {
+			unsigned int dense;
+			unsigned int generation;
+		};
+
+		DArray<Slot> slots;
+		unsigned int freeSlot;
+
+	public:
+
+		/// hot columns, read every step
+
+		DArray<Math::Vector3> positions;
+		DArray<Math::Quaternion> rotations;
+		DArray<Math::Vector3> velocities;
+		DArray<Math::Vector3> accelerations;
+		DArray<Math::Vector3> angularVelocities;
+		DArray<Math::Vector3> angularAccelerations;
+		// the acceleration from gravity wells, worked out every timestep
+		DArray<Math::Vector3> fieldAccelerations;
+		DArray<Math::Bounds3D> bounds;
+		DArray<float> inverseMasses;
+		DArray<unsigned char> flags;
+		// how long the body has been moving slowly enough to sleep
+		DArray<float> sleepTimes;
+		// where the body was before the last timestep, rendering interpolates from these
+		DArray<Math::Vector3> previousPositions;
+		DArray<Math::Quaternion> previousRotations;
+
+		/// cold columns
+
+		DArray<float> masses;
+		DArray<float> frictions;
+		DArray<float> bounces;
+		DArray<float> densities;
+		DArray<Body*> bodies;
+		DArray<BodyHandle> handles;
+		// the shape of the attached collider so the bounds can be refit a shape at a time
+		DArray<CollisionShape> shapes;
+		// the entry of the collider in the table of its shape
+		DArray<unsigned int> shapeSlots;
+		// the speed above which a Continuous body is swept
+		DArray<float> continuousSpeeds;
+
+		/// the colliders of each shape
+
+		SphereTable spheres;
+
+		// sleeping bodies touching these bounds are woken at the start of the next timestep
+		DArray<Math::Bounds3D> wakeRegions;
+
+		// every property of each type, so a system only visits the bodies that have its property
+		DArray<PhysicsProperty*> properties[PropertyTypeCount];
+
+		BodyStorage() : freeSlot(BodyHandle::Invalid) { }
+
+		/// functions
+
+		// the number of bodies stored
+		size_t size() const { return handles.size(); }
+
+		// checks that the handle still points at a living body
+		bool IsValid(const BodyHandle& handle) const {
+			return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+		}
+
+		// checks if the body is simulated, dynamic and awake
+		bool IsMoving(const unsigned int& index) const {
+			const unsigned char mask = BodyFlags::Simulated | BodyFlags::Dynamic | BodyFlags::Awake;
+			return (flags[index] & mask) == mask;
+		}
+
+		// gets the dense index of the body
+		// precondition: handle is valid
+		unsigned int GetIndex(const BodyHandle& handle) const {
+			return slots[handle.index].dense;
+		}
+
+		// adds a new body with default values and returns its handle
+		BodyHandle Create(Body* body, const unsigned char& flags_) {
+			unsigned int dense = static_cast<unsigned int>(handles.size());
+
+			// reuse a free slot if there is one
+			unsigned int index;
+			if (freeSlot != BodyHandle::Invalid) {
+				index = freeSlot;
+				freeSlot = slots[index].dense;
+			} else {
+				index = static_cast<unsigned int>(slots.size());
+				Slot slot;
+				slot.generation = 0;
+				slots.push_back(slot);
+			}
+			slots[index].dense = dense;
+			BodyHandle handle(index, slots[index].generation);
+
+			// add the default values to every column
+			positions.push_back(Math::Vector3(0.0f));
+			rotations.push_back(Math::Quaternion(1.0f, 0.0f, 0.0f, 0.0f));
+			velocities.push_back(Math::Vector3(0.0f));
+			accelerations.push_back(Math::Vector3(0.0f));
+			angularVelocities.push_back(Math::Vector3(0.0f));
+			angularAccelerations.push_back(Math::Vector3(0.0f));
+			fieldAccelerations.push_back(Math::Vector3(0.0f));
+			bounds.push_back(Math::Bounds3D(0.0f, 0.0f));
+			inverseMasses.push_back((flags_ & BodyFlags::Dynamic) ? 1.0f : 0.0f);
+			flags.push_back(flags_);
+			sleepTimes.push_back(0.0f);
+			previousPositions.push_back(Math::Vector3(0.0f));
+			previousRotations.push_back(Math::Quaternion(1.0f, 0.0f, 0.0f, 0.0f));
+			masses.push_back(1.0f);
+			frictions.push_back(0.0f);
+			bounces.push_back(0.0f);
+			densities.push_back(1.0f);
+			bodies.push_back(body);
+			handles.push_back(handle);
+			shapes.push_back(CollisionShape::None);
+			shapeSlots.push_back(BodyHandle::Invalid);
+			continuousSpeeds.push_back(0.0f);
+
+			return handle;
+		}
+
+		// removes the body by moving the last body into its place
+		// precondition: handle is valid
+		void Destroy(const BodyHandle& handle) {
+			unsigned int dense = slots[handle.index].dense;
+			unsigned int last = static_cast<unsigned int>(handles.size() - 1);
+
+			DetachShape(dense);
+
+			// the last body moves into the removed body's dense index
+			slots[handles[last].index].dense = dense;
+			if (shapes[last] == CollisionShape::Sphere) spheres.bodies[shapeSlots[last]] = dense;
+
+			positions.swap_remove(dense);
+			rotations.swap_remove(dense);
+			velocities.swap_remove(dense);
+			accelerations.swap_remove(dense);
+			angularVelocities.swap_remove(dense);
+			angularAccelerations.swap_remove(dense);
+			fieldAccelerations.swap_remove(dense);
+			bounds.swap_remove(dense);
+			inverseMasses.swap_remove(dense);
+			flags.swap_remove(dense);
+			sleepTimes.swap_remove(dense);
+			previousPositions.swap_remove(dense);
+			previousRotations.swap_remove(dense);
+			masses.swap_remove(dense);
+			frictions.swap_remove(dense);
+			bounces.swap_remove(dense);
+			densities.swap_remove(dense);
+			bodies.swap_remove(dense);
+			handles.swap_remove(dense);
+			shapes.swap_remove(dense);
+			shapeSlots.swap_remove(dense);
+			continuousSpeeds.swap_remove(dense);
+
+			// bump the generation and put the slot on the free list
+			++slots[handle.index].generation;
+			slots[handle.index].dense = freeSlot;
+			freeSlot = handle.index;
+		}
+
+		// adds an entry for the body to the table of the shape
+		void AttachShape(const unsigned int& index, const CollisionShape& shape) {
+			DetachShape(index);
+			shapes[index] = shape;
+			if (shape == CollisionShape::Sphere) shapeSlots[index] = spheres.Add(index);
+		}
+
+		// removes the body's entry from the table of its shape
+		void DetachShape(const unsigned int& index) {
+			if (shapes[index] == CollisionShape::Sphere) {
+				// the last entry moves into the removed entry's place
+				unsigned int s = shapeSlots[index];
+				unsigned int moved = spheres.bodies.back();
+				spheres.Remove(s);
+				if (moved != index) shapeSlots[moved] = s;
+			}
+			shapes[index] = CollisionShape::None;
+			shapeSlots[index] = BodyHandle::Invalid;
+		}
+
+		// works out the bounds of the body's collider from the shape tables
+		// a body without a collider keeps the bounds it has
+		Math::Bounds3D ComputeBounds(const unsigned int& index) const {
+			switch (shapes[index]) {
+				case CollisionShape::Sphere: return spheres.GetBounds(shapeSlots[index], positions[index], rotations[index]);
+				case CollisionShape::None: return bounds[index];
+				default:
+					#if _DEBUG
+					throw "the collision shape has no table to work out its bounds from";
+					#endif
+					return bounds[index];
+			}
+		}
+
+		// adds the property to the list of its type
+		void AddProperty(PhysicsProperty* property) {
+			DArray<PhysicsProperty*>& list = properties[static_cast<size_t>(property->type)];
+			property->listIndex = static_cast<unsigned int>(list.size());
+			list.push_back(property);
+		}
+
+		// removes the property from the list of its type by moving the last property into its place
+		// precondition: the property was added
+		void RemoveProperty(PhysicsProperty* property) {
+			DArray<PhysicsProperty*>& list = properties[static_cast<size_t>(property->type)];
+			unsigned int index = property->listIndex;
+			list.back()->listIndex = index;
+			list.swap_remove(index);
+			property->listIndex = 0xffffffff;
+		}
+
+	};
+
+}
+
+#endif // !PHYSICS_BODY_STORAGE_HPP
\ No newline at end of file
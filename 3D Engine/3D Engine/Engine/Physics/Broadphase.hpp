@@ -0,0 +1,64 @@
+#ifndef PHYSICS_BROADPHASE_HPP
+#define PHYSICS_BROADPHASE_HPP
+#include "../Math/Bounds.hpp"
+#include "../Containers/DArray.hpp"
+#include "BodyStorage.hpp"
+
+namespace Physics {
+
+	enum class BroadphaseType : unsigned char { DynamicTree, SweepAndPrune, HashGrid };
+
+	// two bodies whose bounds overlap
+	struct BodyPair {
+		BodyHandle a, b;
+
+		BodyPair() { }
+		BodyPair(const BodyHandle& a_, const BodyHandle& b_) : a(a_), b(b_) { }
+
+		// a key that is the same no matter which order the bodies are in
+		unsigned long long Key() const {
+			unsigned long long ia = a.index, ib = b.index;
+			return ia < ib ? (ia << 32) | ib : (ib << 32) | ia;
+		}
+	};
+
+	// finds the pairs of bodies that could be touching
+	class Broadphase {
+	public:
+
+		// called for each body a ray passes through, returns how far along the ray to keep walking
+		// returning less than the current length clips the ray, returning 0 stops the walk
+		typedef float(*RayCallback)(void* data, const BodyHandle& handle);
+
+		Broadphase() { }
+		virtual ~Broadphase() = 0 { }
+
+		// adds a body to the broadphase
+		// static bodies are never paired with other static bodies
+		virtual void Insert(const BodyHandle& handle, const Math::Bounds3D& bounds, const bool& isStatic) = 0;
+
+		// removes a body from the broadphase
+		virtual void Remove(const BodyHandle& handle) = 0;
+
+		// tells the broadphase that the bodies bounds have changed
+		virtual void Move(const BodyHandle& handle, const Math::Bounds3D& bounds) = 0;
+
+		// clears pairs and writes every pair of overlapping bodies into it
+		virtual void FindPairs(DArray<BodyPair>& pairs) = 0;
+
+		// clears results and writes every body whose broadphase bounds overlap bounds into it
+		// the broadphase is only read so many threads can query at once
+		// bodies inserted or moved since the last FindPairs may be missed
+		virtual void Query(const Math::Bounds3D& bounds, DArray<BodyHandle>& results) const = 0;
+
+		// calls callback for every body whose bounds grown by radius are passed through by the segment
+		// from origin along direction for length, direction must be normalized
+		// the bodies are not visited in order of distance, the same rules as Query apply
+		virtual void QueryRay(const Math::Vector3& origin, const Math::Vector3& direction, const float& length, const float& radius,
+							  RayCallback callback, void* data) const = 0;
+
+	};
+
+}
+
+#endif // !PHYSICS_BROADPHASE_HPP
\ No newline at end of file
@@ -0,0 +1,368 @@
+#include "DynamicTree.hpp"
+#include <cmath>
+
+namespace Physics {
+
+	const int DynamicTree::Null;
+
+	DynamicTree::DynamicTree(const float& margin_) : root(Null), freeList(Null), margin(margin_) { }
+
+	DynamicTree::~DynamicTree() { }
+
+	int DynamicTree::AllocateNode() {
+		// grow the node array if there are no free nodes
+		if (freeList == Null) {
+			Node node;
+			node.parent = Null;
+			node.height = -1;
+			nodes.push_back(node);
+			freeList = static_cast<int>(nodes.size() - 1);
+		}
+
+		// take the first free node
+		int node = freeList;
+		freeList = nodes[node].parent;
+		nodes[node].parent = Null;
+		nodes[node].child1 = Null;
+		nodes[node].child2 = Null;
+		nodes[node].height = 0;
+		nodes[node].isStatic = false;
+		nodes[node].handle = BodyHandle();
+		return node;
+	}
+
+	void DynamicTree::FreeNode(const int& node) {
+		nodes[node].parent = freeList;
+		nodes[node].height = -1;
+		freeList = node;
+	}
+
+	void DynamicTree::Insert(const BodyHandle& handle, const Math::Bounds3D& bounds, const bool& isStatic) {
+		int leaf = AllocateNode();
+		nodes[leaf].bounds = Math::Bounds3D::Expand(bounds, margin);
+		nodes[leaf].handle = handle;
+		nodes[leaf].isStatic = isStatic;
+
+		// remember which leaf the body is in
+		if (proxies.size() <= handle.index) proxies.resize(handle.index + 1, Null);
+		proxies[handle.index] = leaf;
+
+		InsertLeaf(leaf);
+	}
+
+	void DynamicTree::Remove(const BodyHandle& handle) {
+		if (handle.index >= proxies.size()) return;
+		int leaf = proxies[handle.index];
+		if (leaf == Null) return;
+
+		RemoveLeaf(leaf);
+		FreeNode(leaf);
+		proxies[handle.index] = Null;
+	}
+
+	void DynamicTree::Move(const BodyHandle& handle, const Math::Bounds3D& bounds) {
+		int leaf = proxies[handle.index];
+
+		// still inside the fattened bounds so the tree does not need to change
+		if (Math::Bounds3D::Contains(nodes[leaf].bounds, bounds)) return;
+
+		RemoveLeaf(leaf);
+		nodes[leaf].bounds = Math::Bounds3D::Expand(bounds, margin);
+		InsertLeaf(leaf);
+	}
+
+	void DynamicTree::InsertLeaf(const int& leaf) {
+		if (root == Null) {
+			root = leaf;
+			nodes[root].parent = Null;
+			return;
+		}
+
+		// walk down the tree picking the child that costs the least to insert into
+		// the cost is the surface area that would be added to the tree
+		Math::Bounds3D leafBounds = nodes[leaf].bounds;
+		int index = root;
+		while (!nodes[index].IsLeaf()) {
+			int child1 = nodes[index].child1;
+			int child2 = nodes[index].child2;
+
+			float area = nodes[index].bounds.SurfaceArea();
+			float combinedArea = Math::Bounds3D::Combine(nodes[index].bounds, leafBounds).SurfaceArea();
+
+			// cost of making a new parent for this node and the leaf
+			float cost = 2.0f * combinedArea;
+
+			// minimum cost of pushing the leaf further down the tree
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			// cost of descending into each child
+			float cost1 = Math::Bounds3D::Combine(leafBounds, nodes[child1].bounds).SurfaceArea() + inheritanceCost;
+			if (!nodes[child1].IsLeaf()) cost1 -= nodes[child1].bounds.SurfaceArea();
+			float cost2 = Math::Bounds3D::Combine(leafBounds, nodes[child2].bounds).SurfaceArea() + inheritanceCost;
+			if (!nodes[child2].IsLeaf()) cost2 -= nodes[child2].bounds.SurfaceArea();
+
+			// stop here if descending costs more
+			if (cost < cost1 && cost < cost2) break;
+
+			index = cost1 < cost2 ? child1 : child2;
+		}
+		int sibling = index;
+
+		// make a new parent for the sibling and the leaf
+		int oldParent = nodes[sibling].parent;
+		int newParent = AllocateNode();
+		nodes[newParent].parent = oldParent;
+		nodes[newParent].bounds = Math::Bounds3D::Combine(leafBounds, nodes[sibling].bounds);
+		nodes[newParent].height = nodes[sibling].height + 1;
+		nodes[newParent].child1 = sibling;
+		nodes[newParent].child2 = leaf;
+		nodes[sibling].parent = newParent;
+		nodes[leaf].parent = newParent;
+
+		if (oldParent != Null) {
+			if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+			else nodes[oldParent].child2 = newParent;
+		} else {
+			// the sibling was the root
+			root = newParent;
+		}
+
+		// walk back up the tree fixing the heights and bounds
+		index = nodes[leaf].parent;
+		while (index != Null) {
+			index = Balance(index);
+
+			int child1 = nodes[index].child1;
+			int child2 = nodes[index].child2;
+			nodes[index].height = 1 + (nodes[child1].height > nodes[child2].height ? nodes[child1].height : nodes[child2].height);
+			nodes[index].bounds = Math::Bounds3D::Combine(nodes[child1].bounds, nodes[child2].bounds);
+
+			index = nodes[index].parent;
+		}
+	}
+
+	void DynamicTree::RemoveLeaf(const int& leaf) {
+		if (leaf == root) {
+			root = Null;
+			return;
+		}
+
+		int parent = nodes[leaf].parent;
+		int grandParent = nodes[parent].parent;
+		int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+		if (grandParent != Null) {
+			// connect the sibling to the grandparent and drop the parent
+			if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+			else nodes[grandParent].child2 = sibling;
+			nodes[sibling].parent = grandParent;
+			FreeNode(parent);
+
+			// walk back up the tree fixing the heights and bounds
+			int index = grandParent;
+			while (index != Null) {
+				index = Balance(index);
+
+				int child1 = nodes[index].child1;
+				int child2 = nodes[index].child2;
+				nodes[index].bounds = Math::Bounds3D::Combine(nodes[child1].bounds, nodes[child2].bounds);
+				nodes[index].height = 1 + (nodes[child1].height > nodes[child2].height ? nodes[child1].height : nodes[child2].height);
+
+				index = nodes[index].parent;
+			}
+		} else {
+			// the sibling becomes the root
+			root = sibling;
+			nodes[sibling].parent = Null;
+			FreeNode(parent);
+		}
+	}
+
+	int DynamicTree::Balance(const int& iA) {
+		if (nodes[iA].IsLeaf() || nodes[iA].height < 2) return iA;
+
+		int iB = nodes[iA].child1;
+		int iC = nodes[iA].child2;
+		int balance = nodes[iC].height - nodes[iB].height;
+
+		// rotate C up
+		if (balance > 1) {
+			int iF = nodes[iC].child1;
+			int iG = nodes[iC].child2;
+
+			// swap A and C
+			nodes[iC].child1 = iA;
+			nodes[iC].parent = nodes[iA].parent;
+			nodes[iA].parent = iC;
+
+			// A's old parent should point to C
+			int p = nodes[iC].parent;
+			if (p != Null) {
+				if (nodes[p].child1 == iA) nodes[p].child1 = iC;
+				else nodes[p].child2 = iC;
+			} else {
+				root = iC;
+			}
+
+			// the taller of F and G stays with C
+			if (nodes[iF].height > nodes[iG].height) {
+				nodes[iC].child2 = iF;
+				nodes[iA].child2 = iG;
+				nodes[iG].parent = iA;
+				nodes[iA].bounds = Math::Bounds3D::Combine(nodes[iB].bounds, nodes[iG].bounds);
+				nodes[iC].bounds = Math::Bounds3D::Combine(nodes[iA].bounds, nodes[iF].bounds);
+				nodes[iA].height = 1 + (nodes[iB].height > nodes[iG].height ? nodes[iB].height : nodes[iG].height);
+				nodes[iC].height = 1 + (nodes[iA].height > nodes[iF].height ? nodes[iA].height : nodes[iF].height);
+			} else {
+				nodes[iC].child2 = iG;
+				nodes[iA].child2 = iF;
+				nodes[iF].parent = iA;
+				nodes[iA].bounds = Math::Bounds3D::Combine(nodes[iB].bounds, nodes[iF].bounds);
+				nodes[iC].bounds = Math::Bounds3D::Combine(nodes[iA].bounds, nodes[iG].bounds);
+				nodes[iA].height = 1 + (nodes[iB].height > nodes[iF].height ? nodes[iB].height : nodes[iF].height);
+				nodes[iC].height = 1 + (nodes[iA].height > nodes[iG].height ? nodes[iA].height : nodes[iG].height);
+			}
+
+			return iC;
+		}
+
+		// rotate B up
+		if (balance < -1) {
+			int iD = nodes[iB].child1;
+			int iE = nodes[iB].child2;
+
+			// swap A and B
+			nodes[iB].child1 = iA;
+			nodes[iB].parent = nodes[iA].parent;
+			nodes[iA].parent = iB;
+
+			// A's old parent should point to B
+			int p = nodes[iB].parent;
+			if (p != Null) {
+				if (nodes[p].child1 == iA) nodes[p].child1 = iB;
+				else nodes[p].child2 = iB;
+			} else {
+				root = iB;
+			}
+
+			// the taller of D and E stays with B
+			if (nodes[iD].height > nodes[iE].height) {
+				nodes[iB].child2 = iD;
+				nodes[iA].child1 = iE;
+				nodes[iE].parent = iA;
+				nodes[iA].bounds = Math::Bounds3D::Combine(nodes[iC].bounds, nodes[iE].bounds);
+				nodes[iB].bounds = Math::Bounds3D::Combine(nodes[iA].bounds, nodes[iD].bounds);
+				nodes[iA].height = 1 + (nodes[iC].height > nodes[iE].height ? nodes[iC].height : nodes[iE].height);
+				nodes[iB].height = 1 + (nodes[iA].height > nodes[iD].height ? nodes[iA].height : nodes[iD].height);
+			} else {
+				nodes[iB].child2 = iE;
+				nodes[iA].child1 = iD;
+				nodes[iD].parent = iA;
+				nodes[iA].bounds = Math::Bounds3D::Combine(nodes[iC].bounds, nodes[iD].bounds);
+				nodes[iB].bounds = Math::Bounds3D::Combine(nodes[iA].bounds, nodes[iE].bounds);
+				nodes[iA].height = 1 + (nodes[iC].height > nodes[iD].height ? nodes[iC].height : nodes[iD].height);
+				nodes[iB].height = 1 + (nodes[iA].height > nodes[iE].height ? nodes[iA].height : nodes[iE].height);
+			}
+
+			return iB;
+		}
+
+		return iA;
+	}
+
+	void DynamicTree::FindPairs(DArray<BodyPair>& pairs) {
+		pairs.clear();
+		if (root == Null) return;
+
+		// query the tree with every non static leaf
+		const int count = static_cast<int>(nodes.size());
+		for (int leaf = 0; leaf < count; ++leaf) {
+			if (nodes[leaf].height != 0 || nodes[leaf].isStatic) continue;
+			const Math::Bounds3D bounds = nodes[leaf].bounds;
+
+			stack.clear();
+			stack.push_back(root);
+			while (!stack.empty()) {
+				int index = stack.back();
+				stack.pop_back();
+
+				const Node& node = nodes[index];
+				if (!Math::Bounds3D::Intersects(node.bounds, bounds)) continue;
+
+				if (node.IsLeaf()) {
+					// two non static leaves would find each other twice so only the lower one reports it
+					if (index == leaf || (!node.isStatic && index < leaf)) continue;
+					pairs.push_back(BodyPair(nodes[leaf].handle, node.handle));
+				} else {
+					stack.push_back(node.child1);
+					stack.push_back(node.child2);
+				}
+			}
+		}
+	}
+
+	void DynamicTree::Query(const Math::Bounds3D& bounds, DArray<BodyHandle>& results) const {
+		results.clear();
+		if (root == Null) return;
+
+		// the tree is kept balanced so a fixed stack on this thread is enough
+		int stack[MaxQueryStack];
+		int top = 0;
+		stack[top++] = root;
+		while (top > 0) {
+			const Node& node = nodes[stack[--top]];
+			if (!Math::Bounds3D::Intersects(node.bounds, bounds)) continue;
+
+			if (node.IsLeaf()) {
+				results.push_back(node.handle);
+			} else {
+				stack[top++] = node.child1;
+				stack[top++] = node.child2;
+			}
+		}
+	}
+
+	void DynamicTree::QueryRay(const Math::Vector3& origin, const Math::Vector3& direction, const float& length, const float& radius,
+							   RayCallback callback, void* data) const {
+		if (root == Null) return;
+
+		Math::Vector3 inverse(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+		float maxLength = length;
+		float distance;
+		if (!Math::Bounds3D::Raycast(Math::Bounds3D::Expand(nodes[root].bounds, radius), origin, inverse, maxLength, distance)) return;
+
+		int stack[MaxQueryStack];
+		int top = 0;
+		stack[top++] = root;
+		while (top > 0) {
+			const Node& node = nodes[stack[--top]];
+
+			if (node.IsLeaf()) {
+				// the ray may have been clipped since this leaf was pushed
+				if (!Math::Bounds3D::Raycast(Math::Bounds3D::Expand(node.bounds, radius), origin, inverse, maxLength, distance)) continue;
+				maxLength = fminf(maxLength, callback(data, node.handle));
+				if (maxLength <= 0.0f) return;
+				continue;
+			}
+
+			// push the nearer child last so it is walked first and clips the ray sooner
+			float d1, d2;
+			bool hit1 = Math::Bounds3D::Raycast(Math::Bounds3D::Expand(nodes[node.child1].bounds, radius), origin, inverse, maxLength, d1);
+			bool hit2 = Math::Bounds3D::Raycast(Math::Bounds3D::Expand(nodes[node.child2].bounds, radius), origin, inverse, maxLength, d2);
+			if (hit1 && hit2) {
+				if (d1 < d2) {
+					stack[top++] = node.child2;
+					stack[top++] = node.child1;
+				} else {
+					stack[top++] = node.child1;
+					stack[top++] = node.child2;
+				}
+			} else if (hit1) {
+				stack[top++] = node.child1;
+			} else if (hit2) {
+				stack[top++] = node.child2;
+			}
+		}
+	}
+
+}
\ No newline at end of file
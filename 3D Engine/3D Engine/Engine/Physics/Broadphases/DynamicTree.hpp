@@ -0,0 +1,86 @@
+#ifndef PHYSICS_DYNAMIC_TREE_HPP
+#define PHYSICS_DYNAMIC_TREE_HPP
+#include "../Broadphase.hpp"
+
+namespace Physics {
+
+	// a bounding volume hierarchy that is updated as bodies move
+	// leaves store fattened bounds so a body only reinserts once it leaves them
+	// and the tree is kept balanced with AVL style rotations
+	class DynamicTree : public Broadphase {
+
+		static const int Null = -1;
+		// the deepest a query can go, the balanced tree never gets close
+		static const int MaxQueryStack = 256;
+
+		struct Node {
+			// the fattened bounds of a leaf or the combined bounds of the children
+			Math::Bounds3D bounds;
+			// the body stored in a leaf
+			BodyHandle handle;
+			// the parent node, or the next free node when this node is unused
+			int parent;
+			int child1, child2;
+			// leaves are 0, free nodes are -1
+			int height;
+			bool isStatic;
+
+			bool IsLeaf() const { return child1 == Null; }
+		};
+
+		DArray<Node> nodes;
+		int root;
+		int freeList;
+
+		// maps a body handle index to its leaf node
+		DArray<int> proxies;
+
+		// how much the leaf bounds are fattened by
+		float margin;
+
+		// reused traversal stack
+		DArray<int> stack;
+
+		int AllocateNode();
+		void FreeNode(const int& node);
+
+		void InsertLeaf(const int& leaf);
+		void RemoveLeaf(const int& leaf);
+
+		// rotates the subtree at node if it is unbalanced and returns the new subtree root
+		int Balance(const int& node);
+
+	public:
+
+		DynamicTree(const float& margin_ = 0.1f);
+		~DynamicTree();
+
+		/// broadphase
+
+		virtual void Insert(const BodyHandle& handle, const Math::Bounds3D& bounds, const bool& isStatic) override;
+		virtual void Remove(const BodyHandle& handle) override;
+		virtual void Move(const BodyHandle& handle, const Math::Bounds3D& bounds) override;
+		virtual void FindPairs(DArray<BodyPair>& pairs) override;
+		virtual void Query(const Math::Bounds3D& bounds, DArray<BodyHandle>& results) const override;
+		virtual void QueryRay(const Math::Vector3& origin, const Math::Vector3& direction, const float& length, const float& radius,
+							  RayCallback callback, void* data) const override;
+
+		/// getters
+
+		float GetMargin() const { return margin; }
+		// the height of the tree, 0 when it has only one leaf
+		int GetHeight() const { return root == Null ? 0 : nodes[root].height; }
+
+		/// setters
+
+		// only affects bodies that are inserted or reinserted after this
+		void SetMargin(const float& margin_) {
+			margin = margin_;
+			if (margin < 0.0f) margin = 0.0f;
+		}
+
+	};
+
+}
+
+#endif // !PHYSICS_DYNAMIC_TREE_HPP
\ No newline at end of file
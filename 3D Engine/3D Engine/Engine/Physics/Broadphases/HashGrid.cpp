@@ -0,0 +1,389 @@
+#include "HashGrid.hpp"
+#include <cmath>
+#include <cstdlib>
+
+namespace Physics {
+
+	const unsigned int HashGrid::Null;
+	const unsigned long long HashGrid::EmptyKey;
+
+	HashGrid::HashGrid(const float& cellSize_, Jobs::JobSystem* jobs_)
+		: freeBox(Null), cellSize(1.0f), inverseCellSize(1.0f), jobs(jobs_) {
+		SetCellSize(cellSize_);
+	}
+
+	HashGrid::~HashGrid() { }
+
+	void HashGrid::Insert(const BodyHandle& handle, const Math::Bounds3D& bounds, const bool& isStatic) {
+		// reuse a free box if there is one
+		unsigned int box;
+		if (freeBox != Null) {
+			box = freeBox;
+			freeBox = boxes[box].next;
+		} else {
+			box = static_cast<unsigned int>(boxes.size());
+			boxes.push_back(Box());
+			packedBounds.push_back(bounds);
+		}
+		boxes[box].bounds = bounds;
+		packedBounds.Set(box, bounds);
+		boxes[box].handle = handle;
+		boxes[box].isStatic = isStatic;
+		boxes[box].used = true;
+		boxes[box].large = false;
+		boxes[box].next = Null;
+
+		if (proxies.size() <= handle.index) proxies.resize(handle.index + 1, Null);
+		proxies[handle.index] = box;
+	}
+
+	void HashGrid::Remove(const BodyHandle& handle) {
+		if (handle.index >= proxies.size()) return;
+		unsigned int box = proxies[handle.index];
+		if (box == Null) return;
+
+		boxes[box].used = false;
+		packedBounds.SetEmpty(box);
+		boxes[box].next = freeBox;
+		freeBox = box;
+		proxies[handle.index] = Null;
+	}
+
+	void HashGrid::Move(const BodyHandle& handle, const Math::Bounds3D& bounds) {
+		// the cells are rebuilt from the boxes every step
+		unsigned int box = proxies[handle.index];
+		boxes[box].bounds = bounds;
+		packedBounds.Set(box, bounds);
+	}
+
+	unsigned int HashGrid::FindOrAddCell(const unsigned long long& key) {
+		// hash the key and linear probe
+		unsigned long long h = key;
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		size_t mask = tableKeys.size() - 1;
+		size_t i = static_cast<size_t>(h) & mask;
+		while (tableKeys[i] != EmptyKey) {
+			if (tableKeys[i] == key) return tableCells[i];
+			i = (i + 1) & mask;
+		}
+
+		// add a new empty cell
+		unsigned int cell = static_cast<unsigned int>(cellCounts.size());
+		tableKeys[i] = key;
+		tableCells[i] = cell;
+		cellKeys.push_back(key);
+		cellCounts.push_back(0);
+		return cell;
+	}
+
+	unsigned int HashGrid::FindCell(const unsigned long long& key) const {
+		if (tableKeys.empty()) return Null;
+
+		unsigned long long h = key;
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		size_t mask = tableKeys.size() - 1;
+		size_t i = static_cast<size_t>(h) & mask;
+		while (tableKeys[i] != EmptyKey) {
+			if (tableKeys[i] == key) return tableCells[i];
+			i = (i + 1) & mask;
+		}
+		return Null;
+	}
+
+	void HashGrid::BuildCells() {
+		cellKeys.clear();
+		cellCounts.clear();
+		entries.clear();
+		largeBoxes.clear();
+
+		// count the cells each box touches to size the table
+		// boxes that cover too many cells are handled separately
+		size_t touches = 0;
+		const unsigned int boxCount = static_cast<unsigned int>(boxes.size());
+		for (unsigned int box = 0; box < boxCount; ++box) {
+			Box& b = boxes[box];
+			if (!b.used) continue;
+
+			long long cells = static_cast<long long>(CellCoord(b.bounds.max.x) - CellCoord(b.bounds.min.x) + 1)
+				* (CellCoord(b.bounds.max.y) - CellCoord(b.bounds.min.y) + 1)
+				* (CellCoord(b.bounds.max.z) - CellCoord(b.bounds.min.z) + 1);
+
+			b.large = cells > MaxCellsPerBox;
+			if (b.large) largeBoxes.push_back(box);
+			else touches += static_cast<size_t>(cells);
+		}
+
+		// keep the table at most half full
+		size_t capacity = 64;
+		while (capacity < touches * 2)
+			capacity *= 2;
+		tableKeys.resize(capacity);
+		tableCells.resize(capacity);
+		tableKeys.fill(EmptyKey);
+
+		// add every box to the cells it touches and count the boxes per cell
+		for (unsigned int box = 0; box < boxCount; ++box) {
+			const Box& b = boxes[box];
+			if (!b.used || b.large) continue;
+
+			int x0 = CellCoord(b.bounds.min.x), x1 = CellCoord(b.bounds.max.x);
+			int y0 = CellCoord(b.bounds.min.y), y1 = CellCoord(b.bounds.max.y);
+			int z0 = CellCoord(b.bounds.min.z), z1 = CellCoord(b.bounds.max.z);
+
+			for (int z = z0; z <= z1; ++z)
+				for (int y = y0; y <= y1; ++y)
+					for (int x = x0; x <= x1; ++x) {
+						CellEntry entry;
+						entry.cell = FindOrAddCell(CellKey(x, y, z));
+						entry.box = box;
+						entries.push_back(entry);
+						++cellCounts[entry.cell];
+					}
+		}
+
+		// turn the counts into start offsets
+		const size_t cellCount = cellCounts.size();
+		cellStarts.resize(cellCount);
+		unsigned int start = 0;
+		for (size_t c = 0; c < cellCount; ++c) {
+			cellStarts[c] = start;
+			start += cellCounts[c];
+			cellCounts[c] = 0;
+		}
+
+		// put the boxes in their cells
+		cellBoxes.resize(entries.size());
+		for (const CellEntry& entry : entries)
+			cellBoxes[cellStarts[entry.cell] + cellCounts[entry.cell]++] = entry.box;
+	}
+
+	void HashGrid::FindPairsInCells(const unsigned int& begin, const unsigned int& end, DArray<BodyPair>& pairs) const {
+		for (unsigned int c = begin; c < end; ++c) {
+			const unsigned int* cell = cellBoxes.data() + cellStarts[c];
+			const unsigned int count = cellCounts[c];
+			if (count < 2) continue;
+
+			for (unsigned int i = 0; i < count; ++i) {
+				const Box& a = boxes[cell[i]];
+
+				for (unsigned int j = i + 1; j < count; ++j) {
+					const Box& b = boxes[cell[j]];
+					if (a.isStatic && b.isStatic) continue;
+					if (!Math::Bounds3D::Intersects(a.bounds, b.bounds)) continue;
+
+					// two boxes can share many cells, only the cell with the min of the overlap reports them
+					int x = CellCoord(fmaxf(a.bounds.min.x, b.bounds.min.x));
+					int y = CellCoord(fmaxf(a.bounds.min.y, b.bounds.min.y));
+					int z = CellCoord(fmaxf(a.bounds.min.z, b.bounds.min.z));
+					if (cellKeys[c] != CellKey(x, y, z)) continue;
+
+					pairs.push_back(BodyPair(a.handle, b.handle));
+				}
+			}
+		}
+	}
+
+	void HashGrid::FindLargePairs(DArray<BodyPair>& pairs) const {
+		DArray<unsigned int> hits;
+		for (size_t l = 0; l < largeBoxes.size(); ++l) {
+			const unsigned int large = largeBoxes[l];
+			const Box& a = boxes[large];
+
+			// test against every box at once, only the overlaps are looked at after
+			hits.clear();
+			Math::Overlap(a.bounds, packedBounds, hits);
+			for (size_t h = 0; h < hits.size(); ++h) {
+				const unsigned int box = hits[h];
+				const Box& b = boxes[box];
+				if (!b.used || box == large) continue;
+				if (a.isStatic && b.isStatic) continue;
+
+				// two large boxes would find each other twice so only the lower one reports it
+				if (box < large && b.large) continue;
+
+				pairs.push_back(BodyPair(a.handle, b.handle));
+			}
+		}
+	}
+
+	void HashGrid::Query(const Math::Bounds3D& bounds, DArray<BodyHandle>& results) const {
+		results.clear();
+
+		// boxes that are too big for the grid are always tested
+		for (size_t l = 0; l < largeBoxes.size(); ++l) {
+			const Box& b = boxes[largeBoxes[l]];
+			if (b.used && Math::Bounds3D::Intersects(b.bounds, bounds))
+				results.push_back(b.handle);
+		}
+
+		int x0 = CellCoord(bounds.min.x), x1 = CellCoord(bounds.max.x);
+		int y0 = CellCoord(bounds.min.y), y1 = CellCoord(bounds.max.y);
+		int z0 = CellCoord(bounds.min.z), z1 = CellCoord(bounds.max.z);
+		long long cells = static_cast<long long>(x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+
+		// a query over lots of cells tests every box instead
+		if (cells > MaxCellsPerBox) {
+			DArray<unsigned int> hits;
+			Math::Overlap(bounds, packedBounds, hits);
+			for (size_t h = 0; h < hits.size(); ++h) {
+				const Box& b = boxes[hits[h]];
+				if (b.used && !b.large) results.push_back(b.handle);
+			}
+			return;
+		}
+
+		for (int x = x0; x <= x1; ++x) {
+			for (int y = y0; y <= y1; ++y) {
+				for (int z = z0; z <= z1; ++z) {
+					unsigned long long key = CellKey(x, y, z);
+					unsigned int c = FindCell(key);
+					if (c == Null) continue;
+
+					const unsigned int* cell = cellBoxes.data() + cellStarts[c];
+					for (unsigned int i = 0; i < cellCounts[c]; ++i) {
+						const Box& b = boxes[cell[i]];
+						if (!b.used || !Math::Bounds3D::Intersects(b.bounds, bounds)) continue;
+
+						// a box in many cells is only reported by the cell with the min of the overlap
+						int cx = CellCoord(fmaxf(b.bounds.min.x, bounds.min.x));
+						int cy = CellCoord(fmaxf(b.bounds.min.y, bounds.min.y));
+						int cz = CellCoord(fmaxf(b.bounds.min.z, bounds.min.z));
+						if (key != CellKey(cx, cy, cz)) continue;
+
+						results.push_back(b.handle);
+					}
+				}
+			}
+		}
+	}
+
+	void HashGrid::QueryRay(const Math::Vector3& origin, const Math::Vector3& direction, const float& length, const float& radius,
+							RayCallback callback, void* data) const {
+		Math::Vector3 inverse(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+		float maxLength = length;
+		float distance;
+
+		// boxes that are too big for the grid are always tested
+		for (size_t l = 0; l < largeBoxes.size(); ++l) {
+			const Box& b = boxes[largeBoxes[l]];
+			if (!b.used || !Math::Bounds3D::Raycast(Math::Bounds3D::Expand(b.bounds, radius), origin, inverse, maxLength, distance)) continue;
+
+			maxLength = fminf(maxLength, callback(data, b.handle));
+			if (maxLength <= 0.0f) return;
+		}
+
+		// a box within radius of the ray is in the ring of cells around a cell the ray passes through
+		int ring = static_cast<int>(ceilf(radius * inverseCellSize));
+		int cell[3] = { CellCoord(origin.x), CellCoord(origin.y), CellCoord(origin.z) };
+		Math::Vector3 end = origin + direction * maxLength;
+		long long steps = static_cast<long long>(abs(CellCoord(end.x) - cell[0]) + abs(CellCoord(end.y) - cell[1]) + abs(CellCoord(end.z) - cell[2]) + 1);
+		long long side = 2 * ring + 1;
+
+		// a long ray or a wide sphere tests every box instead
+		if (steps * side * side * side > static_cast<long long>(boxes.size())) {
+			for (const Box& b : boxes) {
+				if (!b.used || b.large) continue;
+				if (!Math::Bounds3D::Raycast(Math::Bounds3D::Expand(b.bounds, radius), origin, inverse, maxLength, distance)) continue;
+
+				maxLength = fminf(maxLength, callback(data, b.handle));
+				if (maxLength <= 0.0f) return;
+			}
+			return;
+		}
+
+		// walk the cells the ray passes through in order
+		int step[3];
+		float next[3], delta[3];
+		for (int axis = 0; axis < 3; ++axis) {
+			if (direction[axis] > 0.0f) {
+				step[axis] = 1;
+				next[axis] = ((cell[axis] + 1) * cellSize - origin[axis]) * inverse[axis];
+				delta[axis] = cellSize * inverse[axis];
+			} else if (direction[axis] < 0.0f) {
+				step[axis] = -1;
+				next[axis] = (cell[axis] * cellSize - origin[axis]) * inverse[axis];
+				delta[axis] = -cellSize * inverse[axis];
+			} else {
+				step[axis] = 0;
+				next[axis] = INFINITY;
+				delta[axis] = 0.0f;
+			}
+		}
+
+		// the ray is in the current cell from enter to exit
+		float enter = 0.0f;
+		while (true) {
+			int axis = next[0] < next[1] ? (next[0] < next[2] ? 0 : 2) : (next[1] < next[2] ? 1 : 2);
+			float exit = next[axis];
+
+			for (int z = cell[2] - ring; z <= cell[2] + ring; ++z) {
+				for (int y = cell[1] - ring; y <= cell[1] + ring; ++y) {
+					for (int x = cell[0] - ring; x <= cell[0] + ring; ++x) {
+						unsigned int c = FindCell(CellKey(x, y, z));
+						if (c == Null) continue;
+
+						const unsigned int* boxesInCell = cellBoxes.data() + cellStarts[c];
+						for (unsigned int i = 0; i < cellCounts[c]; ++i) {
+							const Box& b = boxes[boxesInCell[i]];
+							if (!b.used) continue;
+
+							// a box in many cells of the ring is only reported by the lowest of them
+							int bx = CellCoord(b.bounds.min.x), by = CellCoord(b.bounds.min.y), bz = CellCoord(b.bounds.min.z);
+							if (x != (bx > cell[0] - ring ? bx : cell[0] - ring)) continue;
+							if (y != (by > cell[1] - ring ? by : cell[1] - ring)) continue;
+							if (z != (bz > cell[2] - ring ? bz : cell[2] - ring)) continue;
+
+							if (!Math::Bounds3D::Raycast(Math::Bounds3D::Expand(b.bounds, radius), origin, inverse, maxLength, distance)) continue;
+
+							// and a box near many cells of the ray is only reported by the cell the ray reaches it in
+							if (distance < enter || (distance >= exit && exit < maxLength)) continue;
+
+							maxLength = fminf(maxLength, callback(data, b.handle));
+							if (maxLength <= 0.0f) return;
+						}
+					}
+				}
+			}
+
+			if (exit >= maxLength) return;
+			cell[axis] += step[axis];
+			next[axis] += delta[axis];
+			enter = exit;
+		}
+	}
+
+	void HashGrid::FindPairs(DArray<BodyPair>& pairs) {
+		pairs.clear();
+		BuildCells();
+
+		const unsigned int cellCount = static_cast<unsigned int>(cellCounts.size());
+
+		// not worth splitting small grids
+		unsigned int chunks = cellCount / CellsPerChunk;
+		if (!jobs || jobs->GetThreadCount() == 1 || chunks < 2) {
+			FindPairsInCells(0, cellCount, pairs);
+		} else {
+			// every chunk writes to its own list of pairs
+			chunkPairs.resize(chunks);
+			jobs->ParallelFor(chunks, 1, [this, chunks, cellCount](size_t begin, size_t end) {
+				for (size_t c = begin; c < end; ++c) {
+					chunkPairs[c].clear();
+					FindPairsInCells(static_cast<unsigned int>(cellCount * c / chunks),
+									 static_cast<unsigned int>(cellCount * (c + 1) / chunks), chunkPairs[c]);
+				}
+			});
+
+			// add the pairs in chunk order so the result does not depend on the threads
+			for (unsigned int c = 0; c < chunks; ++c)
+				for (const BodyPair& pair : chunkPairs[c])
+					pairs.push_back(pair);
+		}
+
+		FindLargePairs(pairs);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#ifndef PHYSICS_HASH_GRID_HPP
+#define PHYSICS_HASH_GRID_HPP
+#include "../Broadphase.hpp"
+#include "../../Math/BoundsBatch.hpp"
+#include "../../Jobs/JobSystem.hpp"
+
+namespace Physics {
+
+	// a uniform grid of cells stored in an open addressed hash table
+	// the table is rebuilt every step, every body is added to each cell its bounds touch
+	// works best when most bodies are about the size of a cell
+	class HashGrid : public Broadphase {
+
+		static const unsigned int Null = 0xffffffff;
+		static const unsigned long long EmptyKey = 0xffffffffffffffffULL;
+
+		// bodies that touch more cells than this are tested against everything instead
+		static const int MaxCellsPerBox = 64;
+
+		struct Box {
+			Math::Bounds3D bounds;
+			BodyHandle handle;
+			// the next free box when unused
+			unsigned int next;
+			bool isStatic;
+			bool used;
+			// the box touches too many cells to go in the grid
+			bool large;
+		};
+
+		// a box in a cell, used while building the cells
+		struct CellEntry {
+			unsigned int cell;
+			unsigned int box;
+		};
+
+		DArray<Box> boxes;
+		unsigned int freeBox;
+		// the bounds of every box again, packed for the batch overlap tests against large boxes
+		// unused boxes are empty so they never overlap
+		Math::PackedBounds3D packedBounds;
+
+		// maps a body handle index to its box
+		DArray<unsigned int> proxies;
+
+		/// cells
+		float cellSize;
+		float inverseCellSize;
+		DArray<unsigned long long> cellKeys;
+		DArray<unsigned int> cellStarts;
+		DArray<unsigned int> cellCounts;
+		// the boxes in each cell, cell c uses [cellStarts[c], cellStarts[c] + cellCounts[c])
+		DArray<unsigned int> cellBoxes;
+		DArray<CellEntry> entries;
+
+		// boxes that are too big for the grid
+		DArray<unsigned int> largeBoxes;
+
+		/// the hash table from cell key to cell index
+		DArray<unsigned long long> tableKeys;
+		DArray<unsigned int> tableCells;
+
+		/// threading
+		// the cells are split into chunks that each find their own pairs
+		static const unsigned int CellsPerChunk = 256;
+		Jobs::JobSystem* jobs;
+		DArray<DArray<BodyPair>> chunkPairs;
+
+		// the cell coordinate that a position is in
+		int CellCoord(const float& value) const {
+			return static_cast<int>(floorf(value * inverseCellSize));
+		}
+
+		// packs 3 cell coordinates into one key
+		static unsigned long long CellKey(const int& x, const int& y, const int& z) {
+			return (static_cast<unsigned long long>(x & 0x1fffff))
+				| (static_cast<unsigned long long>(y & 0x1fffff) << 21)
+				| (static_cast<unsigned long long>(z & 0x1fffff) << 42);
+		}
+
+		// finds the cell index for the key, adding a new cell if it is not in the table
+		unsigned int FindOrAddCell(const unsigned long long& key);
+
+		// finds the cell index for the key, Null if the cell is empty
+		unsigned int FindCell(const unsigned long long& key) const;
+
+		// sorts every box into the cells its bounds touch
+		void BuildCells();
+
+		// finds the pairs in cells [begin, end)
+		void FindPairsInCells(const unsigned int& begin, const unsigned int& end, DArray<BodyPair>& pairs) const;
+
+		// finds the pairs that include a large box
+		void FindLargePairs(DArray<BodyPair>& pairs) const;
+
+	public:
+
+		// jobs can be nullptr to find the pairs on the calling thread
+		HashGrid(const float& cellSize_ = 1.0f, Jobs::JobSystem* jobs_ = nullptr);
+		~HashGrid();
+
+		/// broadphase
+
+		virtual void Insert(const BodyHandle& handle, const Math::Bounds3D& bounds, const bool& isStatic) override;
+		virtual void Remove(const BodyHandle& handle) override;
+		virtual void Move(const BodyHandle& handle, const Math::Bounds3D& bounds) override;
+		virtual void FindPairs(DArray<BodyPair>& pairs) override;
+		virtual void Query(const Math::Bounds3D& bounds, DArray<BodyHandle>& results) const override;
+		virtual void QueryRay(const Math::Vector3& origin, const Math::Vector3& direction, const float& length, const float& radius,
+							  RayCallback callback, void* data) const override;
+
+		/// getters
+
+		float GetCellSize() const { return cellSize; }
+		Jobs::JobSystem* GetJobSystem() const { return jobs; }
+		// the number of cells that had bodies in them in the last step
+		size_t GetCellCount() const { return cellCounts.size(); }
+
+		/// setters
+
+		void SetCellSize(const float& cellSize_) {
+			cellSize = cellSize_;
+			if (cellSize <= 0.0001f) cellSize = 0.0001f;
+			inverseCellSize = 1.0f / cellSize;
+		}
+		void SetJobSystem(Jobs::JobSystem* jobs_) { jobs = jobs_; }
+
+	};
+
+}
+
+#endif // !PHYSICS_HASH_GRID_HPP
\ No newline at end of file
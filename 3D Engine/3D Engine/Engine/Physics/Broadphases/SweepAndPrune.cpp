@@ -0,0 +1,256 @@
+#include "SweepAndPrune.hpp"
+#include <cmath>
+
+namespace Physics {
+
+	const unsigned int SweepAndPrune::Null;
+
+	SweepAndPrune::SweepAndPrune(const int& axisCount_) : freeBox(Null), axisCount(axisCount_), maxWidth(0.0f), stamp(0) {
+		if (axisCount != 1) axisCount = 3;
+	}
+
+	SweepAndPrune::~SweepAndPrune() { }
+
+	void SweepAndPrune::Insert(const BodyHandle& handle, const Math::Bounds3D& bounds, const bool& isStatic) {
+		// reuse a free box if there is one
+		unsigned int box;
+		if (freeBox != Null) {
+			box = freeBox;
+			freeBox = boxes[box].next;
+		} else {
+			box = static_cast<unsigned int>(boxes.size());
+			boxes.push_back(Box());
+		}
+		boxes[box].bounds = bounds;
+		boxes[box].handle = handle;
+		boxes[box].isStatic = isStatic;
+		boxes[box].next = Null;
+
+		if (proxies.size() <= handle.index) proxies.resize(handle.index + 1, Null);
+		proxies[handle.index] = box;
+
+		// add the endpoints to the end, the next sort moves them into place
+		for (int axis = 0; axis < axisCount; ++axis) {
+			Endpoint min, max;
+			min.value = bounds.min[axis];
+			min.data = box << 1;
+			max.value = bounds.max[axis];
+			max.data = (box << 1) | 1;
+			endpoints[axis].push_back(min);
+			endpoints[axis].push_back(max);
+		}
+	}
+
+	void SweepAndPrune::Remove(const BodyHandle& handle) {
+		if (handle.index >= proxies.size()) return;
+		unsigned int box = proxies[handle.index];
+		if (box == Null) return;
+
+		// take the endpoints out of each axis
+		for (int axis = 0; axis < axisCount; ++axis) {
+			DArray<Endpoint>& ep = endpoints[axis];
+			size_t write = 0;
+			for (size_t read = 0; read < ep.size(); ++read)
+				if (ep[read].GetBox() != box)
+					ep[write++] = ep[read];
+			ep.resize(write);
+		}
+
+		// remove every pair the box was in
+		for (size_t i = pairs.size(); i-- > 0;)
+			if (pairs[i].a.index == handle.index || pairs[i].b.index == handle.index)
+				RemovePairAt(static_cast<unsigned int>(i));
+
+		boxes[box].next = freeBox;
+		freeBox = box;
+		proxies[handle.index] = Null;
+	}
+
+	void SweepAndPrune::Query(const Math::Bounds3D& bounds, DArray<BodyHandle>& results) const {
+		results.clear();
+
+		// walk the sorted x axis until the boxes start past the query
+		const DArray<Endpoint>& ep = endpoints[0];
+		for (size_t i = FirstEndpoint(bounds.min.x); i < ep.size(); ++i) {
+			if (ep[i].value > bounds.max.x) break;
+			if (ep[i].IsMax()) continue;
+
+			const Box& box = boxes[ep[i].GetBox()];
+			if (Math::Bounds3D::Intersects(box.bounds, bounds))
+				results.push_back(box.handle);
+		}
+	}
+
+	void SweepAndPrune::QueryRay(const Math::Vector3& origin, const Math::Vector3& direction, const float& length, const float& radius,
+								 RayCallback callback, void* data) const {
+		Math::Vector3 inverse(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+		float maxLength = length;
+		float distance;
+
+		// walk the sorted x axis until the boxes start past the end of the ray
+		const DArray<Endpoint>& ep = endpoints[0];
+		for (size_t i = FirstEndpoint(fminf(origin.x, origin.x + direction.x * length) - radius); i < ep.size(); ++i) {
+			float maxX = fmaxf(origin.x, origin.x + direction.x * maxLength) + radius;
+			if (ep[i].value > maxX) break;
+			if (ep[i].IsMax()) continue;
+
+			const Box& box = boxes[ep[i].GetBox()];
+			if (!Math::Bounds3D::Raycast(Math::Bounds3D::Expand(box.bounds, radius), origin, inverse, maxLength, distance)) continue;
+
+			maxLength = fminf(maxLength, callback(data, box.handle));
+			if (maxLength <= 0.0f) return;
+		}
+	}
+
+	size_t SweepAndPrune::FirstEndpoint(const float& value) const {
+		// no box is wider than maxWidth so one that reaches value starts after value - maxWidth
+		float start = value - maxWidth;
+		const DArray<Endpoint>& ep = endpoints[0];
+		size_t lo = 0, hi = ep.size();
+		while (lo < hi) {
+			size_t mid = (lo + hi) / 2;
+			if (ep[mid].value < start) lo = mid + 1;
+			else hi = mid;
+		}
+		return lo;
+	}
+
+	void SweepAndPrune::Move(const BodyHandle& handle, const Math::Bounds3D& bounds) {
+		// the endpoint values are refreshed from the box before sorting
+		boxes[proxies[handle.index]].bounds = bounds;
+	}
+
+	void SweepAndPrune::AddPair(const unsigned int& a, const unsigned int& b) {
+		const Box& boxA = boxes[a];
+		const Box& boxB = boxes[b];
+		if (boxA.isStatic && boxB.isStatic) return;
+
+		BodyPair pair(boxA.handle, boxB.handle);
+		unsigned long long key = pair.Key();
+		if (unsigned int* index = pairIndices.find(key)) {
+			pairStamps[*index] = stamp;
+			return;
+		}
+
+		pairIndices.insert(key, static_cast<unsigned int>(pairs.size()));
+		pairs.push_back(pair);
+		pairStamps.push_back(stamp);
+		added.push_back(pair);
+	}
+
+	void SweepAndPrune::RemovePair(const unsigned int& a, const unsigned int& b) {
+		unsigned long long key = BodyPair(boxes[a].handle, boxes[b].handle).Key();
+		// copy the index out since removing changes the map
+		if (unsigned int* index = pairIndices.find(key)) {
+			unsigned int i = *index;
+			RemovePairAt(i);
+		}
+	}
+
+	void SweepAndPrune::RemovePairAt(const unsigned int& index) {
+		removed.push_back(pairs[index]);
+		pairIndices.erase(pairs[index].Key());
+
+		// the last pair moves into this ones place
+		unsigned int last = static_cast<unsigned int>(pairs.size() - 1);
+		if (index != last) pairIndices.insert(pairs[last].Key(), index);
+		pairs.swap_remove(index);
+		pairStamps.swap_remove(index);
+	}
+
+	void SweepAndPrune::SortAxis(const int& axis, const bool& track) {
+		DArray<Endpoint>& ep = endpoints[axis];
+		const size_t count = ep.size();
+
+		// refresh the values from the boxes
+		for (size_t i = 0; i < count; ++i) {
+			const Math::Bounds3D& b = boxes[ep[i].GetBox()].bounds;
+			ep[i].value = ep[i].IsMax() ? b.max[axis] : b.min[axis];
+		}
+
+		if (axis == 0) {
+			maxWidth = 0.0f;
+			for (size_t i = 0; i < count; ++i)
+				if (!ep[i].IsMax()) {
+					const Math::Bounds3D& b = boxes[ep[i].GetBox()].bounds;
+					maxWidth = fmaxf(maxWidth, b.max.x - b.min.x);
+				}
+		}
+
+		// insertion sort, every swap is two endpoints passing each other
+		for (size_t i = 1; i < count; ++i) {
+			Endpoint e = ep[i];
+			size_t j = i;
+			while (j > 0 && e.Before(ep[j - 1])) {
+				const Endpoint& o = ep[j - 1];
+
+				if (track) {
+					if (!e.IsMax() && o.IsMax()) {
+						// a min passed a max, the boxes might overlap now
+						if (Math::Bounds3D::Intersects(boxes[e.GetBox()].bounds, boxes[o.GetBox()].bounds))
+							AddPair(e.GetBox(), o.GetBox());
+					} else if (e.IsMax() && !o.IsMax()) {
+						// a max passed a min, the boxes are apart on this axis
+						RemovePair(e.GetBox(), o.GetBox());
+					}
+				}
+
+				ep[j] = o;
+				--j;
+			}
+			ep[j] = e;
+		}
+	}
+
+	void SweepAndPrune::Sweep() {
+		++stamp;
+		active.clear();
+
+		// walk along the first axis keeping a list of the open boxes
+		DArray<Endpoint>& ep = endpoints[0];
+		const size_t count = ep.size();
+		for (size_t i = 0; i < count; ++i) {
+			unsigned int box = ep[i].GetBox();
+
+			if (ep[i].IsMax()) {
+				// close the box
+				unsigned int slot = boxes[box].next;
+				boxes[active.back()].next = slot;
+				active.swap_remove(slot);
+				continue;
+			}
+
+			// every open box overlaps on this axis so only the other axes need checking
+			const Math::Bounds3D& bounds = boxes[box].bounds;
+			for (size_t a = 0; a < active.size(); ++a)
+				if (Math::Bounds3D::Intersects(boxes[active[a]].bounds, bounds))
+					AddPair(active[a], box);
+
+			boxes[box].next = static_cast<unsigned int>(active.size());
+			active.push_back(box);
+		}
+
+		// any pair that was not found this step stopped overlapping
+		for (size_t i = pairs.size(); i-- > 0;)
+			if (pairStamps[i] != stamp)
+				RemovePairAt(static_cast<unsigned int>(i));
+	}
+
+	void SweepAndPrune::FindPairs(DArray<BodyPair>& pairs_) {
+		// the events only cover one step so they don't grow forever
+		added.clear();
+		removed.clear();
+
+		if (axisCount == 3) {
+			// pairs are kept up to date by the swaps
+			for (int axis = 0; axis < 3; ++axis)
+				SortAxis(axis, true);
+		} else {
+			SortAxis(0, false);
+			Sweep();
+		}
+
+		pairs_ = pairs;
+	}
+
+}
\ No newline at end of file
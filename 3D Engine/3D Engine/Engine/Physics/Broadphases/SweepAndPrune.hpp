@@ -0,0 +1,110 @@
+#ifndef PHYSICS_SWEEP_AND_PRUNE_HPP
+#define PHYSICS_SWEEP_AND_PRUNE_HPP
+#include "../Broadphase.hpp"
+#include "../../Containers/HashMap.hpp"
+
+namespace Physics {
+
+	// keeps the min and max of every body sorted along one or three axes
+	// the endpoints are re-sorted with insertion sort every step which is close to linear
+	// when bodies only move a little between steps
+	// with 3 axes pairs are added and removed as endpoints swap,
+	// with 1 axis it is swept each step and the pairs are compared to the last steps pairs
+	class SweepAndPrune : public Broadphase {
+
+		static const unsigned int Null = 0xffffffff;
+
+		struct Box {
+			Math::Bounds3D bounds;
+			BodyHandle handle;
+			// the index in the active list while sweeping, or the next free box when unused
+			unsigned int next;
+			bool isStatic;
+		};
+
+		// a min or max of a box on one axis
+		struct Endpoint {
+			float value;
+			// the box index shifted up by one, the low bit is set for a max
+			unsigned int data;
+
+			unsigned int GetBox() const { return data >> 1; }
+			bool IsMax() const { return (data & 1) != 0; }
+			// mins go before maxes at the same value so boxes that touch overlap like in Bounds3D::Intersects
+			bool Before(const Endpoint& other) const {
+				return value < other.value || (value == other.value && !IsMax() && other.IsMax());
+			}
+		};
+
+		DArray<Box> boxes;
+		unsigned int freeBox;
+
+		// maps a body handle index to its box
+		DArray<unsigned int> proxies;
+
+		// the sorted endpoints for each axis
+		DArray<Endpoint> endpoints[3];
+		int axisCount;
+		// the widest box on the first axis when it was last sorted
+		// queries start at the first min that could reach them instead of the start of the axis
+		float maxWidth;
+
+		/// pairs
+		DArray<BodyPair> pairs;
+		DArray<unsigned int> pairStamps;
+		HashMap<unsigned long long, unsigned int> pairIndices;
+		unsigned int stamp;
+
+		/// pair events from the last FindPairs
+		DArray<BodyPair> added;
+		DArray<BodyPair> removed;
+
+		// reused list of boxes that are open while sweeping
+		DArray<unsigned int> active;
+
+		// adds the pair if it is new, otherwise marks it as found this step
+		void AddPair(const unsigned int& a, const unsigned int& b);
+		void RemovePair(const unsigned int& a, const unsigned int& b);
+		void RemovePairAt(const unsigned int& index);
+
+		// insertion sorts one axis, reporting pairs as endpoints pass each other when tracking
+		void SortAxis(const int& axis, const bool& track);
+
+		// sweeps the first axis and finds every pair
+		void Sweep();
+
+		// the first endpoint on the first axis that a box overlapping value could start at
+		size_t FirstEndpoint(const float& value) const;
+
+	public:
+
+		// axisCount_ is how many axes to keep sorted, 1 or 3
+		SweepAndPrune(const int& axisCount_ = 3);
+		~SweepAndPrune();
+
+		/// broadphase
+
+		virtual void Insert(const BodyHandle& handle, const Math::Bounds3D& bounds, const bool& isStatic) override;
+		virtual void Remove(const BodyHandle& handle) override;
+		virtual void Move(const BodyHandle& handle, const Math::Bounds3D& bounds) override;
+		virtual void FindPairs(DArray<BodyPair>& pairs_) override;
+		virtual void Query(const Math::Bounds3D& bounds, DArray<BodyHandle>& results) const override;
+		virtual void QueryRay(const Math::Vector3& origin, const Math::Vector3& direction, const float& length, const float& radius,
+							  RayCallback callback, void* data) const override;
+
+		/// pair events
+
+		// the pairs that started overlapping in the last FindPairs
+		const DArray<BodyPair>& GetAddedPairs() const { return added; }
+		// the pairs that stopped overlapping in the last FindPairs and any removed with a body after it
+		const DArray<BodyPair>& GetRemovedPairs() const { return removed; }
+
+		/// getters
+
+		int GetAxisCount() const { return axisCount; }
+
+	};
+
+}
+
+#endif // !PHYSICS_SWEEP_AND_PRUNE_HPP
\ No newline at end of file
@@ -1,19 +1,36 @@
 #include "Collider.hpp"
 #include "Body.hpp"
+#include "Colliders/SphereCollider.hpp"
 
 namespace Physics {
 
-	void Collider::UpdateBounds() { 
-		// call update bounds on the body
+	void Collider::UpdateBounds() {
+		// not attached yet, the body copies the collider in when it is attached
+		if (!body) return;
+
+		BodyStorage& storage = *body->storage;
+		unsigned int i = body->Index();
+		switch (shape) {
+			case CollisionShape::Sphere:
+				storage.spheres.Set(storage.shapeSlots[i], local.GetPosition(), storage.rotations[i], static_cast<const SphereColldier*>(this)->GetRadius());
+				break;
+			default:
+				break;
+		}
+
 		body->UpdateBounds();
 	}
 
+	Math::Transform Collider::GetWorldTransform() const {
+		return body->GetTransform() * local;
+	}
+
 	Math::Vector3 Collider::GetWorldPosition() const {
-		return position + body->GetPosition();
+		return body->GetTransform().TransformPoint(local.GetPosition());
 	}
 
-	Math::Vector3 Collider::GetWorldRotation() const {
-		return rotation + body->GetRotation();
+	Math::Quaternion Collider::GetWorldRotation() const {
+		return body->GetRotation() * local.GetRotation();
 	}
 
 }
\ No newline at end of file
@@ -2,33 +2,42 @@
 #define PHYSICS_COLLIDER_HPP
 #include "../Math/Vector.hpp"
 #include "../Math/Bounds.hpp"
+#include "../Math/Quaternion.hpp"
+#include "../Math/Transform.hpp"
+#include <cstddef>
 
 namespace Physics {
 
 	class Body;
+	class World;
 
-	enum class CollisionShape : unsigned char { None, Sphere };
+	enum class CollisionShape : unsigned char { None, Sphere, Count };
+
+	// the number of collision shapes
+	static const size_t CollisionShapeCount = static_cast<size_t>(CollisionShape::Count);
 
 	class Collider {
 	protected:
 		friend Body;
+		friend World;
 
 		// the body that the collider is attached to
 		Body* body;
 
-		/// position and rotation relative to the bodies position
-		Math::Vector3 position;
-		Math::Vector3 rotation;
+		// the shape, set once by the derived collider
+		CollisionShape shape;
 
-		// called from body to update bounds
-		virtual Math::Bounds3D GetBounds(const Math::Vector3& bodyPos, const Math::Vector3& bodyRot) = 0;
+		// position and rotation relative to the body
+		Math::Transform local;
 
-		// called by the collider to update the bounds in the body
+		// copies the collider into the shape table of the body's storage and marks the bounds dirty
+		// called by the collider whenever one of its values changes
 		void UpdateBounds();
 
+		Collider(const CollisionShape& shape_) : body(nullptr), shape(shape_), local() { }
+
 	public:
 
-		Collider() : body(nullptr), position(0.0f), rotation(0.0f) { }
 		virtual ~Collider() = 0 { }
 
 		/// getters
@@ -36,16 +45,19 @@ namespace Physics {
 		Body* GetBody() const { return body; }
 		template<typename B>
 		B* GetBody() const { return static_cast<B*>(body); }
-		Math::Vector3 GetPosition() const { return position; }
-		Math::Vector3 GetRotation() const { return rotation; }
+		Math::Vector3 GetPosition() const { return local.GetPosition(); }
+		Math::Quaternion GetRotation() const { return local.GetRotation(); }
+		const Math::Transform& GetLocalTransform() const { return local; }
+		// the body's transform composed with the collider's
+		Math::Transform GetWorldTransform() const;
 		Math::Vector3 GetWorldPosition() const;
-		Math::Vector3 GetWorldRotation() const;
-		virtual CollisionShape GetCollisionShape() const = 0 { return CollisionShape::None; }
+		Math::Quaternion GetWorldRotation() const;
+		CollisionShape GetCollisionShape() const { return shape; }
 
 		/// setters
 
-		void SetPosition(const Math::Vector3& position_) { position = position_; }
-		void SetRotation(const Math::Vector3& rotation_) { rotation = rotation_; }
+		void SetPosition(const Math::Vector3& position_) { local.SetPosition(position_); UpdateBounds(); }
+		void SetRotation(const Math::Quaternion& rotation_) { local.SetRotation(rotation_); UpdateBounds(); }
 
 
 	};
@@ -0,0 +1,83 @@
+#ifndef PHYSICS_COLLIDER_TABLES_HPP
+#define PHYSICS_COLLIDER_TABLES_HPP
+#include "../Math/Vector.hpp"
+#include "../Math/Quaternion.hpp"
+#include "../Math/Bounds.hpp"
+#include "../Containers/DArray.hpp"
+
+namespace Physics {
+
+	// the sphere colliders of a world stored as packed columns
+	// entry s belongs to the body with dense index bodies[s]
+	// the collider objects own the values, they copy them in here whenever they change
+	struct SphereTable {
+		DArray<unsigned int> bodies;
+		/// the position of the sphere in its body's space, set by the collider
+		DArray<float> localX;
+		DArray<float> localY;
+		DArray<float> localZ;
+		/// the local position turned by the body's rotation, refreshed whenever the body's bounds are
+		DArray<float> offsetX;
+		DArray<float> offsetY;
+		DArray<float> offsetZ;
+		DArray<float> radii;
+
+		size_t size() const { return bodies.size(); }
+
+		// adds an entry for the body and returns its index
+		unsigned int Add(const unsigned int& body) {
+			bodies.push_back(body);
+			localX.push_back(0.0f); localY.push_back(0.0f); localZ.push_back(0.0f);
+			offsetX.push_back(0.0f); offsetY.push_back(0.0f); offsetZ.push_back(0.0f);
+			radii.push_back(0.0f);
+			return static_cast<unsigned int>(bodies.size() - 1);
+		}
+
+		// removes entry s by moving the last entry into its place
+		void Remove(const unsigned int& s) {
+			bodies.swap_remove(s);
+			localX.swap_remove(s); localY.swap_remove(s); localZ.swap_remove(s);
+			offsetX.swap_remove(s); offsetY.swap_remove(s); offsetZ.swap_remove(s);
+			radii.swap_remove(s);
+		}
+
+		void Set(const unsigned int& s, const Math::Vector3& local, const Math::Quaternion& rotation, const float& radius) {
+			localX[s] = local.x; localY[s] = local.y; localZ[s] = local.z;
+			radii[s] = radius;
+			Orient(s, rotation);
+		}
+
+		// turns the local position of entry s by its body's rotation
+		void Orient(const unsigned int& s, const Math::Quaternion& rotation) {
+			Math::Vector3 offset = GetOffset(s, rotation);
+			offsetX[s] = offset.x; offsetY[s] = offset.y; offsetZ[s] = offset.z;
+		}
+
+		// the local position of entry s turned by rotation, most spheres sit on their body so that is skipped
+		Math::Vector3 GetOffset(const unsigned int& s, const Math::Quaternion& rotation) const {
+			Math::Vector3 local(localX[s], localY[s], localZ[s]);
+			if (local.x == 0.0f && local.y == 0.0f && local.z == 0.0f) return local;
+			return rotation * local;
+		}
+
+		// the center of entry s on a body at position, with the rotation from the last refit
+		Math::Vector3 GetCenter(const unsigned int& s, const Math::Vector3& position) const {
+			return Math::Vector3(position.x + offsetX[s], position.y + offsetY[s], position.z + offsetZ[s]);
+		}
+
+		Math::Bounds3D GetBounds(const unsigned int& s, const Math::Vector3& position) const {
+			Math::Vector3 center = GetCenter(s, position);
+			Math::Vector3 radius(radii[s]);
+			return Math::Bounds3D(center - radius, center + radius);
+		}
+		// the same for a rotation that the offset hasn't been refreshed with yet
+		Math::Bounds3D GetBounds(const unsigned int& s, const Math::Vector3& position, const Math::Quaternion& rotation) const {
+			Math::Vector3 center = position + GetOffset(s, rotation);
+			Math::Vector3 radius(radii[s]);
+			return Math::Bounds3D(center - radius, center + radius);
+		}
+	};
+
+}
+
+#endif // !PHYSICS_COLLIDER_TABLES_HPP
\ No newline at end of file
@@ -10,21 +10,14 @@ namespace Physics {
 		// the circle radius
 		float radius;
 
-		// called from body to update bounds
-		virtual Math::Bounds3D GetBounds(const Math::Vector3& bodyPos, const Math::Vector3& bodyRot) override {
-			Math::Vector3 r = Math::Vector3(radius);
-			return Math::Bounds3D(bodyPos + position - r, bodyPos + position + r);
-		}
-
 	public:
 
-		SphereColldier() { }
+		SphereColldier() : Collider(CollisionShape::Sphere), radius(0.5f) { }
 		~SphereColldier() { }
 
 		/// getters
 
 		float GetRadius() const { return radius; }
-		virtual CollisionShape GetCollisionShape() const override { return CollisionShape::Sphere; }
 
 		/// setters
 
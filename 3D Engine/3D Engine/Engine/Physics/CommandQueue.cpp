@@ -0,0 +1,81 @@
+#include "CommandQueue.hpp"
+
+namespace Physics {
+
+	CommandQueue::~CommandQueue() {
+		// delete anything that was never applied
+		CommandBatch* batch = head.exchange(nullptr, std::memory_order_acquire);
+		while (batch) {
+			CommandBatch* next = batch->next;
+			delete batch;
+			batch = next;
+		}
+	}
+
+	void CommandQueue::Submit(CommandBuffer& buffer) {
+		if (buffer.commands.empty()) return;
+
+		CommandBatch* batch = new CommandBatch();
+		batch->commands = std::move(buffer.commands);
+		batch->key = buffer.key;
+		batch->sequence = buffer.submits++;
+		buffer.creates = 0;
+
+		// the batch is filled before it is published so the world never sees half of it
+		batch->next = head.load(std::memory_order_relaxed);
+		while (!head.compare_exchange_weak(batch->next, batch, std::memory_order_release, std::memory_order_relaxed)) { }
+	}
+
+	void CommandQueue::Take(DArray<CommandBatch*>& batches) {
+		batches.clear();
+
+		// taking the whole list at once means producers never race with the world over a batch
+		CommandBatch* batch = head.exchange(nullptr, std::memory_order_acquire);
+		for (; batch; batch = batch->next)
+			batches.push_back(batch);
+
+		// insertion sort, there are only as many batches as producers
+		for (size_t i = 1; i < batches.size(); ++i) {
+			CommandBatch* b = batches[i];
+			size_t j = i;
+			while (j > 0 && Before(b, batches[j - 1])) {
+				batches[j] = batches[j - 1];
+				--j;
+			}
+			batches[j] = b;
+		}
+	}
+
+	bool CommandQueue::Before(const CommandBatch* a, const CommandBatch* b) {
+		if (a->key != b->key) return a->key < b->key;
+		if (a->sequence != b->sequence) return a->sequence < b->sequence;
+
+		// producers sharing a key tie here, the list order depends on timing so compare what the batches do
+		// the callback and data pointers are left out since they change from run to run
+		if (a->commands.size() != b->commands.size()) return a->commands.size() < b->commands.size();
+		for (size_t i = 0; i < a->commands.size(); ++i) {
+			const BodyCommand& ca = a->commands[i];
+			const BodyCommand& cb = b->commands[i];
+			if (ca.type != cb.type) return ca.type < cb.type;
+			if (ca.body.handle.index != cb.body.handle.index) return ca.body.handle.index < cb.body.handle.index;
+			if (ca.body.handle.generation != cb.body.handle.generation) return ca.body.handle.generation < cb.body.handle.generation;
+			if (ca.body.created != cb.body.created) return ca.body.created < cb.body.created;
+			if (ca.value.x != cb.value.x) return ca.value.x < cb.value.x;
+			if (ca.value.y != cb.value.y) return ca.value.y < cb.value.y;
+			if (ca.value.z != cb.value.z) return ca.value.z < cb.value.z;
+			if (ca.rotation.w != cb.rotation.w) return ca.rotation.w < cb.rotation.w;
+			if (ca.rotation.x != cb.rotation.x) return ca.rotation.x < cb.rotation.x;
+			if (ca.rotation.y != cb.rotation.y) return ca.rotation.y < cb.rotation.y;
+			if (ca.rotation.z != cb.rotation.z) return ca.rotation.z < cb.rotation.z;
+		}
+		// batches with the same commands change the bodies the same way whichever goes first
+		return false;
+	}
+
+	void CommandQueue::Free(DArray<CommandBatch*>& batches) {
+		for (CommandBatch* batch : batches)
+			delete batch;
+		batches.clear();
+	}
+
+}
\ No newline at end of file
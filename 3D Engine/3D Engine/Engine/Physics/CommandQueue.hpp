@@ -0,0 +1,207 @@
+#ifndef PHYSICS_COMMAND_QUEUE_HPP
+#define PHYSICS_COMMAND_QUEUE_HPP
+#include "../Math/Vector.hpp"
+#include "../Math/Quaternion.hpp"
+#include "../Containers/DArray.hpp"
+#include "BodyStorage.hpp"
+#include <atomic>
+
+namespace Physics {
+
+	class Body;
+	class World;
+	class CommandQueue;
+
+	enum class CommandType : unsigned char {
+		CreateRigidbody,
+		CreateStaticbody,
+		DestroyBody,
+		SetPosition,
+		SetRotation,
+		SetVelocity,
+		SetAngularVelocity,
+		SetAcceleration,
+		SetAngularAcceleration,
+		SetSphereCollider,
+		DestroyCollider,
+		SetMass,
+		SetFriction,
+		SetBounce,
+		SetAwake,
+		SetSimulated,
+	};
+
+	// called on the thread that steps the world with a body made by a command
+	typedef void(*CreateCallback)(void* data, Body* body);
+
+	// the body a command changes
+	// either a body that already exists or one made by an earlier command in the same buffer
+	struct BodyRef {
+		BodyHandle handle;
+		// the create in the same buffer, BodyHandle::Invalid when handle is used
+		unsigned int created;
+
+		BodyRef(const BodyHandle& handle_) : handle(handle_), created(BodyHandle::Invalid) { }
+
+		bool IsCreated() const { return created != BodyHandle::Invalid; }
+
+		static BodyRef Created(const unsigned int& created_) {
+			BodyRef ref = BodyRef(BodyHandle());
+			ref.created = created_;
+			return ref;
+		}
+	};
+
+	// one recorded change to a body
+	struct BodyCommand {
+		CommandType type;
+		BodyRef body;
+		// the vector of the command, float values are stored in x and bools as 0 or 1
+		Math::Vector3 value;
+		// the rotation of a SetRotation
+		Math::Quaternion rotation;
+		/// creates only
+		CreateCallback callback;
+		void* data;
+
+		BodyCommand(const CommandType& type_, const BodyRef& body_, const Math::Vector3& value_)
+			: type(type_), body(body_), value(value_), rotation(1.0f, 0.0f, 0.0f, 0.0f), callback(nullptr), data(nullptr) { }
+		BodyCommand() : type(CommandType::DestroyBody), body(BodyHandle()), value(0.0f), rotation(1.0f, 0.0f, 0.0f, 0.0f), callback(nullptr), data(nullptr) { }
+	};
+
+	// records creates, destroys and changes to bodies on one thread without touching the world
+	// each producing thread keeps its own buffer and submits it to the world's CommandQueue
+	// not thread safe, only the queue is
+	class CommandBuffer {
+		friend CommandQueue;
+
+		DArray<BodyCommand> commands;
+		// the creates recorded since the last submit
+		unsigned int creates;
+		// orders the buffers of different producers when they are applied
+		unsigned int key;
+		// counts the submits so one producer's buffers stay in the order they were submitted
+		unsigned int submits;
+
+		void Push(const CommandType& type, const BodyRef& body, const Math::Vector3& value) {
+			commands.push_back(BodyCommand(type, body, value));
+		}
+
+		BodyRef PushCreate(const CommandType& type, void* data, const CreateCallback& callback) {
+			BodyCommand command(type, BodyHandle(), Math::Vector3(0.0f));
+			command.callback = callback;
+			command.data = data;
+			commands.push_back(command);
+			return BodyRef::Created(creates++);
+		}
+
+	public:
+
+		// key orders this buffer against the buffers of other producers, give each producer its own
+		// there is no default so two producers can't end up sharing one by accident
+		explicit CommandBuffer(const unsigned int& key_) : creates(0), key(key_), submits(0) { }
+
+		/// creating/destroying bodies
+
+		// the returned ref can be used by later commands in this buffer until it is submitted
+		// callback gets the new body when the command is applied, it can keep its handle
+		BodyRef CreateRigidbody(void* data = nullptr, const CreateCallback& callback = nullptr) {
+			return PushCreate(CommandType::CreateRigidbody, data, callback);
+		}
+		BodyRef CreateStaticbody(void* data = nullptr, const CreateCallback& callback = nullptr) {
+			return PushCreate(CommandType::CreateStaticbody, data, callback);
+		}
+		void DestroyBody(const BodyRef& body) { Push(CommandType::DestroyBody, body, Math::Vector3(0.0f)); }
+
+		/// changing bodies
+		// commands on a body that was destroyed before they are applied do nothing
+		// velocities and accelerations only change rigidbodies
+
+		void SetPosition(const BodyRef& body, const Math::Vector3& position_) { Push(CommandType::SetPosition, body, position_); }
+		void SetRotation(const BodyRef& body, const Math::Quaternion& rotation_) {
+			BodyCommand command(CommandType::SetRotation, body, Math::Vector3(0.0f));
+			command.rotation = rotation_;
+			commands.push_back(command);
+		}
+		void SetVelocity(const BodyRef& body, const Math::Vector3& velocity_) { Push(CommandType::SetVelocity, body, velocity_); }
+		void SetAngularVelocity(const BodyRef& body, const Math::Vector3& angularVelocity_) { Push(CommandType::SetAngularVelocity, body, angularVelocity_); }
+		void SetAcceleration(const BodyRef& body, const Math::Vector3& acceleration_) { Push(CommandType::SetAcceleration, body, acceleration_); }
+		void SetAngularAcceleration(const BodyRef& body, const Math::Vector3& angularAcceleration_) { Push(CommandType::SetAngularAcceleration, body, angularAcceleration_); }
+		// replaces the collider with a sphere of radius
+		void SetSphereCollider(const BodyRef& body, const float& radius_) { Push(CommandType::SetSphereCollider, body, Math::Vector3(radius_, 0.0f, 0.0f)); }
+		void DestroyCollider(const BodyRef& body) { Push(CommandType::DestroyCollider, body, Math::Vector3(0.0f)); }
+		void SetMass(const BodyRef& body, const float& mass_) { Push(CommandType::SetMass, body, Math::Vector3(mass_, 0.0f, 0.0f)); }
+		void SetFriction(const BodyRef& body, const float& friction_) { Push(CommandType::SetFriction, body, Math::Vector3(friction_, 0.0f, 0.0f)); }
+		void SetBounce(const BodyRef& body, const float& bounce_) { Push(CommandType::SetBounce, body, Math::Vector3(bounce_, 0.0f, 0.0f)); }
+		void SetAwake(const BodyRef& body, const bool& awake_) { Push(CommandType::SetAwake, body, Math::Vector3(awake_ ? 1.0f : 0.0f, 0.0f, 0.0f)); }
+		void SetSimulated(const BodyRef& body, const bool& simulated_) { Push(CommandType::SetSimulated, body, Math::Vector3(simulated_ ? 1.0f : 0.0f, 0.0f, 0.0f)); }
+
+		/// functions
+
+		size_t size() const { return commands.size(); }
+		bool empty() const { return commands.empty(); }
+		// drops the recorded commands without submitting them
+		void clear() { commands.clear(); creates = 0; }
+
+		/// getters
+
+		unsigned int GetKey() const { return key; }
+
+		/// setters
+
+		void SetKey(const unsigned int& key_) { key = key_; }
+
+	};
+
+	// the commands of one submitted buffer
+	struct CommandBatch {
+		DArray<BodyCommand> commands;
+		unsigned int key;
+		unsigned int sequence;
+		CommandBatch* next;
+	};
+
+	// collects command buffers from any number of threads without a lock
+	// submitted batches are pushed onto a list with a compare and swap and the world takes the whole list at once
+	// batches are applied sorted by their buffer's key and then in the order each buffer submitted them
+	// so the result does not depend on which thread submitted first, as long as every producer has its own key
+	// batches that still tie are ordered by their commands, never by when they were submitted
+	class CommandQueue {
+
+		// the batches submitted since the last Take, newest first
+		std::atomic<CommandBatch*> head;
+
+		// the order batches are applied in
+		static bool Before(const CommandBatch* a, const CommandBatch* b);
+
+	public:
+
+		CommandQueue() : head(nullptr) { }
+		~CommandQueue();
+
+		CommandQueue(const CommandQueue&) = delete;
+		CommandQueue& operator=(const CommandQueue&) = delete;
+
+		/// functions
+
+		// moves the buffer's commands into a batch for the world to apply at the start of its next step
+		// the buffer is left empty and can record again straight away
+		// safe to call from any thread, even while the world is stepping
+		void Submit(CommandBuffer& buffer);
+
+		// takes every submitted batch and writes them into batches in the order they should be applied
+		// the batches belong to the caller after, give them back with Free
+		// only one thread can take at a time
+		void Take(DArray<CommandBatch*>& batches);
+
+		// deletes the batches and clears the array
+		static void Free(DArray<CommandBatch*>& batches);
+
+		// checks if anything was submitted since the last Take
+		bool empty() const { return head.load(std::memory_order_relaxed) == nullptr; }
+
+	};
+
+}
+
+#endif // !PHYSICS_COMMAND_QUEUE_HPP
\ No newline at end of file
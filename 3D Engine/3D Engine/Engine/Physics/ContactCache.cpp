@@ -0,0 +1,96 @@
+#include "ContactCache.hpp"
+#include <cmath>
+
+namespace Physics {
+
+	static bool SameBodies(const BodyPair& p0, const BodyPair& p1) {
+		return (p0.a == p1.a && p0.b == p1.b) || (p0.a == p1.b && p0.b == p1.a);
+	}
+
+	void ContactCache::Update(const DArray<BodyPair>& pairs, const ContactBuffer& buffer, const BodyStorage& storage) {
+		++stamp;
+
+		// keep the contacts whose pairs are still overlapping in the broadphase
+		for (const BodyPair& pair : pairs) {
+			unsigned int* index = indices.find(pair.Key());
+			if (!index) continue;
+
+			Contact& contact = contacts[*index];
+			// the key only uses the handle index so a reused slot looks like the same pair
+			if (!SameBodies(contact.pair, pair)) continue;
+			contact.stamp = stamp;
+
+			// the narrowphase skips bodies that are not moving so their contacts stay as they were
+			unsigned int ia = storage.GetIndex(pair.a);
+			unsigned int ib = storage.GetIndex(pair.b);
+			if (storage.IsMoving(ia) || storage.IsMoving(ib)) contact.touching = false;
+		}
+
+		// copy the new geometry in, keeping the impulses of contacts that already existed
+		for (size_t i = 0; i < buffer.size(); ++i) {
+			const BodyPair& pair = buffer.pairs[i];
+			unsigned long long key = pair.Key();
+
+			unsigned int* index = indices.find(key);
+			if (!index) {
+				indices.insert(key, static_cast<unsigned int>(contacts.size()));
+				contacts.push_back(Contact());
+				index = indices.find(key);
+			}
+
+			Contact& contact = contacts[*index];
+			if (contact.stamp != stamp || !SameBodies(contact.pair, pair)) {
+				// a new contact, or one left over from a destroyed body
+				contact.normalImpulse = 0.0f;
+				contact.tangentImpulse = Math::Vector3(0.0f);
+			}
+			contact.pair = pair;
+			contact.normal = Math::Vector3(buffer.normalX[i], buffer.normalY[i], buffer.normalZ[i]);
+			contact.point = Math::Vector3(buffer.pointX[i], buffer.pointY[i], buffer.pointZ[i]);
+			contact.depth = buffer.depths[i];
+			contact.stamp = stamp;
+			contact.touching = true;
+
+			// friction is averaged geometrically so one slippery body makes the contact slippery
+			// the bouncier body wins
+			unsigned int ia = storage.GetIndex(pair.a);
+			unsigned int ib = storage.GetIndex(pair.b);
+			contact.friction = sqrtf(storage.frictions[ia] * storage.frictions[ib]);
+			contact.bounce = fmaxf(storage.bounces[ia], storage.bounces[ib]);
+		}
+
+		Evict();
+
+		// separated contacts stop warm starting
+		for (Contact& contact : contacts) {
+			if (contact.touching) continue;
+			contact.normalImpulse = 0.0f;
+			contact.tangentImpulse = Math::Vector3(0.0f);
+		}
+	}
+
+	void ContactCache::Evict() {
+		// pack the surviving contacts to the front
+		size_t kept = 0;
+		for (size_t i = 0; i < contacts.size(); ++i) {
+			if (contacts[i].stamp != stamp) continue;
+			if (kept != i) contacts[kept] = contacts[i];
+			++kept;
+		}
+		if (kept == contacts.size()) return;
+		contacts.resize(kept);
+
+		// the indices moved so rebuild the map
+		indices.clear();
+		for (size_t i = 0; i < contacts.size(); ++i)
+			indices.insert(contacts[i].pair.Key(), static_cast<unsigned int>(i));
+	}
+
+	const Contact* ContactCache::Find(const BodyPair& pair) const {
+		const unsigned int* index = indices.find(pair.Key());
+		if (!index) return nullptr;
+		const Contact& contact = contacts[*index];
+		return SameBodies(contact.pair, pair) ? &contact : nullptr;
+	}
+
+}
\ No newline at end of file
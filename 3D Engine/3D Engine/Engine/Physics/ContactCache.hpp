@@ -0,0 +1,85 @@
+#ifndef PHYSICS_CONTACT_CACHE_HPP
+#define PHYSICS_CONTACT_CACHE_HPP
+#include "BodyStorage.hpp"
+#include "Broadphase.hpp"
+#include "Narrowphase.hpp"
+#include "../Containers/HashMap.hpp"
+
+namespace Physics {
+
+	// a contact between two bodies that is kept for as long as the broadphase has their pair
+	struct Contact {
+		BodyPair pair;
+
+		/// geometry from the narrowphase, the normal points from a to b
+		Math::Vector3 normal;
+		Math::Vector3 point;
+		float depth;
+
+		/// combined material
+		float friction;
+		float bounce;
+
+		/// accumulated impulses, kept between timesteps to warm start the solver
+		float normalImpulse;
+		Math::Vector3 tangentImpulse;
+
+		// the last timestep the broadphase still had the pair
+		unsigned int stamp;
+		// if the shapes overlapped in the last timestep
+		bool touching;
+
+		/// solver data, filled in every timestep
+		unsigned int indexA;
+		unsigned int indexB;
+		float normalMass;
+		float velocityBias;
+		float pushBias;
+
+		Contact()
+			: normal(0.0f), point(0.0f), depth(0.0f), friction(0.0f), bounce(0.0f), normalImpulse(0.0f), tangentImpulse(0.0f)
+			, stamp(0), touching(false), indexA(0), indexB(0), normalMass(0.0f), velocityBias(0.0f), pushBias(0.0f) { }
+	};
+
+	// keeps contacts across timesteps keyed by their body pair
+	class ContactCache {
+
+		// maps a BodyPair key to an index into contacts
+		HashMap<unsigned long long, unsigned int> indices;
+		DArray<Contact> contacts;
+
+		// goes up every timestep
+		unsigned int stamp;
+
+		// removes every contact whose pair was not stamped this timestep in one pass
+		void Evict();
+
+	public:
+
+		ContactCache() : stamp(0) { }
+
+		// keeps the contacts whose pairs are still in the broadphase, adds the new ones
+		// and copies the narrowphase geometry into them
+		void Update(const DArray<BodyPair>& pairs, const ContactBuffer& buffer, const BodyStorage& storage);
+
+		// removes all the contacts
+		void clear() {
+			indices.clear();
+			contacts.clear();
+		}
+
+		/// getters
+
+		size_t size() const { return contacts.size(); }
+		Contact& operator[](const size_t& index) { return contacts[index]; }
+		const Contact& operator[](const size_t& index) const { return contacts[index]; }
+		DArray<Contact>& GetContacts() { return contacts; }
+		const DArray<Contact>& GetContacts() const { return contacts; }
+		// finds the contact between two bodies, nullptr if there is none
+		const Contact* Find(const BodyPair& pair) const;
+
+	};
+
+}
+
+#endif // !PHYSICS_CONTACT_CACHE_HPP
\ No newline at end of file
@@ -0,0 +1,322 @@
+#include "ContactSolver.hpp"
+#include <cmath>
+
+namespace Physics {
+
+	using Math::Vector3;
+
+	// the body columns the contact functions read and write
+	struct SolverBodies {
+		const float* inverseMasses;
+		Vector3* velocities;
+		Vector3* pushes;
+		// the positions now and at the start of the timestep, only used by the substeps
+		const Vector3* positions;
+		const Vector3* origins;
+	};
+
+	// applies an impulse from a to b
+	// bodies that cant move are never written to since islands running in parallel can share them
+	static void ApplyImpulse(Vector3* velocities, const float* inverseMasses, const Contact& c, const Vector3& impulse) {
+		const float imA = inverseMasses[c.indexA];
+		const float imB = inverseMasses[c.indexB];
+		if (imA != 0.0f) velocities[c.indexA] -= impulse * imA;
+		if (imB != 0.0f) velocities[c.indexB] += impulse * imB;
+	}
+
+	static void WarmStartContact(const Contact& c, const SolverBodies& bodies) {
+		Vector3 impulse = c.normal * c.normalImpulse + c.tangentImpulse;
+		ApplyImpulse(bodies.velocities, bodies.inverseMasses, c, impulse);
+	}
+
+	static void SolveContact(Contact& c, const SolverBodies& bodies) {
+		Vector3* velocities = bodies.velocities;
+
+		// friction first, clamped to a circle so it is the same in every direction
+		Vector3 dv = velocities[c.indexB] - velocities[c.indexA];
+		Vector3 vt = dv - c.normal * Vector3::Dot(dv, c.normal);
+		Vector3 oldTangent = c.tangentImpulse;
+		Vector3 newTangent = oldTangent - vt * c.normalMass;
+		float maxFriction = c.friction * c.normalImpulse;
+		float tangentSq = Vector3::Dot(newTangent, newTangent);
+		if (tangentSq > maxFriction * maxFriction)
+			newTangent *= maxFriction / sqrtf(tangentSq);
+		c.tangentImpulse = newTangent;
+		ApplyImpulse(velocities, bodies.inverseMasses, c, newTangent - oldTangent);
+
+		// then the normal, the total impulse can only push
+		dv = velocities[c.indexB] - velocities[c.indexA];
+		float vn = Vector3::Dot(dv, c.normal);
+		float oldNormal = c.normalImpulse;
+		c.normalImpulse = fmaxf(oldNormal - c.normalMass * (vn - c.velocityBias), 0.0f);
+		ApplyImpulse(velocities, bodies.inverseMasses, c, c.normal * (c.normalImpulse - oldNormal));
+	}
+
+	static void PushContact(const Contact& c, float& pushImpulse, const SolverBodies& bodies) {
+		float vn = Vector3::Dot(bodies.pushes[c.indexB] - bodies.pushes[c.indexA], c.normal);
+		float oldImpulse = pushImpulse;
+		pushImpulse = fmaxf(oldImpulse - c.normalMass * (vn - c.pushBias), 0.0f);
+		ApplyImpulse(bodies.pushes, bodies.inverseMasses, c, c.normal * (pushImpulse - oldImpulse));
+	}
+
+	/// substep contacts are soft, they push overlap out like a stiff damped spring instead of all at once
+	/// which keeps stacks of very different masses from gaining energy with only one pass per substep
+	// how stiff the contacts are, capped at a quarter of the substep rate so the spring never outruns the substeps
+	static const float ContactHertz = 30.0f;
+	// how much the contact spring is damped, far past critical so it doesnt bounce
+	static const float ContactDampingRatio = 10.0f;
+	// the fastest overlap is pushed out at
+	static const float MaxPushSpeed = 3.0f;
+
+	// the coefficients of a soft contact for a substep of length h
+	struct Softness {
+		float biasRate;
+		float massScale;
+		float impulseScale;
+
+		Softness(const float& h) {
+			float omega = 2.0f * 3.14159265f * fminf(ContactHertz, 0.25f / h);
+			float a1 = 2.0f * ContactDampingRatio + h * omega;
+			float a2 = h * omega * a1;
+			float a3 = 1.0f / (1.0f + a2);
+			biasRate = omega / a1;
+			massScale = a2 * a3;
+			impulseScale = a3;
+		}
+	};
+
+	// solves the contact in a substep with the depth it has now
+	// a gap is allowed to close by the end of the substep, overlap past the slop is pushed out softly when useBias is set
+	static void SolveSubstepContact(Contact& c, const SolverBodies& bodies, const float& inverseH, const float& slop, const Softness& soft, const bool& useBias) {
+		Vector3* velocities = bodies.velocities;
+
+		// the contact is as deep as it was found minus how far the bodies have moved apart along the normal since
+		Vector3 movedA = bodies.positions[c.indexA] - bodies.origins[c.indexA];
+		Vector3 movedB = bodies.positions[c.indexB] - bodies.origins[c.indexB];
+		float separation = slop - c.depth + Vector3::Dot(movedB - movedA, c.normal);
+
+		// the speed the bodies have to separate at, negative lets them close
+		float target = 0.0f;
+		float massScale = 1.0f;
+		float impulseScale = 0.0f;
+		if (separation > 0.0f) {
+			target = -separation * inverseH;
+		} else if (useBias) {
+			target = fminf(-soft.biasRate * separation, MaxPushSpeed);
+			massScale = soft.massScale;
+			impulseScale = soft.impulseScale;
+		}
+
+		// friction first, clamped to a circle so it is the same in every direction
+		Vector3 dv = velocities[c.indexB] - velocities[c.indexA];
+		Vector3 vt = dv - c.normal * Vector3::Dot(dv, c.normal);
+		Vector3 oldTangent = c.tangentImpulse;
+		Vector3 newTangent = oldTangent - vt * c.normalMass;
+		float maxFriction = c.friction * c.normalImpulse;
+		float tangentSq = Vector3::Dot(newTangent, newTangent);
+		if (tangentSq > maxFriction * maxFriction)
+			newTangent *= maxFriction / sqrtf(tangentSq);
+		c.tangentImpulse = newTangent;
+		ApplyImpulse(velocities, bodies.inverseMasses, c, newTangent - oldTangent);
+
+		// then the normal, the total impulse can only push
+		dv = velocities[c.indexB] - velocities[c.indexA];
+		float vn = Vector3::Dot(dv, c.normal);
+		float oldNormal = c.normalImpulse;
+		c.normalImpulse = fmaxf(oldNormal - c.normalMass * massScale * (vn - target) - impulseScale * oldNormal, 0.0f);
+		ApplyImpulse(velocities, bodies.inverseMasses, c, c.normal * (c.normalImpulse - oldNormal));
+	}
+
+	// makes the contact separate at its bounce speed if it was hitting hard enough
+	static void BounceContact(Contact& c, const SolverBodies& bodies) {
+		if (c.velocityBias == 0.0f) return;
+
+		float vn = Vector3::Dot(bodies.velocities[c.indexB] - bodies.velocities[c.indexA], c.normal);
+		float oldNormal = c.normalImpulse;
+		c.normalImpulse = fmaxf(oldNormal - c.normalMass * (vn - c.velocityBias), 0.0f);
+		ApplyImpulse(bodies.velocities, bodies.inverseMasses, c, c.normal * (c.normalImpulse - oldNormal));
+	}
+
+	void ContactSolver::Solve(ContactCache& cache, BodyStorage& storage, const Islands& islands, const float& dt) {
+		if (cache.size() == 0 || dt <= 0.0f) return;
+
+		Prepare(cache, storage, dt);
+		SortIslands(cache, storage, islands);
+
+		pushVelocities.resize(storage.size());
+		pushVelocities.fill(Vector3(0.0f));
+		pushImpulses.resize(cache.size());
+		pushImpulses.fill(0.0f);
+
+		SolverBodies bodies = { storage.inverseMasses.data(), storage.velocities.data(), pushVelocities.data(), nullptr, nullptr };
+		float* impulses = pushImpulses.data();
+
+		if (warmStarting)
+			RunContacts(cache, islands, [&bodies](Contact& c, const unsigned int&) { WarmStartContact(c, bodies); });
+		for (unsigned int it = 0; it < iterations; ++it)
+			RunContacts(cache, islands, [&bodies](Contact& c, const unsigned int&) { SolveContact(c, bodies); });
+		for (unsigned int it = 0; it < iterations; ++it) {
+			RunContacts(cache, islands, [&bodies, impulses](Contact& c, const unsigned int& index) {
+				if (c.pushBias != 0.0f) PushContact(c, impulses[index], bodies);
+			});
+		}
+
+		// move the bodies by their push velocities
+		Vector3* positions = storage.positions.data();
+		const Vector3* pushes = pushVelocities.data();
+		ForEach(pushVelocities.size(), 1024, [positions, pushes, dt](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				positions[i] += pushes[i] * dt;
+		});
+	}
+
+	void ContactSolver::BeginSubsteps(ContactCache& cache, BodyStorage& storage, const Islands& islands, const float& dt) {
+		Prepare(cache, storage, dt);
+		SortIslands(cache, storage, islands);
+		origins = storage.positions;
+	}
+
+	void ContactSolver::SolveSubstep(ContactCache& cache, BodyStorage& storage, const Islands& islands, const float& h) {
+		if (cache.size() == 0 || h <= 0.0f) return;
+
+		SolverBodies bodies = { storage.inverseMasses.data(), storage.velocities.data(), nullptr, storage.positions.data(), origins.data() };
+		const float inverseH = 1.0f / h;
+		const Softness soft(h);
+
+		// the impulses are kept per substep so every substep starts from them
+		if (warmStarting)
+			RunContacts(cache, islands, [&bodies](Contact& c, const unsigned int&) { WarmStartContact(c, bodies); });
+		RunContacts(cache, islands, [this, &bodies, inverseH, &soft](Contact& c, const unsigned int&) {
+			SolveSubstepContact(c, bodies, inverseH, slop, soft, true);
+		});
+	}
+
+	void ContactSolver::RelaxSubstep(ContactCache& cache, BodyStorage& storage, const Islands& islands, const float& h) {
+		if (cache.size() == 0 || h <= 0.0f) return;
+
+		SolverBodies bodies = { storage.inverseMasses.data(), storage.velocities.data(), nullptr, storage.positions.data(), origins.data() };
+		const float inverseH = 1.0f / h;
+		const Softness soft(h);
+
+		RunContacts(cache, islands, [this, &bodies, inverseH, &soft](Contact& c, const unsigned int&) {
+			SolveSubstepContact(c, bodies, inverseH, slop, soft, false);
+		});
+	}
+
+	void ContactSolver::EndSubsteps(ContactCache& cache, BodyStorage& storage, const Islands& islands) {
+		if (cache.size() == 0) return;
+
+		SolverBodies bodies = { storage.inverseMasses.data(), storage.velocities.data(), nullptr, nullptr, nullptr };
+		RunContacts(cache, islands, [&bodies](Contact& c, const unsigned int&) { BounceContact(c, bodies); });
+	}
+
+	void ContactSolver::Prepare(ContactCache& cache, const BodyStorage& storage, const float& dt) {
+		const float* inverseMasses = storage.inverseMasses.data();
+		const Vector3* velocities = storage.velocities.data();
+		Contact* contacts = cache.GetContacts().data();
+
+		ForEach(cache.size(), 256, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				Contact& c = contacts[i];
+				c.normalMass = 0.0f;
+				if (!c.touching) continue;
+
+				c.indexA = storage.GetIndex(c.pair.a);
+				c.indexB = storage.GetIndex(c.pair.b);
+				if (!storage.IsMoving(c.indexA) && !storage.IsMoving(c.indexB)) continue;
+
+				float invMass = inverseMasses[c.indexA] + inverseMasses[c.indexB];
+				if (invMass <= 0.0f) continue;
+				c.normalMass = 1.0f / invMass;
+
+				// bounce if the shapes are hitting hard enough
+				float vn = Vector3::Dot(velocities[c.indexB] - velocities[c.indexA], c.normal);
+				c.velocityBias = vn < -bounceThreshold ? -c.bounce * vn : 0.0f;
+				c.pushBias = baumgarte / dt * fmaxf(c.depth - slop, 0.0f);
+
+				// drop the part of the old friction impulse that is no longer in the contact plane
+				c.tangentImpulse -= c.normal * Vector3::Dot(c.tangentImpulse, c.normal);
+			}
+		});
+	}
+
+	void ContactSolver::SortIslands(const ContactCache& cache, const BodyStorage& storage, const Islands& islands) {
+		smallIslands.clear();
+		largeIslands.clear();
+		colorStarts.clear();
+		colored.clear();
+
+		// sort the islands by size
+		for (size_t i = 0; i < islands.size(); ++i) {
+			unsigned int count = islands.GetContactCount(i);
+			if (count == 0) continue;
+			if (count > largeIslandSize && jobs && jobs->GetThreadCount() > 1) largeIslands.push_back(static_cast<unsigned int>(i));
+			else smallIslands.push_back(static_cast<unsigned int>(i));
+		}
+
+		// the large islands are colored once for every pass over their contacts
+		for (unsigned int island : largeIslands)
+			ColorIsland(cache, storage, islands.GetContacts(island), islands.GetContactCount(island));
+	}
+
+	void ContactSolver::ColorIsland(const ContactCache& cache, const BodyStorage& storage, const unsigned int* contacts, const unsigned int& count) {
+		const Contact* cached = cache.GetContacts().data();
+		const float* inverseMasses = storage.inverseMasses.data();
+
+		bodyColors.resize(storage.size(), 0);
+		contactColors.resize(count);
+		// one start per color, the uncolored color and the end
+		const size_t block = colorStarts.size();
+		colorStarts.resize(block + MaxColors + 2, 0);
+		unsigned int* starts = colorStarts.data() + block;
+
+		// give each contact the lowest color neither of its moving bodies has used
+		// bodies that cant move are never written so they dont need a color
+		for (unsigned int i = 0; i < count; ++i) {
+			const Contact& c = cached[contacts[i]];
+			if (c.normalMass == 0.0f) {
+				contactColors[i] = MaxColors + 1;
+				continue;
+			}
+
+			unsigned long long used = 0;
+			if (inverseMasses[c.indexA] != 0.0f) used |= bodyColors[c.indexA];
+			if (inverseMasses[c.indexB] != 0.0f) used |= bodyColors[c.indexB];
+
+			unsigned int color = MaxColors;
+			for (unsigned int k = 0; k < MaxColors; ++k) {
+				if (used & (1ULL << k)) continue;
+				color = k;
+				break;
+			}
+
+			if (color != MaxColors) {
+				if (inverseMasses[c.indexA] != 0.0f) bodyColors[c.indexA] |= 1ULL << color;
+				if (inverseMasses[c.indexB] != 0.0f) bodyColors[c.indexB] |= 1ULL << color;
+			}
+			contactColors[i] = color;
+			++starts[color + 1];
+		}
+
+		// clear the body colors for the next island
+		for (unsigned int i = 0; i < count; ++i) {
+			if (contactColors[i] > MaxColors) continue;
+			const Contact& c = cached[contacts[i]];
+			bodyColors[c.indexA] = 0;
+			bodyColors[c.indexB] = 0;
+		}
+
+		// counting sort the contacts by color after the islands before, contacts that are not solved are dropped
+		starts[0] = static_cast<unsigned int>(colored.size());
+		for (unsigned int k = 0; k <= MaxColors; ++k)
+			starts[k + 1] += starts[k];
+
+		colorCursors.resize(MaxColors + 1);
+		for (unsigned int k = 0; k <= MaxColors; ++k)
+			colorCursors[k] = starts[k];
+		colored.resize(starts[MaxColors + 1]);
+		for (unsigned int i = 0; i < count; ++i)
+			if (contactColors[i] <= MaxColors) colored[colorCursors[contactColors[i]]++] = contacts[i];
+	}
+
+}
\ No newline at end of file
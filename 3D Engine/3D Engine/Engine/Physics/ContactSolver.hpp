@@ -0,0 +1,183 @@
+#ifndef PHYSICS_CONTACT_SOLVER_HPP
+#define PHYSICS_CONTACT_SOLVER_HPP
+#include "ContactCache.hpp"
+#include "Islands.hpp"
+#include "../Jobs/JobSystem.hpp"
+
+namespace Physics {
+
+	// how the contact solver steps
+	// Standard solves the contacts once per timestep
+	// Substepped splits the timestep into substeps that each integrate and solve once, reusing the timestep's contacts
+	enum class SolverMode : unsigned char { Standard, Substepped };
+
+	// solves the contacts in a cache with sequential impulses
+	// the impulses from the last timestep are applied first so only a few iterations are needed
+	// penetration is pushed out with separate push velocities that move the bodies but are not kept,
+	// so pushing never adds energy to the warm started impulses
+	// in substepped mode the depth is worked out again every substep from how far the bodies moved,
+	// penetration is pushed out softly like a stiff spring and a relax pass takes the push back out of the velocity
+	// islands are solved in parallel, islands with many contacts are split into colors
+	// where no two contacts in a color share a moving body
+	class ContactSolver {
+
+		SolverMode mode;
+		unsigned int iterations;
+		// how many substeps a timestep is split into in substepped mode
+		unsigned int substeps;
+		bool warmStarting;
+
+		// how much of the penetration is removed each timestep, the substeps use their own soft push
+		float baumgarte;
+		// how far shapes can overlap before they are pushed apart, stops jitter when resting
+		float slop;
+		// how fast shapes need to be hitting before they bounce
+		float bounceThreshold;
+
+		// islands with more contacts than this are colored so their contacts can be solved in parallel
+		unsigned int largeIslandSize;
+
+		// nullptr solves on the calling thread
+		Jobs::JobSystem* jobs;
+
+		// the push velocities of each body and the push impulses of each contact this timestep
+		DArray<Math::Vector3> pushVelocities;
+		DArray<float> pushImpulses;
+
+		// the positions of the bodies at the start of the timestep, the substeps measure how far they moved from here
+		DArray<Math::Vector3> origins;
+
+		/// islands
+		DArray<unsigned int> smallIslands;
+		DArray<unsigned int> largeIslands;
+
+		/// coloring, large island l uses MaxColors + 2 starts from colorStarts[l * (MaxColors + 2)]
+		// color k of the island is [starts[k], starts[k + 1]) of colored
+		// bodies with too many contacts for the colors go in a last color that is solved on one thread
+		static const unsigned int MaxColors = 64;
+		DArray<unsigned long long> bodyColors;
+		DArray<unsigned int> contactColors;
+		DArray<unsigned int> colorStarts;
+		DArray<unsigned int> colorCursors;
+		DArray<unsigned int> colored;
+
+		// fills in the solver data of every touching contact
+		void Prepare(ContactCache& cache, const BodyStorage& storage, const float& dt);
+
+		// splits the islands into small and large ones and colors the large ones
+		void SortIslands(const ContactCache& cache, const BodyStorage& storage, const Islands& islands);
+
+		// groups the contacts of a large island into colors where no two contacts share a moving body
+		// and adds them after the colors of the islands before it
+		void ColorIsland(const ContactCache& cache, const BodyStorage& storage, const unsigned int* contacts, const unsigned int& count);
+
+		// runs func(first, count) over chunks of [0, count) on the job system if there is one
+		template<typename F>
+		void ForEach(const size_t& count, const size_t& grain, const F& func) {
+			if (jobs) jobs->ParallelFor(count, grain, func);
+			else func(static_cast<size_t>(0), count);
+		}
+
+		// runs func(contact, index) once on every contact being solved
+		// the small islands each go on one thread and the large islands are run one color at a time
+		template<typename F>
+		void RunContacts(ContactCache& cache, const Islands& islands, const F& func) {
+			Contact* cached = cache.GetContacts().data();
+
+			// the small islands dont share any moving bodies so each one can go on its own thread
+			ForEach(smallIslands.size(), 16, [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) {
+					const unsigned int* contacts = islands.GetContacts(smallIslands[i]);
+					const unsigned int count = islands.GetContactCount(smallIslands[i]);
+					for (unsigned int k = 0; k < count; ++k)
+						if (cached[contacts[k]].normalMass != 0.0f) func(cached[contacts[k]], contacts[k]);
+				}
+			});
+
+			for (size_t l = 0; l < largeIslands.size(); ++l) {
+				const unsigned int* starts = colorStarts.data() + l * (MaxColors + 2);
+				for (unsigned int color = 0; color <= MaxColors; ++color) {
+					const unsigned int* order = colored.data() + starts[color];
+					auto run = [&](size_t begin, size_t end) {
+						for (size_t i = begin; i < end; ++i)
+							func(cached[order[i]], order[i]);
+					};
+
+					// the last color has contacts that could not be colored and is run on this thread
+					if (color == MaxColors) run(0, starts[color + 1] - starts[color]);
+					else ForEach(starts[color + 1] - starts[color], 64, run);
+				}
+			}
+		}
+
+	public:
+
+		ContactSolver()
+			: mode(SolverMode::Standard), iterations(3), substeps(4), warmStarting(true), baumgarte(0.2f), slop(0.01f), bounceThreshold(1.0f)
+			, largeIslandSize(512), jobs(nullptr) { }
+
+		// changes the velocities of the bodies so the contacts stop closing
+		// and pushes overlapping bodies apart
+		void Solve(ContactCache& cache, BodyStorage& storage, const Islands& islands, const float& dt);
+
+		/// substeps
+		// a substepped timestep runs BeginSubsteps, then for every substep integrates the velocities,
+		// runs SolveSubstep, integrates the positions and runs RelaxSubstep, then runs EndSubsteps
+
+		// fills in the solver data and remembers where every body started
+		void BeginSubsteps(ContactCache& cache, BodyStorage& storage, const Islands& islands, const float& dt);
+
+		// warm starts the contacts then solves them with a bias that pushes out the overlap they have now
+		void SolveSubstep(ContactCache& cache, BodyStorage& storage, const Islands& islands, const float& h);
+
+		// solves the contacts again without the push so it doesnt stay in the velocities
+		void RelaxSubstep(ContactCache& cache, BodyStorage& storage, const Islands& islands, const float& h);
+
+		// bounces the contacts that were hitting hard enough at the start of the timestep
+		void EndSubsteps(ContactCache& cache, BodyStorage& storage, const Islands& islands);
+
+		/// getters
+
+		SolverMode GetMode() const { return mode; }
+		unsigned int GetIterations() const { return iterations; }
+		unsigned int GetSubsteps() const { return substeps; }
+		bool GetWarmStarting() const { return warmStarting; }
+		float GetBaumgarte() const { return baumgarte; }
+		float GetSlop() const { return slop; }
+		float GetBounceThreshold() const { return bounceThreshold; }
+		unsigned int GetLargeIslandSize() const { return largeIslandSize; }
+		Jobs::JobSystem* GetJobSystem() const { return jobs; }
+
+		/// setters
+
+		void SetMode(const SolverMode& mode_) { mode = mode_; }
+		void SetIterations(const unsigned int& iterations_) { iterations = iterations_; }
+		void SetSubsteps(const unsigned int& substeps_) {
+			substeps = substeps_;
+			if (substeps < 1) substeps = 1;
+		}
+		void SetWarmStarting(const bool& warmStarting_) { warmStarting = warmStarting_; }
+		void SetBaumgarte(const float& baumgarte_) {
+			baumgarte = baumgarte_;
+			if (baumgarte < 0.0f) baumgarte = 0.0f;
+			if (baumgarte > 1.0f) baumgarte = 1.0f;
+		}
+		void SetSlop(const float& slop_) {
+			slop = slop_;
+			if (slop < 0.0f) slop = 0.0f;
+		}
+		void SetBounceThreshold(const float& bounceThreshold_) {
+			bounceThreshold = bounceThreshold_;
+			if (bounceThreshold < 0.0f) bounceThreshold = 0.0f;
+		}
+		void SetLargeIslandSize(const unsigned int& largeIslandSize_) {
+			largeIslandSize = largeIslandSize_;
+			if (largeIslandSize < 1) largeIslandSize = 1;
+		}
+		void SetJobSystem(Jobs::JobSystem* jobs_) { jobs = jobs_; }
+
+	};
+
+}
+
+#endif // !PHYSICS_CONTACT_SOLVER_HPP
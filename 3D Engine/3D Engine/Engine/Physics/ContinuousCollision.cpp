@@ -0,0 +1,127 @@
+#include "ContinuousCollision.hpp"
+#include <cmath>
+
+namespace Physics {
+
+	const ContinuousCollision::TimeOfImpactFunc ContinuousCollision::timeOfImpacts[CollisionShapeCount][CollisionShapeCount] = {
+		// None
+		{ nullptr, nullptr },
+		// Sphere
+		{ nullptr, ContinuousCollision::SphereSphere },
+	};
+
+	bool ContinuousCollision::SphereTimeOfImpact(const Math::Vector3& centerA, const Math::Vector3& motionA, const float& radiusA,
+												 const Math::Vector3& centerB, const Math::Vector3& motionB, const float& radiusB,
+												 const float& target, const float& tolerance, const unsigned int& maxIterations, float& t) {
+		Math::Vector3 relMotion = motionB - motionA;
+		float speed = relMotion.Magnitude();
+		if (speed <= 0.0f) return false;
+
+		float radius = radiusA + radiusB;
+		Math::Vector3 offset = centerB - centerA;
+
+		// bodies that already touch are left to the contact solver
+		if (Math::Vector3::Dot(offset, offset) < radius * radius) return false;
+
+		// the gap cant close faster than the relative speed so moving by gap / speed never passes the impact
+		t = 0.0f;
+		for (unsigned int i = 0; i < maxIterations; ++i) {
+			float gap = (offset + relMotion * t).Magnitude() - radius - target;
+			if (gap <= tolerance) return true;
+
+			t += gap / speed;
+			if (t > 1.0f) return false;
+		}
+		return true;
+	}
+
+	bool ContinuousCollision::SphereSphere(const ContinuousCollision& ccd, const BodyStorage& storage,
+										   const unsigned int& a, const Math::Vector3& motionA,
+										   const unsigned int& b, const Math::Vector3& motionB, float& t) {
+		const SphereTable& spheres = storage.spheres;
+		unsigned int sa = storage.shapeSlots[a];
+		unsigned int sb = storage.shapeSlots[b];
+		return SphereTimeOfImpact(spheres.GetCenter(sa, storage.positions[a]), motionA, spheres.radii[sa],
+								  spheres.GetCenter(sb, storage.positions[b]), motionB, spheres.radii[sb],
+								  ccd.target, ccd.tolerance, ccd.maxIterations, t);
+	}
+
+	void ContinuousCollision::Sweep(const BodyStorage& storage, const Broadphase& broadphase, const float& dt) {
+		bullets.clear();
+		fractions.clear();
+		hits = 0;
+
+		// only bodies that asked for it and are moving fast enough are swept
+		const unsigned char mask = BodyFlags::Simulated | BodyFlags::Dynamic | BodyFlags::Awake
+			| BodyFlags::Continuous | BodyFlags::InBroadphase;
+		for (unsigned int i = 0; i < storage.size(); ++i) {
+			if ((storage.flags[i] & mask) != mask) continue;
+			if (storage.shapes[i] != CollisionShape::Sphere) continue;
+
+			float speed = storage.continuousSpeeds[i];
+			const Math::Vector3& v = storage.velocities[i];
+			if (Math::Vector3::Dot(v, v) <= speed * speed) continue;
+
+			bullets.push_back(i);
+		}
+		if (bullets.empty()) return;
+		fractions.resize(bullets.size(), 1.0f);
+
+		if (jobs) {
+			jobs->ParallelFor(bullets.size(), 16, [&](size_t begin, size_t end) {
+				SweepRange(storage, broadphase, dt, begin, end);
+			});
+		} else {
+			SweepRange(storage, broadphase, dt, 0, bullets.size());
+		}
+
+		for (float t : fractions)
+			if (t < 1.0f) ++hits;
+	}
+
+	void ContinuousCollision::SweepRange(const BodyStorage& storage, const Broadphase& broadphase, const float& dt, const size_t& begin, const size_t& end) {
+		// each chunk gets its own results so the queries dont share anything
+		DArray<BodyHandle> candidates;
+
+		for (size_t k = begin; k < end; ++k) {
+			unsigned int i = bullets[k];
+			Math::Vector3 motion = storage.velocities[i] * dt;
+
+			// the bounds of the sphere at the start and end of the timestep
+			Math::Bounds3D swept = Math::Bounds3D::Combine(
+				storage.spheres.GetBounds(storage.shapeSlots[i], storage.positions[i]),
+				storage.spheres.GetBounds(storage.shapeSlots[i], storage.positions[i] + motion));
+			broadphase.Query(swept, candidates);
+
+			const TimeOfImpactFunc* row = timeOfImpacts[static_cast<size_t>(storage.shapes[i])];
+			float first = 1.0f;
+			for (const BodyHandle& handle : candidates) {
+				if (!storage.IsValid(handle)) continue;
+				unsigned int j = storage.GetIndex(handle);
+				if (j == i) continue;
+
+				TimeOfImpactFunc toi = row[static_cast<size_t>(storage.shapes[j])];
+				if (!toi) continue;
+
+				// the other body moves too if the integrator is going to move it
+				Math::Vector3 other = storage.IsMoving(j) ? storage.velocities[j] * dt : Math::Vector3(0.0f);
+				float t;
+				if (toi(*this, storage, i, motion, j, other, t) && t < first) first = t;
+			}
+			fractions[k] = first;
+		}
+	}
+
+	void ContinuousCollision::Clamp(BodyStorage& storage, const float& dt) {
+		for (size_t k = 0; k < bullets.size(); ++k) {
+			float t = fractions[k];
+			if (t >= 1.0f) continue;
+
+			// the bullet loses the rest of the timestep, its velocity is kept so the contact stops it next timestep
+			unsigned int i = bullets[k];
+			storage.positions[i] -= storage.velocities[i] * (dt * (1.0f - t));
+			storage.flags[i] |= BodyFlags::BoundsDirty;
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#ifndef PHYSICS_CONTINUOUS_COLLISION_HPP
+#define PHYSICS_CONTINUOUS_COLLISION_HPP
+#include "BodyStorage.hpp"
+#include "Broadphase.hpp"
+#include "../Jobs/JobSystem.hpp"
+
+namespace Physics {
+
+	// stops fast bodies from tunneling through thin bodies in one timestep
+	// bodies with the Continuous flag moving faster than their continuous speed are swept through the broadphase
+	// and stopped at the first time of impact, the contact solver handles the hit in the next timestep
+	class ContinuousCollision {
+	public:
+
+		// finds the fraction of the timestep where body a moving by motionA first touches body b moving by motionB
+		// returns false if they dont touch before the end of the timestep
+		typedef bool(*TimeOfImpactFunc)(const ContinuousCollision& ccd, const BodyStorage& storage,
+										const unsigned int& a, const Math::Vector3& motionA,
+										const unsigned int& b, const Math::Vector3& motionB, float& t);
+
+	private:
+
+		// the dense indices of the bodies swept this timestep
+		DArray<unsigned int> bullets;
+		// the fraction of the timestep each bullet can move, 1 if it hit nothing
+		DArray<float> fractions;
+		unsigned int hits;
+
+		// how close the advancement has to get before it counts as touching
+		float tolerance;
+		// the separation the bodies are stopped at, negative so they overlap a little and make a contact
+		float target;
+		// the most steps of conservative advancement per pair
+		unsigned int maxIterations;
+
+		// nullptr runs on the calling thread
+		Jobs::JobSystem* jobs;
+
+		// the time of impact test for every pair of shapes indexed by [shape of a][shape of b]
+		// nullptr for shapes that are never swept
+		static const TimeOfImpactFunc timeOfImpacts[CollisionShapeCount][CollisionShapeCount];
+
+		static bool SphereSphere(const ContinuousCollision& ccd, const BodyStorage& storage,
+								 const unsigned int& a, const Math::Vector3& motionA,
+								 const unsigned int& b, const Math::Vector3& motionB, float& t);
+
+		// sweeps bullets [begin, end) through the broadphase
+		void SweepRange(const BodyStorage& storage, const Broadphase& broadphase, const float& dt, const size_t& begin, const size_t& end);
+
+	public:
+
+		ContinuousCollision()
+			: hits(0), tolerance(0.001f), target(-0.005f), maxIterations(20), jobs(nullptr) { }
+
+		// finds the time of impact of every fast body using the velocities it is about to be moved by
+		// call after the velocities are solved and before the positions are integrated
+		void Sweep(const BodyStorage& storage, const Broadphase& broadphase, const float& dt);
+
+		// moves the bullets that hit something back to their time of impact
+		// call after the positions are integrated
+		void Clamp(BodyStorage& storage, const float& dt);
+
+		// conservative advancement of two spheres moving in straight lines
+		// t is the fraction of the motion where their surfaces are target apart
+		static bool SphereTimeOfImpact(const Math::Vector3& centerA, const Math::Vector3& motionA, const float& radiusA,
+									   const Math::Vector3& centerB, const Math::Vector3& motionB, const float& radiusB,
+									   const float& target, const float& tolerance, const unsigned int& maxIterations, float& t);
+
+		/// getters
+
+		// how many bodies were swept in the last timestep
+		size_t GetBulletCount() const { return bullets.size(); }
+		// how many of them were stopped early
+		unsigned int GetHitCount() const { return hits; }
+		float GetTolerance() const { return tolerance; }
+		float GetTarget() const { return target; }
+		unsigned int GetMaxIterations() const { return maxIterations; }
+		Jobs::JobSystem* GetJobSystem() const { return jobs; }
+
+		/// setters
+
+		void SetTolerance(const float& tolerance_) {
+			tolerance = tolerance_;
+			if (tolerance < 0.00001f) tolerance = 0.00001f;
+		}
+		void SetTarget(const float& target_) { target = target_; }
+		void SetMaxIterations(const unsigned int& maxIterations_) {
+			maxIterations = maxIterations_;
+			if (maxIterations == 0) maxIterations = 1;
+		}
+		void SetJobSystem(Jobs::JobSystem* jobs_) { jobs = jobs_; }
+
+	};
+
+}
+
+#endif // !PHYSICS_CONTINUOUS_COLLISION_HPP
\ No newline at end of file
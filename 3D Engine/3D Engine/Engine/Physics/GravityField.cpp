@@ -0,0 +1,67 @@
+#include "GravityField.hpp"
+
+namespace Physics {
+
+	using Math::Vector3;
+
+	void GravityField::Apply(BodyStorage& storage) {
+		Vector3* accelerations = storage.fieldAccelerations.data();
+		const size_t count = storage.size();
+
+		if (wells.empty()) {
+			if (active) storage.fieldAccelerations.fill(Vector3(0.0f));
+			active = false;
+			return;
+		}
+		active = true;
+
+		// short range wells go in the grid, the rest are left to the mode
+		grid.Build(wells, gridRange, inGrid);
+		farWells.clear();
+		for (size_t w = 0; w < wells.size(); ++w) {
+			if (inGrid[w]) continue;
+			Vector3 position(wells.x[w], wells.y[w], wells.z[w]);
+			farWells.push_back(position, wells.gravity[w], wells.range[w], wells.owners[w]);
+		}
+		if (mode == GravityMode::BarnesHut) tree.Build(farWells);
+		const bool hasFar = !farWells.empty();
+
+		auto evaluate = [this, &storage, accelerations, hasFar](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				if (!storage.IsMoving(static_cast<unsigned int>(i))) {
+					accelerations[i] = Vector3(0.0f);
+					continue;
+				}
+
+				unsigned int owner = static_cast<unsigned int>(i);
+				const Vector3& point = storage.positions[i];
+				Vector3 acceleration = grid.Evaluate(point, owner, softening);
+				if (hasFar) {
+					if (mode == GravityMode::BarnesHut) acceleration += tree.Evaluate(farWells, point, owner, theta, softening);
+					else acceleration += EvaluateDirect(point, owner);
+				}
+				accelerations[i] = acceleration;
+			}
+		};
+
+		if (jobs) jobs->ParallelFor(count, 64, evaluate);
+		else evaluate(0, count);
+	}
+
+	Vector3 GravityField::EvaluateDirect(const Vector3& point, const unsigned int& owner) const {
+		const float softeningSq = softening * softening;
+		Vector3 acceleration(0.0f);
+
+		for (size_t w = 0; w < farWells.size(); ++w) {
+			if (farWells.owners[w] == owner) continue;
+
+			Vector3 offset(farWells.x[w] - point.x, farWells.y[w] - point.y, farWells.z[w] - point.z);
+			float distSq = Vector3::Dot(offset, offset);
+			if (distSq > farWells.range[w] * farWells.range[w]) continue;
+			acceleration += WellAcceleration(offset, distSq, farWells.gravity[w], softeningSq);
+		}
+
+		return acceleration;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef PHYSICS_GRAVITY_FIELD_HPP
+#define PHYSICS_GRAVITY_FIELD_HPP
+#include "BodyStorage.hpp"
+#include "WellTree.hpp"
+#include "WellGrid.hpp"
+#include "../Jobs/JobSystem.hpp"
+
+namespace Physics {
+
+	// how the pull of the long range gravity wells is added up
+	enum class GravityMode : unsigned char { Direct, BarnesHut };
+
+	// works out the acceleration the gravity wells give every moving body
+	// a well pulls with gravity / distance^2 on bodies within its range
+	// short range wells are put in a grid and summed exactly, the rest go through the mode
+	class GravityField {
+
+		GravityMode mode;
+		// wells with this range or less go in the grid
+		float gridRange;
+		// how small a node has to look before barnes hut treats it as one well, 0 is exact
+		float theta;
+		// stops the pull from blowing up when a body is on top of a well
+		float softening;
+
+		WellSet wells;
+		WellGrid grid;
+		// the wells that are not in the grid
+		WellSet farWells;
+		WellTree tree;
+		DArray<bool> inGrid;
+
+		// the field accelerations were written last timestep and need clearing if there are no wells
+		bool active;
+
+		// nullptr runs on the calling thread
+		Jobs::JobSystem* jobs;
+
+		// the acceleration at point from every far well, the slow way
+		Math::Vector3 EvaluateDirect(const Math::Vector3& point, const unsigned int& owner) const;
+
+	public:
+
+		GravityField()
+			: mode(GravityMode::BarnesHut), gridRange(10.0f), theta(0.5f), softening(0.1f), active(false), jobs(nullptr) { }
+
+		// writes the acceleration from the wells into the field accelerations of every moving body
+		// the wells must have been gathered into GetWells() first
+		void Apply(BodyStorage& storage);
+
+		/// getters
+
+		GravityMode GetMode() const { return mode; }
+		float GetGridRange() const { return gridRange; }
+		float GetTheta() const { return theta; }
+		float GetSoftening() const { return softening; }
+		WellSet& GetWells() { return wells; }
+		const WellSet& GetWells() const { return wells; }
+		const WellGrid& GetGrid() const { return grid; }
+		WellGrid& GetGrid() { return grid; }
+		const WellTree& GetTree() const { return tree; }
+		Jobs::JobSystem* GetJobSystem() const { return jobs; }
+
+		/// setters
+
+		void SetMode(const GravityMode& mode_) { mode = mode_; }
+		// 0 leaves every well with a range to the mode
+		void SetGridRange(const float& gridRange_) {
+			gridRange = gridRange_;
+			if (gridRange < 0.0f) gridRange = 0.0f;
+		}
+		void SetTheta(const float& theta_) {
+			theta = theta_;
+			if (theta < 0.0f) theta = 0.0f;
+		}
+		void SetSoftening(const float& softening_) {
+			softening = softening_;
+			if (softening < 0.0f) softening = 0.0f;
+		}
+		void SetJobSystem(Jobs::JobSystem* jobs_) { jobs = jobs_; }
+
+	};
+
+}
+
+#endif // !PHYSICS_GRAVITY_FIELD_HPP
\ No newline at end of file
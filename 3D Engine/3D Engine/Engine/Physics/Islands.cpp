@@ -0,0 +1,92 @@
+#include "Islands.hpp"
+
+namespace Physics {
+
+	unsigned int Islands::Find(unsigned int index) {
+		// path halving keeps the trees flat without recursion
+		while (parents[index] != index) {
+			parents[index] = parents[parents[index]];
+			index = parents[index];
+		}
+		return index;
+	}
+
+	void Islands::Union(unsigned int a, unsigned int b) {
+		a = Find(a);
+		b = Find(b);
+		if (a == b) return;
+
+		// the lower index always becomes the root so the islands come out in the same order every time
+		if (a < b) parents[b] = a;
+		else parents[a] = b;
+	}
+
+	void Islands::Build(const BodyStorage& storage, const ContactCache& cache) {
+		const unsigned char mask = BodyFlags::Simulated | BodyFlags::Dynamic;
+		const unsigned char* flags = storage.flags.data();
+		const size_t count = storage.size();
+
+		parents.resize(count);
+		for (size_t i = 0; i < count; ++i)
+			parents[i] = static_cast<unsigned int>(i);
+
+		// join the bodies through their contacts
+		const DArray<Contact>& cached = cache.GetContacts();
+		for (const Contact& c : cached) {
+			if (!c.touching) continue;
+			unsigned int ia = storage.GetIndex(c.pair.a);
+			unsigned int ib = storage.GetIndex(c.pair.b);
+			if ((flags[ia] & mask) == mask && (flags[ib] & mask) == mask)
+				Union(ia, ib);
+		}
+
+		// number the roots in order
+		bodyIslands.resize(count);
+		unsigned int islandCount = 0;
+		for (size_t i = 0; i < count; ++i) {
+			if ((flags[i] & mask) != mask) {
+				bodyIslands[i] = None;
+				continue;
+			}
+			unsigned int root = Find(static_cast<unsigned int>(i));
+			if (root == i) bodyIslands[i] = islandCount++;
+			else bodyIslands[i] = bodyIslands[root];
+		}
+
+		// counting sort the bodies into their islands, keeping them in dense order
+		bodyStarts.resize(islandCount + 1);
+		bodyStarts.fill(0);
+		for (size_t i = 0; i < count; ++i)
+			if (bodyIslands[i] != None) ++bodyStarts[bodyIslands[i] + 1];
+		for (unsigned int i = 0; i < islandCount; ++i)
+			bodyStarts[i + 1] += bodyStarts[i];
+
+		cursors = bodyStarts;
+		bodies.resize(bodyStarts[islandCount]);
+		for (size_t i = 0; i < count; ++i)
+			if (bodyIslands[i] != None) bodies[cursors[bodyIslands[i]]++] = static_cast<unsigned int>(i);
+
+		// a contact goes in the island of its dynamic body
+		contactIslands.resize(cached.size());
+		contactStarts.resize(islandCount + 1);
+		contactStarts.fill(0);
+		for (size_t i = 0; i < cached.size(); ++i) {
+			const Contact& c = cached[i];
+			unsigned int island = None;
+			if (c.touching) {
+				island = bodyIslands[storage.GetIndex(c.pair.a)];
+				if (island == None) island = bodyIslands[storage.GetIndex(c.pair.b)];
+			}
+			contactIslands[i] = island;
+			if (island != None) ++contactStarts[island + 1];
+		}
+		for (unsigned int i = 0; i < islandCount; ++i)
+			contactStarts[i + 1] += contactStarts[i];
+
+		cursors = contactStarts;
+		contacts.resize(contactStarts[islandCount]);
+		for (size_t i = 0; i < cached.size(); ++i)
+			if (contactIslands[i] != None) contacts[cursors[contactIslands[i]]++] = static_cast<unsigned int>(i);
+	}
+
+}
\ No newline at end of file
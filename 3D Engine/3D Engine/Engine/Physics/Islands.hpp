@@ -0,0 +1,52 @@
+#ifndef PHYSICS_ISLANDS_HPP
+#define PHYSICS_ISLANDS_HPP
+#include "BodyStorage.hpp"
+#include "ContactCache.hpp"
+
+namespace Physics {
+
+	// splits the simulated dynamic bodies into groups that touch each other
+	// static bodies dont join islands so two piles on the same floor are separate islands
+	class Islands {
+
+		// union find forest over the dense body indices
+		DArray<unsigned int> parents;
+
+		// scratch for the counting sorts
+		DArray<unsigned int> cursors;
+		DArray<unsigned int> contactIslands;
+
+		unsigned int Find(unsigned int index);
+		void Union(unsigned int a, unsigned int b);
+
+	public:
+
+		static const unsigned int None = 0xffffffff;
+
+		// the island of every body, None for bodies that are not in one
+		DArray<unsigned int> bodyIslands;
+
+		/// island i owns bodies [bodyStarts[i], bodyStarts[i + 1]) and contacts [contactStarts[i], contactStarts[i + 1])
+
+		DArray<unsigned int> bodyStarts;
+		DArray<unsigned int> bodies;
+		DArray<unsigned int> contactStarts;
+		DArray<unsigned int> contacts;
+
+		// groups the bodies through the touching contacts in the cache
+		void Build(const BodyStorage& storage, const ContactCache& cache);
+
+		/// getters
+
+		// the number of islands
+		size_t size() const { return bodyStarts.empty() ? 0 : bodyStarts.size() - 1; }
+		unsigned int GetBodyCount(const size_t& island) const { return bodyStarts[island + 1] - bodyStarts[island]; }
+		unsigned int GetContactCount(const size_t& island) const { return contactStarts[island + 1] - contactStarts[island]; }
+		const unsigned int* GetBodies(const size_t& island) const { return bodies.data() + bodyStarts[island]; }
+		const unsigned int* GetContacts(const size_t& island) const { return contacts.data() + contactStarts[island]; }
+
+	};
+
+}
+
+#endif // !PHYSICS_ISLANDS_HPP
\ No newline at end of file
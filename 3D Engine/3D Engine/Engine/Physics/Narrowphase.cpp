@@ -0,0 +1,218 @@
+#include "Narrowphase.hpp"
+#include "../Math/SIMD.hpp"
+#include <cmath>
+
+namespace Physics {
+
+	// spheres closer than this are treated as being at the same point
+	static const float CoincidentDistanceSq = 1e-12f;
+
+	void SpherePairBatch::clear() {
+		pairs.clear();
+		ax.clear(); ay.clear(); az.clear(); ar.clear();
+		bx.clear(); by.clear(); bz.clear(); br.clear();
+		count = 0;
+	}
+
+	void SpherePairBatch::push_back(const BodyPair& pair, const Math::Vector3& a, const float& aRadius,
+									const Math::Vector3& b, const float& bRadius) {
+		pairs.push_back(pair);
+		ax.push_back(a.x); ay.push_back(a.y); az.push_back(a.z); ar.push_back(aRadius);
+		bx.push_back(b.x); by.push_back(b.y); bz.push_back(b.z); br.push_back(bRadius);
+		++count;
+	}
+
+	void SpherePairBatch::Pad() {
+		// two points with no radius one unit apart never touch
+		size_t padded = (count + 7) & ~static_cast<size_t>(7);
+		ax.resize(padded, 0.0f); ay.resize(padded, 0.0f); az.resize(padded, 0.0f); ar.resize(padded, 0.0f);
+		bx.resize(padded, 1.0f); by.resize(padded, 0.0f); bz.resize(padded, 0.0f); br.resize(padded, 0.0f);
+	}
+
+	const Narrowphase::PairGatherer Narrowphase::gatherers[CollisionShapeCount][CollisionShapeCount] = {
+		// None
+		{ nullptr, nullptr },
+		// Sphere
+		{ nullptr, Narrowphase::GatherSphereSphere },
+	};
+
+	Narrowphase::Narrowphase() : sphereKernel(nullptr), kernelType(KernelType::Scalar) {
+		SetKernelType(KernelType::AVX2);
+	}
+
+	void Narrowphase::SetKernelType(KernelType type) {
+		// sse2 is always there on x86-64 so only avx2 has to be checked
+		if (type == KernelType::AVX2 && !Math::SIMD::HasAVX2())
+			type = KernelType::SSE;
+
+		kernelType = type;
+		switch (type) {
+			case KernelType::AVX2: sphereKernel = SphereKernelAVX2; break;
+			case KernelType::SSE: sphereKernel = SphereKernelSSE; break;
+			case KernelType::Scalar:
+			default: sphereKernel = SphereKernelScalar; break;
+		}
+	}
+
+	void Narrowphase::Run(const BodyStorage& storage, const DArray<BodyPair>& pairs) {
+		contacts.clear();
+		GatherPairs(storage, pairs);
+		if (spheres.count == 0) return;
+
+		sphereKernel(spheres, 0, spheres.count, contacts);
+	}
+
+	void Narrowphase::GatherPairs(const BodyStorage& storage, const DArray<BodyPair>& pairs) {
+		spheres.clear();
+
+		for (const BodyPair& pair : pairs) {
+			unsigned int ia = storage.GetIndex(pair.a);
+			unsigned int ib = storage.GetIndex(pair.b);
+			// nothing changes between bodies that are not moving
+			if (!storage.IsMoving(ia) && !storage.IsMoving(ib)) continue;
+
+			PairGatherer gather = gatherers[static_cast<size_t>(storage.shapes[ia])][static_cast<size_t>(storage.shapes[ib])];
+			if (gather) gather(*this, storage, pair, ia, ib);
+		}
+
+		spheres.Pad();
+	}
+
+	void Narrowphase::GatherSphereSphere(Narrowphase& narrowphase, const BodyStorage& storage, const BodyPair& pair,
+										 const unsigned int& a, const unsigned int& b) {
+		const SphereTable& table = storage.spheres;
+		unsigned int sa = storage.shapeSlots[a];
+		unsigned int sb = storage.shapeSlots[b];
+		narrowphase.spheres.push_back(pair,
+									  table.GetCenter(sa, storage.positions[a]), table.radii[sa],
+									  table.GetCenter(sb, storage.positions[b]), table.radii[sb]);
+	}
+
+	void Narrowphase::SphereKernelScalar(const SpherePairBatch& batch, size_t begin, size_t end, ContactBuffer& contacts) {
+		for (size_t i = begin; i < end; ++i) {
+			float dx = batch.bx[i] - batch.ax[i];
+			float dy = batch.by[i] - batch.ay[i];
+			float dz = batch.bz[i] - batch.az[i];
+			float distSq = dx * dx + dy * dy + dz * dz;
+			float radii = batch.ar[i] + batch.br[i];
+			if (distSq >= radii * radii) continue;
+
+			// pick an up normal if the centers are on top of each other
+			float nx = 0.0f, ny = 1.0f, nz = 0.0f;
+			float dist = sqrtf(distSq);
+			if (distSq > CoincidentDistanceSq) {
+				float inv = 1.0f / dist;
+				nx = dx * inv; ny = dy * inv; nz = dz * inv;
+			}
+
+			float depth = radii - dist;
+			float offset = batch.ar[i] - depth * 0.5f;
+			contacts.push_back(batch.pairs[i], nx, ny, nz, depth,
+							   batch.ax[i] + nx * offset, batch.ay[i] + ny * offset, batch.az[i] + nz * offset);
+		}
+	}
+
+	void Narrowphase::SphereKernelSSE(const SpherePairBatch& batch, size_t begin, size_t end, ContactBuffer& contacts) {
+		const __m128 half = _mm_set1_ps(0.5f);
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 coincident = _mm_set1_ps(CoincidentDistanceSq);
+
+		alignas(16) float nx[4], ny[4], nz[4], depth[4], px[4], py[4], pz[4];
+
+		// the columns are padded to 8 so whole blocks can always be loaded
+		for (size_t i = begin; i < end; i += 4) {
+			__m128 ax = _mm_loadu_ps(&batch.ax[i]);
+			__m128 ay = _mm_loadu_ps(&batch.ay[i]);
+			__m128 az = _mm_loadu_ps(&batch.az[i]);
+			__m128 dx = _mm_sub_ps(_mm_loadu_ps(&batch.bx[i]), ax);
+			__m128 dy = _mm_sub_ps(_mm_loadu_ps(&batch.by[i]), ay);
+			__m128 dz = _mm_sub_ps(_mm_loadu_ps(&batch.bz[i]), az);
+			__m128 ar = _mm_loadu_ps(&batch.ar[i]);
+			__m128 radii = _mm_add_ps(ar, _mm_loadu_ps(&batch.br[i]));
+
+			__m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			int mask = _mm_movemask_ps(_mm_cmplt_ps(distSq, _mm_mul_ps(radii, radii)));
+			if (end - i < 4) mask &= (1 << (end - i)) - 1;
+			if (mask == 0) continue;
+
+			// normalize, lanes with coincident centers get an up normal
+			__m128 dist = _mm_sqrt_ps(distSq);
+			__m128 apart = _mm_cmpgt_ps(distSq, coincident);
+			__m128 inv = _mm_and_ps(apart, _mm_div_ps(one, _mm_max_ps(dist, coincident)));
+			__m128 vnx = _mm_mul_ps(dx, inv);
+			__m128 vny = _mm_or_ps(_mm_mul_ps(dy, inv), _mm_andnot_ps(apart, one));
+			__m128 vnz = _mm_mul_ps(dz, inv);
+
+			__m128 vdepth = _mm_sub_ps(radii, dist);
+			__m128 offset = _mm_sub_ps(ar, _mm_mul_ps(vdepth, half));
+
+			_mm_store_ps(nx, vnx);
+			_mm_store_ps(ny, vny);
+			_mm_store_ps(nz, vnz);
+			_mm_store_ps(depth, _mm_max_ps(vdepth, zero));
+			_mm_store_ps(px, _mm_add_ps(ax, _mm_mul_ps(vnx, offset)));
+			_mm_store_ps(py, _mm_add_ps(ay, _mm_mul_ps(vny, offset)));
+			_mm_store_ps(pz, _mm_add_ps(az, _mm_mul_ps(vnz, offset)));
+
+			// append only the touching lanes
+			for (int l = 0; l < 4; ++l) {
+				if (!(mask & (1 << l))) continue;
+				contacts.push_back(batch.pairs[i + l], nx[l], ny[l], nz[l], depth[l], px[l], py[l], pz[l]);
+			}
+		}
+	}
+
+	MATH_TARGET_AVX2
+	void Narrowphase::SphereKernelAVX2(const SpherePairBatch& batch, size_t begin, size_t end, ContactBuffer& contacts) {
+		const __m256 half = _mm256_set1_ps(0.5f);
+		const __m256 one = _mm256_set1_ps(1.0f);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 coincident = _mm256_set1_ps(CoincidentDistanceSq);
+
+		alignas(32) float nx[8], ny[8], nz[8], depth[8], px[8], py[8], pz[8];
+
+		// the columns are padded to 8 so whole blocks can always be loaded
+		for (size_t i = begin; i < end; i += 8) {
+			__m256 ax = _mm256_loadu_ps(&batch.ax[i]);
+			__m256 ay = _mm256_loadu_ps(&batch.ay[i]);
+			__m256 az = _mm256_loadu_ps(&batch.az[i]);
+			__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&batch.bx[i]), ax);
+			__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&batch.by[i]), ay);
+			__m256 dz = _mm256_sub_ps(_mm256_loadu_ps(&batch.bz[i]), az);
+			__m256 ar = _mm256_loadu_ps(&batch.ar[i]);
+			__m256 radii = _mm256_add_ps(ar, _mm256_loadu_ps(&batch.br[i]));
+
+			__m256 distSq = _mm256_fmadd_ps(dz, dz, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dx, dx)));
+			int mask = _mm256_movemask_ps(_mm256_cmp_ps(distSq, _mm256_mul_ps(radii, radii), _CMP_LT_OQ));
+			if (end - i < 8) mask &= (1 << (end - i)) - 1;
+			if (mask == 0) continue;
+
+			// normalize, lanes with coincident centers get an up normal
+			__m256 dist = _mm256_sqrt_ps(distSq);
+			__m256 apart = _mm256_cmp_ps(distSq, coincident, _CMP_GT_OQ);
+			__m256 inv = _mm256_and_ps(apart, _mm256_div_ps(one, _mm256_max_ps(dist, coincident)));
+			__m256 vnx = _mm256_mul_ps(dx, inv);
+			__m256 vny = _mm256_or_ps(_mm256_mul_ps(dy, inv), _mm256_andnot_ps(apart, one));
+			__m256 vnz = _mm256_mul_ps(dz, inv);
+
+			__m256 vdepth = _mm256_sub_ps(radii, dist);
+			__m256 offset = _mm256_fnmadd_ps(vdepth, half, ar);
+
+			_mm256_store_ps(nx, vnx);
+			_mm256_store_ps(ny, vny);
+			_mm256_store_ps(nz, vnz);
+			_mm256_store_ps(depth, _mm256_max_ps(vdepth, zero));
+			_mm256_store_ps(px, _mm256_fmadd_ps(vnx, offset, ax));
+			_mm256_store_ps(py, _mm256_fmadd_ps(vny, offset, ay));
+			_mm256_store_ps(pz, _mm256_fmadd_ps(vnz, offset, az));
+
+			// append only the touching lanes
+			for (int l = 0; l < 8; ++l) {
+				if (!(mask & (1 << l))) continue;
+				contacts.push_back(batch.pairs[i + l], nx[l], ny[l], nz[l], depth[l], px[l], py[l], pz[l]);
+			}
+		}
+	}
+
+}
\ No newline at end of file
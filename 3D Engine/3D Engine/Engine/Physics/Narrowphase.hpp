@@ -0,0 +1,120 @@
+#ifndef PHYSICS_NARROWPHASE_HPP
+#define PHYSICS_NARROWPHASE_HPP
+#include "BodyStorage.hpp"
+#include "Broadphase.hpp"
+
+namespace Physics {
+
+	// the contacts found by the narrowphase stored as packed columns
+	// contact i is between pairs[i].a and pairs[i].b
+	struct ContactBuffer {
+		DArray<BodyPair> pairs;
+		// the normal points from a to b
+		DArray<float> normalX;
+		DArray<float> normalY;
+		DArray<float> normalZ;
+		// how far the shapes overlap along the normal
+		DArray<float> depths;
+		// the point halfway between the two surfaces
+		DArray<float> pointX;
+		DArray<float> pointY;
+		DArray<float> pointZ;
+
+		size_t size() const { return pairs.size(); }
+
+		void clear() {
+			pairs.clear();
+			normalX.clear(); normalY.clear(); normalZ.clear();
+			depths.clear();
+			pointX.clear(); pointY.clear(); pointZ.clear();
+		}
+
+		void push_back(const BodyPair& pair, const float& nx, const float& ny, const float& nz,
+					   const float& depth, const float& px, const float& py, const float& pz) {
+			pairs.push_back(pair);
+			normalX.push_back(nx); normalY.push_back(ny); normalZ.push_back(nz);
+			depths.push_back(depth);
+			pointX.push_back(px); pointY.push_back(py); pointZ.push_back(pz);
+		}
+	};
+
+	// the sphere pairs gathered from the broadphase, one column per component
+	// padded to a multiple of 8 so the kernels never read past the end
+	struct SpherePairBatch {
+		DArray<BodyPair> pairs;
+		DArray<float> ax, ay, az, ar;
+		DArray<float> bx, by, bz, br;
+
+		size_t count;
+
+		SpherePairBatch() : count(0) { }
+
+		void clear();
+		void push_back(const BodyPair& pair, const Math::Vector3& a, const float& aRadius,
+					   const Math::Vector3& b, const float& bRadius);
+		// pads every column with pairs that can never touch
+		void Pad();
+	};
+
+	// turns the broadphase pairs into contacts
+	class Narrowphase {
+	public:
+
+		// tests pairs [begin, end) of the batch and appends the touching ones to contacts
+		// begin must be a multiple of 8
+		typedef void(*SphereKernel)(const SpherePairBatch& batch, size_t begin, size_t end, ContactBuffer& contacts);
+
+		// which kernel tests sphere pairs
+		enum class KernelType : unsigned char { Scalar, SSE, AVX2 };
+
+		// copies the bodies a and b of the pair into the batch for their pair of shapes
+		typedef void(*PairGatherer)(Narrowphase& narrowphase, const BodyStorage& storage, const BodyPair& pair,
+									const unsigned int& a, const unsigned int& b);
+
+	private:
+
+		SpherePairBatch spheres;
+		ContactBuffer contacts;
+
+		SphereKernel sphereKernel;
+		KernelType kernelType;
+
+		// the gatherer for every pair of shapes indexed by [shape of a][shape of b]
+		// nullptr for shapes that never collide
+		static const PairGatherer gatherers[CollisionShapeCount][CollisionShapeCount];
+
+		// sorts the pairs into a batch per pair of shapes
+		void GatherPairs(const BodyStorage& storage, const DArray<BodyPair>& pairs);
+
+		static void GatherSphereSphere(Narrowphase& narrowphase, const BodyStorage& storage, const BodyPair& pair,
+									   const unsigned int& a, const unsigned int& b);
+
+	public:
+
+		// picks the widest kernel the cpu can run
+		Narrowphase();
+
+		// finds the contacts between the pairs
+		void Run(const BodyStorage& storage, const DArray<BodyPair>& pairs);
+
+		/// getters
+
+		const ContactBuffer& GetContacts() const { return contacts; }
+		KernelType GetKernelType() const { return kernelType; }
+
+		/// setters
+
+		// forces a kernel, falls back to a narrower one if the cpu cant run it
+		void SetKernelType(KernelType type);
+
+		/// kernels
+
+		static void SphereKernelScalar(const SpherePairBatch& batch, size_t begin, size_t end, ContactBuffer& contacts);
+		static void SphereKernelSSE(const SpherePairBatch& batch, size_t begin, size_t end, ContactBuffer& contacts);
+		static void SphereKernelAVX2(const SpherePairBatch& batch, size_t begin, size_t end, ContactBuffer& contacts);
+
+	};
+
+}
+
+#endif // !PHYSICS_NARROWPHASE_HPP
\ No newline at end of file
@@ -7,4 +7,10 @@ namespace Physics {
 		return position + body->GetPosition();
 	}
 
+	void GravityWell::WakeAffected() {
+		if (!body) return;
+		Math::Vector3 center = GetWorldPosition();
+		body->WakeRegion(Math::Bounds3D(center - Math::Vector3(range), center + Math::Vector3(range)));
+	}
+
 }
\ No newline at end of file
@@ -15,15 +15,41 @@ namespace Physics {
 		// the range of the gravity well
 		float range;
 
+		// wakes the sleeping bodies in range so they feel the change
+		void WakeAffected();
+
 	public:
 
-		GravityWell() { }
+		static const PropertyType Type = PropertyType::GravityWell;
+
+		GravityWell() : position(0.0f), gravity(9.81f), range(100.0f) { }
 		~GravityWell() { }
 
 		/// getters
 
 		Math::Vector3 GetPosition() const { return position; }
 		Math::Vector3 GetWorldPosition() const;
+		float GetGravity() const { return gravity; }
+		float GetRange() const { return range; }
+
+		/// setters
+
+		void SetPosition(const Math::Vector3& position_) {
+			WakeAffected();
+			position = position_;
+			WakeAffected();
+		}
+		void SetGravity(const float& gravity_) {
+			gravity = gravity_;
+			WakeAffected();
+		}
+		void SetRange(const float& range_) {
+			// wake the bodies in the larger of the two ranges
+			if (range_ < range) WakeAffected();
+			range = range_;
+			if (range < 0.0f) range = 0.0f;
+			WakeAffected();
+		}
 
 	};
 
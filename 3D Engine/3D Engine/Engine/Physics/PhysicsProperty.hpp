@@ -1,20 +1,36 @@
 #ifndef PHYSICS_PHYSICS_PROPERTY_HPP
 #define PHYSICS_PHYSICS_PROPERTY_HPP
 #include "../Math/Vector.hpp"
+#include <cstddef>
 
 namespace Physics {
 	class Body;
+	class BodyStorage;
+
+	// every kind of property, each property class names its type with a static Type member
+	// so a body can find a property by indexing instead of a dynamic_cast
+	enum class PropertyType : unsigned char { GravityWell, Count };
+
+	// the number of property types
+	static const size_t PropertyTypeCount = static_cast<size_t>(PropertyType::Count);
 
 	class PhysicsProperty {
 	protected:
 		friend Body;
+		friend BodyStorage;
 
 		// the attached body
 		Body* body;
 
+		// the type the property was created as
+		PropertyType type;
+
+		// where the property is in the storage's list of properties of its type
+		unsigned int listIndex;
+
 	public:
 
-		PhysicsProperty() { }
+		PhysicsProperty() : body(nullptr), type(PropertyType::Count), listIndex(0xffffffff) { }
 		virtual ~PhysicsProperty() = 0 { }
 
 		/// getters
@@ -22,6 +38,7 @@ namespace Physics {
 		Body* GetBody() const { return body; }
 		template<typename B>
 		B* GetBody() const { return static_cast<B*>(body); }
+		PropertyType GetPropertyType() const { return type; }
 
 	};
 
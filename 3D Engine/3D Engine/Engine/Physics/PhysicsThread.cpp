@@ -0,0 +1,68 @@
+#include "PhysicsThread.hpp"
+
+namespace Physics {
+
+	PhysicsThread::PhysicsThread(World* world_)
+		: world(world_), deltaTime(0.0f), running(false), quit(false), captured(false), front(0) {
+		// start with the world as it is so there is something to read before the first step finishes
+		snapshots[0].Capture(world->GetStorage(), world->GetInterpolationAlpha(), world->GetJobSystem());
+		thread = std::thread(&PhysicsThread::ThreadLoop, this);
+	}
+
+	PhysicsThread::~PhysicsThread() {
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			signal.wait(guard, [this]() { return !running; });
+			quit = true;
+		}
+		signal.notify_all();
+		thread.join();
+	}
+
+	void PhysicsThread::Step(const float& deltaTime_) {
+		std::unique_lock<std::mutex> guard(lock);
+		signal.wait(guard, [this]() { return !running; });
+
+		// the back snapshot holds the step that just finished, nothing writes it until the next step ends
+		if (captured) {
+			front.store(front.load(std::memory_order_relaxed) ^ 1u, std::memory_order_release);
+			captured = false;
+		}
+
+		deltaTime = deltaTime_;
+		running = true;
+		guard.unlock();
+		signal.notify_all();
+	}
+
+	void PhysicsThread::Wait() {
+		std::unique_lock<std::mutex> guard(lock);
+		signal.wait(guard, [this]() { return !running; });
+	}
+
+	void PhysicsThread::ThreadLoop() {
+		while (true) {
+			float dt;
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				signal.wait(guard, [this]() { return running || quit; });
+				if (quit) return;
+				dt = deltaTime;
+			}
+
+			world->Step(dt);
+
+			// fill the snapshot readers arent looking at
+			unsigned int back = front.load(std::memory_order_acquire) ^ 1u;
+			snapshots[back].Capture(world->GetStorage(), world->GetInterpolationAlpha(), world->GetJobSystem());
+
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				running = false;
+				captured = true;
+			}
+			signal.notify_all();
+		}
+	}
+
+}
\ No newline at end of file
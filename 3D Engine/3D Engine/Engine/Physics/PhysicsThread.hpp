@@ -0,0 +1,66 @@
+#ifndef PHYSICS_PHYSICS_THREAD_HPP
+#define PHYSICS_PHYSICS_THREAD_HPP
+#include "World.hpp"
+#include "BodySnapshot.hpp"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace Physics {
+
+	// steps a world on its own thread one frame ahead of the game
+	// each Step publishes the snapshot of the step before it and starts the next one,
+	// so the simulation runs alongside the rest of the frame instead of adding to it
+	// while a step is running the world can only be changed through World::Submit,
+	// read the bodies through GetSnapshot and call Wait before touching the world directly
+	class PhysicsThread {
+
+		World* world;
+		std::thread thread;
+
+		/// the step handed to the thread
+		std::mutex lock;
+		std::condition_variable signal;
+		float deltaTime;
+		bool running;
+		bool quit;
+		// the back snapshot holds a step that hasnt been published yet
+		bool captured;
+
+		// the physics thread writes the back snapshot, readers only see the front one
+		BodySnapshot snapshots[2];
+		std::atomic<unsigned int> front;
+
+		void ThreadLoop();
+
+	public:
+
+		explicit PhysicsThread(World* world_);
+		// waits for the step that is running and stops the thread
+		~PhysicsThread();
+
+		PhysicsThread(const PhysicsThread&) = delete;
+		PhysicsThread& operator=(const PhysicsThread&) = delete;
+
+		/// functions
+
+		// waits for the last step, publishes its snapshot and starts stepping the world by deltaTime
+		// returns without waiting for the new step
+		void Step(const float& deltaTime_);
+
+		// blocks until the running step is done, the world can be used directly after
+		void Wait();
+
+		/// getters
+
+		// the bodies as of the last finished step, safe to read from any thread without a lock
+		// stays valid until the next call to Step, so read it within the frame it was published in
+		const BodySnapshot& GetSnapshot() const { return snapshots[front.load(std::memory_order_acquire)]; }
+		World* GetWorld() const { return world; }
+
+	};
+
+}
+
+#endif // !PHYSICS_PHYSICS_THREAD_HPP
\ No newline at end of file
@@ -5,14 +5,6 @@
 namespace Physics {
 
 	class Rigidbody : public Body {
-	protected:
-
-		/// motion
-		Math::Vector3 velocity;
-		Math::Vector3 acceleration;
-		Math::Vector3 angularVelocity;
-		Math::Vector3 angularAcceleration;
-
 	public:
 
 		Rigidbody();
@@ -20,17 +12,44 @@ namespace Physics {
 
 		/// getters
 
-		Math::Vector3 GetVelocity() const { return velocity; }
-		Math::Vector3 GetAcceleration() const { return acceleration; }
-		Math::Vector3 GetAngularVelocity() const { return angularVelocity; }
-		Math::Vector3 GetAngularAcceleration() const { return angularAcceleration; }
+		Math::Vector3 GetVelocity() const { return storage->velocities[Index()]; }
+		Math::Vector3 GetAcceleration() const { return storage->accelerations[Index()]; }
+		Math::Vector3 GetAngularVelocity() const { return storage->angularVelocities[Index()]; }
+		Math::Vector3 GetAngularAcceleration() const { return storage->angularAccelerations[Index()]; }
+		bool IsContinuous() const { return (storage->flags[Index()] & BodyFlags::Continuous) != 0; }
+		float GetContinuousSpeed() const { return storage->continuousSpeeds[Index()]; }
 
 		/// setters
 
-		void SetVelocity(const float& velocity_) { velocity = velocity_; }
-		void SetAcceleration(const float& acceleration_) { acceleration = acceleration_; }
-		void SetAngularVelocity(const float& angularVelocity_) { angularVelocity = angularVelocity_; }
-		void SetAngularAcceleration(const float& angularAcceleration_) { angularAcceleration = angularAcceleration_; }
+		// changing the motion of a sleeping body wakes it
+		void SetVelocity(const Math::Vector3& velocity_) {
+			Math::Vector3& velocity = storage->velocities[Index()];
+			if (velocity == velocity_) return;
+			velocity = velocity_; SetAwake(true);
+		}
+		void SetAcceleration(const Math::Vector3& acceleration_) {
+			Math::Vector3& acceleration = storage->accelerations[Index()];
+			if (acceleration == acceleration_) return;
+			acceleration = acceleration_; SetAwake(true);
+		}
+		void SetAngularVelocity(const Math::Vector3& angularVelocity_) {
+			Math::Vector3& angularVelocity = storage->angularVelocities[Index()];
+			if (angularVelocity == angularVelocity_) return;
+			angularVelocity = angularVelocity_; SetAwake(true);
+		}
+		void SetAngularAcceleration(const Math::Vector3& angularAcceleration_) {
+			Math::Vector3& angularAcceleration = storage->angularAccelerations[Index()];
+			if (angularAcceleration == angularAcceleration_) return;
+			angularAcceleration = angularAcceleration_; SetAwake(true);
+		}
+		// sweeps the body for hits when it moves faster than speed so it cant pass through thin bodies
+		// only sphere colliders are swept, a negative speed turns it off
+		void SetContinuousSpeed(const float& speed_) {
+			unsigned int i = Index();
+			storage->continuousSpeeds[i] = speed_;
+			unsigned char& f = storage->flags[i];
+			f = static_cast<unsigned char>(speed_ >= 0.0f ? (f | BodyFlags::Continuous) : (f & ~BodyFlags::Continuous));
+		}
 
 
 
@@ -0,0 +1,177 @@
+#include "SceneQuery.hpp"
+#include <cmath>
+
+namespace Physics {
+
+	// how many bits of each axis of the origin go into a batch sort key
+	static const unsigned int KeyBitsPerAxis = 9;
+
+	const SceneQuery::ShapeCastFunc SceneQuery::shapeCasts[CollisionShapeCount] = {
+		// None
+		nullptr,
+		// Sphere
+		SceneQuery::CastSphere,
+	};
+
+	bool SceneQuery::CastSphere(const BodyStorage& storage, const unsigned int& index, const Ray& ray, const float& radius, RaycastHit& hit) {
+		unsigned int s = storage.shapeSlots[index];
+		Math::Vector3 center = storage.spheres.GetCenter(s, storage.positions[index]);
+		float sphereRadius = storage.spheres.radii[s];
+
+		// a sphere cast against a sphere is a raycast against a sphere grown by the radius
+		float r = sphereRadius + radius;
+		if (r <= 0.0f) return false;
+
+		Math::Vector3 m = ray.origin - center;
+		float c = Math::Vector3::Dot(m, m) - r * r;
+		if (c < 0.0f) return false;
+
+		// the ray points away from the sphere
+		float b = Math::Vector3::Dot(m, ray.direction);
+		if (b > 0.0f) return false;
+
+		float discriminant = b * b - c;
+		if (discriminant < 0.0f) return false;
+
+		float t = -b - sqrtf(discriminant);
+		if (t > ray.length) return false;
+
+		// the normal points from the sphere to the center of the cast when they touch
+		Math::Vector3 normal = (ray.origin + ray.direction * t - center) / r;
+		hit.point = center + normal * sphereRadius;
+		hit.normal = normal;
+		hit.distance = t;
+		return true;
+	}
+
+	float SceneQuery::CastCallback(void* data, const BodyHandle& handle) {
+		CastState& cast = *static_cast<CastState*>(data);
+		const BodyStorage& storage = *cast.storage;
+		if (!storage.IsValid(handle)) return cast.ray.length;
+
+		unsigned int index = storage.GetIndex(handle);
+		ShapeCastFunc shapeCast = shapeCasts[static_cast<size_t>(storage.shapes[index])];
+		RaycastHit hit;
+		if (!shapeCast || !shapeCast(storage, index, cast.ray, cast.radius, hit)) return cast.ray.length;
+
+		// the hit is closer than the current end of the ray so the rest of the ray can be skipped
+		hit.handle = handle;
+		*cast.hit = hit;
+		cast.ray.length = hit.distance;
+		return hit.distance;
+	}
+
+	bool SceneQuery::Raycast(const Ray& ray, RaycastHit& hit) const {
+		return SphereCast(ray, 0.0f, hit);
+	}
+
+	bool SceneQuery::SphereCast(const Ray& ray, const float& radius, RaycastHit& hit) const {
+		hit = RaycastHit();
+		float magnitude = ray.direction.Magnitude();
+		if (magnitude <= 0.0f || ray.length < 0.0f) return false;
+
+		CastState cast;
+		cast.storage = storage;
+		cast.ray = Ray(ray.origin, ray.direction / magnitude, ray.length);
+		cast.radius = radius;
+		cast.hit = &hit;
+		broadphase->QueryRay(cast.ray.origin, cast.ray.direction, cast.ray.length, radius, CastCallback, &cast);
+
+		return hit.IsHit();
+	}
+
+	void SceneQuery::OverlapBounds(const Math::Bounds3D& bounds, DArray<BodyHandle>& results) const {
+		broadphase->Query(bounds, results);
+
+		// the broadphase bounds can be fattened or old so test the bounds of the colliders where they are now
+		size_t write = 0;
+		for (size_t i = 0; i < results.size(); ++i) {
+			const BodyHandle& handle = results[i];
+			if (!storage->IsValid(handle)) continue;
+			if (Math::Bounds3D::Intersects(storage->ComputeBounds(storage->GetIndex(handle)), bounds))
+				results[write++] = handle;
+		}
+		results.resize(write);
+	}
+
+	void SceneQuery::RaycastBatch(const DArray<Ray>& rays, DArray<RaycastHit>& hits, const float& radius) {
+		const size_t count = rays.size();
+		hits.resize(count);
+		if (count == 0) return;
+
+		SortBatch(rays);
+
+		const Ray* rayData = rays.data();
+		RaycastHit* hitData = hits.data();
+		const unsigned int* order = batchOrder.data();
+		auto cast = [this, rayData, hitData, order, radius](size_t begin, size_t end) {
+			for (size_t k = begin; k < end; ++k) {
+				unsigned int i = order[k];
+				SphereCast(rayData[i], radius, hitData[i]);
+			}
+		};
+
+		if (jobs) jobs->ParallelFor(count, 64, cast);
+		else cast(static_cast<size_t>(0), count);
+	}
+
+	void SceneQuery::SortBatch(const DArray<Ray>& rays) {
+		const unsigned int count = static_cast<unsigned int>(rays.size());
+
+		// the origins are placed in a cube around all of them
+		Math::Vector3 lo = rays[0].origin, hi = rays[0].origin;
+		for (unsigned int i = 1; i < count; ++i) {
+			const Math::Vector3& o = rays[i].origin;
+			lo.x = fminf(lo.x, o.x); hi.x = fmaxf(hi.x, o.x);
+			lo.y = fminf(lo.y, o.y); hi.y = fmaxf(hi.y, o.y);
+			lo.z = fminf(lo.z, o.z); hi.z = fmaxf(hi.z, o.z);
+		}
+		float size = fmaxf(fmaxf(hi.x - lo.x, hi.y - lo.y), hi.z - lo.z);
+		const float cells = static_cast<float>((1 << KeyBitsPerAxis) - 1);
+		float scale = size > 0.0f ? cells / size : 0.0f;
+
+		// the key is the octant of the direction then the morton code of the origin
+		batchKeys.resize(count);
+		batchOrder.resize(count);
+		for (unsigned int i = 0; i < count; ++i) {
+			const Ray& ray = rays[i];
+			unsigned int q[3] = {
+				static_cast<unsigned int>((ray.origin.x - lo.x) * scale),
+				static_cast<unsigned int>((ray.origin.y - lo.y) * scale),
+				static_cast<unsigned int>((ray.origin.z - lo.z) * scale)
+			};
+
+			unsigned int key = 0;
+			for (unsigned int bit = KeyBitsPerAxis; bit-- > 0;)
+				key = (key << 3) | (((q[0] >> bit) & 1) << 2) | (((q[1] >> bit) & 1) << 1) | ((q[2] >> bit) & 1);
+
+			unsigned int octant = (ray.direction.x < 0.0f ? 4 : 0) | (ray.direction.y < 0.0f ? 2 : 0) | (ray.direction.z < 0.0f ? 1 : 0);
+			batchKeys[i] = (octant << (KeyBitsPerAxis * 3)) | key;
+			batchOrder[i] = i;
+		}
+
+		// radix sort the keys a byte at a time
+		sortKeys.resize(count);
+		sortOrder.resize(count);
+		for (unsigned int shift = 0; shift < 32; shift += 8) {
+			unsigned int starts[257] = { 0 };
+			for (unsigned int i = 0; i < count; ++i)
+				++starts[((batchKeys[i] >> shift) & 0xff) + 1];
+
+			// every key has the same byte here so there is nothing to sort
+			if (starts[((batchKeys[0] >> shift) & 0xff) + 1] == count) continue;
+
+			for (int b = 0; b < 256; ++b)
+				starts[b + 1] += starts[b];
+			for (unsigned int i = 0; i < count; ++i) {
+				unsigned int slot = starts[(batchKeys[i] >> shift) & 0xff]++;
+				sortKeys[slot] = batchKeys[i];
+				sortOrder[slot] = batchOrder[i];
+			}
+
+			std::swap(batchKeys, sortKeys);
+			std::swap(batchOrder, sortOrder);
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#ifndef PHYSICS_SCENE_QUERY_HPP
+#define PHYSICS_SCENE_QUERY_HPP
+#include "BodyStorage.hpp"
+#include "Broadphase.hpp"
+#include "../Jobs/JobSystem.hpp"
+
+namespace Physics {
+
+	// a segment from origin along direction for length
+	struct Ray {
+		Math::Vector3 origin;
+		// normalized by the queries so it can be any length
+		Math::Vector3 direction;
+		float length;
+
+		Ray() : origin(0.0f), direction(0.0f, 0.0f, 1.0f), length(0.0f) { }
+		Ray(const Math::Vector3& origin_, const Math::Vector3& direction_, const float& length_)
+			: origin(origin_), direction(direction_), length(length_) { }
+	};
+
+	// where a ray or a cast sphere first hit a body
+	struct RaycastHit {
+		// null if nothing was hit
+		BodyHandle handle;
+		// the point on the surface of the body that was hit
+		Math::Vector3 point;
+		// the normal of the surface at point
+		Math::Vector3 normal;
+		// how far along the ray the hit is
+		float distance;
+
+		RaycastHit() : point(0.0f), normal(0.0f), distance(0.0f) { }
+
+		bool IsHit() const { return !handle.IsNull(); }
+	};
+
+	// answers raycasts, sphere casts and overlap tests against the bodies of a world
+	// the broadphase finds the candidates and the shape tables give the exact hits
+	// queries only read the world so many threads can query at once, but not while it steps
+	// the broadphase is brought up to date at the end of every timestep, bodies moved by hand since are found where they were
+	class SceneQuery {
+	public:
+
+		// finds where a sphere of radius moving along the ray first touches the collider of the body
+		// radius 0 is a raycast, the ray direction is normalized
+		// colliders the sphere starts inside of are not hit
+		typedef bool(*ShapeCastFunc)(const BodyStorage& storage, const unsigned int& index, const Ray& ray, const float& radius, RaycastHit& hit);
+
+	private:
+
+		// the cast for every shape, nullptr for shapes that cant be hit
+		static const ShapeCastFunc shapeCasts[CollisionShapeCount];
+
+		// what a cast keeps while the broadphase walks its ray
+		struct CastState {
+			const BodyStorage* storage;
+			Ray ray;
+			float radius;
+			RaycastHit* hit;
+		};
+
+		const BodyStorage* storage;
+		const Broadphase* broadphase;
+
+		// the batches are split over these threads, nullptr runs on the calling thread
+		Jobs::JobSystem* jobs;
+
+		/// batches
+		// the order the rays are cast in and the keys they were sorted by
+		DArray<unsigned int> batchOrder;
+		DArray<unsigned int> batchKeys;
+		DArray<unsigned int> sortOrder;
+		DArray<unsigned int> sortKeys;
+
+		// keeps the closest hit and clips the ray to it
+		static float CastCallback(void* data, const BodyHandle& handle);
+
+		static bool CastSphere(const BodyStorage& storage, const unsigned int& index, const Ray& ray, const float& radius, RaycastHit& hit);
+
+		// sorts the rays so rays that start close together and point the same way are cast together
+		void SortBatch(const DArray<Ray>& rays);
+
+	public:
+
+		SceneQuery() : storage(nullptr), broadphase(nullptr), jobs(nullptr) { }
+
+		/// queries
+
+		// finds the closest body the ray hits
+		bool Raycast(const Ray& ray, RaycastHit& hit) const;
+
+		// finds the closest body a sphere of radius moving along the ray hits
+		bool SphereCast(const Ray& ray, const float& radius, RaycastHit& hit) const;
+
+		// clears results and writes every body whose collider bounds overlap bounds into it
+		void OverlapBounds(const Math::Bounds3D& bounds, DArray<BodyHandle>& results) const;
+
+		// casts every ray, hits[i] is the closest hit of rays[i]
+		// the rays are sorted so nearby rays walk the same part of the broadphase then split over the threads
+		// a radius above 0 casts spheres instead
+		void RaycastBatch(const DArray<Ray>& rays, DArray<RaycastHit>& hits, const float& radius = 0.0f);
+
+		/// getters
+
+		const BodyStorage* GetStorage() const { return storage; }
+		const Broadphase* GetBroadphase() const { return broadphase; }
+		Jobs::JobSystem* GetJobSystem() const { return jobs; }
+
+		/// setters
+
+		void SetStorage(const BodyStorage* storage_) { storage = storage_; }
+		void SetBroadphase(const Broadphase* broadphase_) { broadphase = broadphase_; }
+		void SetJobSystem(Jobs::JobSystem* jobs_) { jobs = jobs_; }
+
+	};
+
+}
+
+#endif // !PHYSICS_SCENE_QUERY_HPP
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include "WellGrid.hpp"
+#include "../Math/SIMD.hpp"
+#include <cmath>
+
+namespace Physics {
+
+	using Math::Vector3;
+
+	const unsigned int WellGrid::Null;
+
+	// where the padding wells are put, far enough that the distance to them is infinite
+	static const float PadPosition = 1e30f;
+	// the narrowest a cell can be, wells with almost no range would otherwise make cells so small
+	// that the cell coordinates of ordinary positions overflow an int
+	static const float MinCellSize = 0.01f;
+
+	WellGrid::WellGrid()
+		: cellSize(1.0f), inverseCellSize(1.0f), wellCount(0), kernel(nullptr), kernelType(KernelType::Scalar) {
+		SetKernelType(KernelType::AVX2);
+	}
+
+	void WellGrid::SetKernelType(KernelType type) {
+		if (type == KernelType::AVX2 && !Math::SIMD::HasAVX2())
+			type = KernelType::Scalar;
+
+		kernelType = type;
+		switch (type) {
+			case KernelType::AVX2: kernel = WellKernelAVX2; break;
+			case KernelType::Scalar:
+			default: kernel = WellKernelScalar; break;
+		}
+	}
+
+	void WellGrid::Build(const WellSet& wells, const float& maxRange, DArray<bool>& added) {
+		cells.clear();
+		cellStarts.clear();
+		entries.clear();
+		x.clear(); y.clear(); z.clear();
+		gravity.clear(); rangeSq.clear(); owners.clear();
+		wellCount = 0;
+
+		// pick the wells that are short enough for the grid
+		const size_t count = wells.size();
+		added.resize(count);
+		float largest = 0.0f;
+		for (size_t w = 0; w < count; ++w) {
+			added[w] = wells.range[w] <= maxRange;
+			if (!added[w]) continue;
+			++wellCount;
+			largest = fmaxf(largest, wells.range[w]);
+		}
+
+		// wells with no range never reach anything
+		if (largest <= 0.0f) return;
+		cellSize = fmaxf(largest, MinCellSize);
+		inverseCellSize = 1.0f / cellSize;
+
+		// put every well in each cell its range touches and count the wells per cell
+		for (size_t w = 0; w < count; ++w) {
+			if (!added[w] || wells.range[w] <= 0.0f) continue;
+
+			const float r = wells.range[w];
+			int x0 = CellCoord(wells.x[w] - r), x1 = CellCoord(wells.x[w] + r);
+			int y0 = CellCoord(wells.y[w] - r), y1 = CellCoord(wells.y[w] + r);
+			int z0 = CellCoord(wells.z[w] - r), z1 = CellCoord(wells.z[w] + r);
+			for (int cx = x0; cx <= x1; ++cx) {
+				for (int cy = y0; cy <= y1; ++cy) {
+					for (int cz = z0; cz <= z1; ++cz) {
+						unsigned long long key = CellKey(cx, cy, cz);
+						unsigned int* found = cells.find(key);
+						unsigned int cell;
+						if (found) {
+							cell = *found;
+						} else {
+							cell = static_cast<unsigned int>(cellStarts.size());
+							cells.insert(key, cell);
+							cellStarts.push_back(0);
+						}
+						++cellStarts[cell];
+
+						CellEntry entry;
+						entry.cell = cell;
+						entry.well = static_cast<unsigned int>(w);
+						entries.push_back(entry);
+					}
+				}
+			}
+		}
+
+		// turn the counts into starts, every cell is padded to a multiple of 8
+		const size_t cellCount = cellStarts.size();
+		unsigned int total = 0;
+		for (size_t c = 0; c < cellCount; ++c) {
+			unsigned int padded = (cellStarts[c] + 7) & ~7u;
+			cellStarts[c] = total;
+			total += padded;
+		}
+		cellStarts.push_back(total);
+
+		// padding wells are too far away to reach anything
+		x.resize(total, PadPosition); y.resize(total, PadPosition); z.resize(total, PadPosition);
+		gravity.resize(total, 0.0f);
+		rangeSq.resize(total, 0.0f);
+		owners.resize(total, Null);
+
+		// copy the wells into their cells, entries keep the order the wells were gathered in
+		cursors = cellStarts;
+		for (const CellEntry& entry : entries) {
+			unsigned int i = cursors[entry.cell]++;
+			unsigned int w = entry.well;
+			x[i] = wells.x[w]; y[i] = wells.y[w]; z[i] = wells.z[w];
+			gravity[i] = wells.gravity[w];
+			rangeSq[i] = wells.range[w] * wells.range[w];
+			owners[i] = wells.owners[w];
+		}
+	}
+
+	Vector3 WellGrid::Evaluate(const Vector3& point, const unsigned int& owner, const float& softening) const {
+		if (cells.empty()) return Vector3(0.0f);
+
+		const unsigned int* cell = cells.find(CellKey(CellCoord(point.x), CellCoord(point.y), CellCoord(point.z)));
+		if (!cell) return Vector3(0.0f);
+
+		return kernel(*this, cellStarts[*cell], cellStarts[*cell + 1], point, owner, softening * softening);
+	}
+
+	Vector3 WellGrid::WellKernelScalar(const WellGrid& grid, size_t begin, size_t end, const Vector3& point,
+									   const unsigned int& owner, const float& softeningSq) {
+		Vector3 acceleration(0.0f);
+
+		for (size_t i = begin; i < end; ++i) {
+			if (grid.owners[i] == owner) continue;
+
+			Vector3 offset(grid.x[i] - point.x, grid.y[i] - point.y, grid.z[i] - point.z);
+			float distSq = Vector3::Dot(offset, offset);
+			if (distSq > grid.rangeSq[i]) continue;
+			acceleration += WellAcceleration(offset, distSq, grid.gravity[i], softeningSq);
+		}
+
+		return acceleration;
+	}
+
+	MATH_TARGET_AVX2
+	Vector3 WellGrid::WellKernelAVX2(const WellGrid& grid, size_t begin, size_t end, const Vector3& point,
+									 const unsigned int& owner, const float& softeningSq) {
+		const __m256 px = _mm256_set1_ps(point.x);
+		const __m256 py = _mm256_set1_ps(point.y);
+		const __m256 pz = _mm256_set1_ps(point.z);
+		const __m256 soft = _mm256_set1_ps(softeningSq);
+		const __m256i self = _mm256_set1_epi32(static_cast<int>(owner));
+
+		__m256 ax = _mm256_setzero_ps();
+		__m256 ay = _mm256_setzero_ps();
+		__m256 az = _mm256_setzero_ps();
+
+		// the cells are padded to 8 so whole blocks can always be loaded
+		for (size_t i = begin; i < end; i += 8) {
+			__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&grid.x[i]), px);
+			__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&grid.y[i]), py);
+			__m256 dz = _mm256_sub_ps(_mm256_loadu_ps(&grid.z[i]), pz);
+			__m256 distSq = _mm256_fmadd_ps(dz, dz, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dx, dx)));
+
+			// the wells that reach the point and are not attached to it
+			__m256 inRange = _mm256_cmp_ps(distSq, _mm256_loadu_ps(&grid.rangeSq[i]), _CMP_LE_OQ);
+			__m256i owners = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&grid.owners[i]));
+			__m256 isSelf = _mm256_castsi256_ps(_mm256_cmpeq_epi32(owners, self));
+			__m256 mask = _mm256_andnot_ps(isSelf, inRange);
+			if (_mm256_movemask_ps(mask) == 0) continue;
+
+			// gravity / d^1.5 with the softening added to the distance
+			__m256 d = _mm256_add_ps(distSq, soft);
+			__m256 scale = _mm256_div_ps(_mm256_loadu_ps(&grid.gravity[i]), _mm256_mul_ps(d, _mm256_sqrt_ps(d)));
+			scale = _mm256_and_ps(mask, scale);
+
+			ax = _mm256_fmadd_ps(dx, scale, ax);
+			ay = _mm256_fmadd_ps(dy, scale, ay);
+			az = _mm256_fmadd_ps(dz, scale, az);
+		}
+
+		// add the 8 lanes together
+		alignas(32) float sx[8], sy[8], sz[8];
+		_mm256_store_ps(sx, ax);
+		_mm256_store_ps(sy, ay);
+		_mm256_store_ps(sz, az);
+		Vector3 acceleration(0.0f);
+		for (int l = 0; l < 8; ++l) {
+			acceleration.x += sx[l];
+			acceleration.y += sy[l];
+			acceleration.z += sz[l];
+		}
+		return acceleration;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef PHYSICS_WELL_GRID_HPP
+#define PHYSICS_WELL_GRID_HPP
+#include "WellTree.hpp"
+#include "../Containers/HashMap.hpp"
+
+namespace Physics {
+
+	// a uniform grid over short range gravity wells
+	// every well is copied into each cell its range touches so a point only has to read the one cell it is in
+	// the wells in a cell are stored as columns padded to 8 so the kernels can add 8 wells at a time
+	// unlike the tree nothing is approximated, a well either reaches the point or is skipped
+	class WellGrid {
+	public:
+
+		// adds up the pull of wells [begin, end) of the grid columns on point
+		// begin and end must be multiples of 8
+		typedef Math::Vector3(*WellKernel)(const WellGrid& grid, size_t begin, size_t end, const Math::Vector3& point,
+										   const unsigned int& owner, const float& softeningSq);
+
+		// which kernel adds up the wells
+		enum class KernelType : unsigned char { Scalar, AVX2 };
+
+	private:
+
+		static const unsigned int Null = 0xffffffff;
+
+		// a well in a cell, used while building the cells
+		struct CellEntry {
+			unsigned int cell;
+			unsigned int well;
+		};
+
+		/// cells
+		float cellSize;
+		float inverseCellSize;
+		HashMap<unsigned long long, unsigned int> cells;
+		// the wells in cell c are the columns [cellStarts[c], cellStarts[c + 1])
+		DArray<unsigned int> cellStarts;
+		DArray<CellEntry> entries;
+		DArray<unsigned int> cursors;
+
+		/// the wells of every cell, one column per component
+		DArray<float> x, y, z;
+		DArray<float> gravity;
+		DArray<float> rangeSq;
+		DArray<unsigned int> owners;
+
+		// the wells that were added to the grid
+		size_t wellCount;
+
+		WellKernel kernel;
+		KernelType kernelType;
+
+		// the cell coordinate that a position is in
+		int CellCoord(const float& value) const {
+			return static_cast<int>(floorf(value * inverseCellSize));
+		}
+
+		// packs 3 cell coordinates into one key
+		static unsigned long long CellKey(const int& x, const int& y, const int& z) {
+			return (static_cast<unsigned long long>(x & 0x1fffff))
+				| (static_cast<unsigned long long>(y & 0x1fffff) << 21)
+				| (static_cast<unsigned long long>(z & 0x1fffff) << 42);
+		}
+
+	public:
+
+		// picks the widest kernel the cpu can run
+		WellGrid();
+
+		// rebuilds the grid over the wells with a range of maxRange or less
+		// the cells are as wide as the largest of those ranges so a well touches at most 27 cells,
+		// but never narrower than 0.01
+		// added is set to whether each well went into the grid
+		void Build(const WellSet& wells, const float& maxRange, DArray<bool>& added);
+
+		// adds up the acceleration at point from every well in the grid that reaches it
+		// wells attached to owner are skipped so bodies dont pull on themselves
+		Math::Vector3 Evaluate(const Math::Vector3& point, const unsigned int& owner, const float& softening) const;
+
+		/// getters
+
+		bool empty() const { return wellCount == 0; }
+		size_t GetWellCount() const { return wellCount; }
+		size_t GetCellCount() const { return cells.size(); }
+		// the number of well copies stored in the cells, including padding
+		size_t GetEntryCount() const { return owners.size(); }
+		float GetCellSize() const { return cellSize; }
+		KernelType GetKernelType() const { return kernelType; }
+
+		/// setters
+
+		// forces a kernel, falls back to the scalar one if the cpu cant run it
+		void SetKernelType(KernelType type);
+
+		/// kernels
+
+		static Math::Vector3 WellKernelScalar(const WellGrid& grid, size_t begin, size_t end, const Math::Vector3& point,
+											  const unsigned int& owner, const float& softeningSq);
+		static Math::Vector3 WellKernelAVX2(const WellGrid& grid, size_t begin, size_t end, const Math::Vector3& point,
+											const unsigned int& owner, const float& softeningSq);
+
+	};
+
+}
+
+#endif // !PHYSICS_WELL_GRID_HPP
\ No newline at end of file
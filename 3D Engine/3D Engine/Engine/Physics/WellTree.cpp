@@ -0,0 +1,200 @@
+#include "WellTree.hpp"
+#include <cmath>
+
+namespace Physics {
+
+	using Math::Vector3;
+
+	void WellTree::Build(const WellSet& wells) {
+		nodes.clear();
+		const unsigned int count = static_cast<unsigned int>(wells.size());
+		if (count == 0) return;
+
+		order.resize(count);
+		sorted.resize(count);
+		octants.resize(count);
+		for (unsigned int i = 0; i < count; ++i)
+			order[i] = i;
+
+		// the root is a cube around every well
+		Vector3 lo(wells.x[0], wells.y[0], wells.z[0]);
+		Vector3 hi = lo;
+		for (unsigned int i = 1; i < count; ++i) {
+			lo.x = fminf(lo.x, wells.x[i]); hi.x = fmaxf(hi.x, wells.x[i]);
+			lo.y = fminf(lo.y, wells.y[i]); hi.y = fmaxf(hi.y, wells.y[i]);
+			lo.z = fminf(lo.z, wells.z[i]); hi.z = fmaxf(hi.z, wells.z[i]);
+		}
+
+		Node root;
+		root.center = (lo + hi) * 0.5f;
+		root.halfSize = fmaxf(fmaxf(hi.x - lo.x, hi.y - lo.y), hi.z - lo.z) * 0.5f + 0.001f;
+		root.begin = 0;
+		root.count = count;
+		nodes.push_back(root);
+
+		BuildNode(wells, 0, 0);
+	}
+
+	void WellTree::BuildNode(const WellSet& wells, const unsigned int& index, const unsigned int& depth) {
+		// nodes can move while children are added so copy what is needed
+		const unsigned int begin = nodes[index].begin;
+		const unsigned int end = begin + nodes[index].count;
+		const Vector3 center = nodes[index].center;
+		const float halfSize = nodes[index].halfSize;
+
+		if (end - begin <= leafSize || depth >= MaxDepth) {
+			// sum the wells in the leaf
+			Node& node = nodes[index];
+			node.firstChild = Null;
+			node.gravity = 0.0f;
+			node.minRange = wells.range[order[begin]];
+			node.maxRange = node.minRange;
+
+			Vector3 weighted(0.0f);
+			float weight = 0.0f;
+			for (unsigned int i = begin; i < end; ++i) {
+				unsigned int w = order[i];
+				float g = wells.gravity[w];
+				node.gravity += g;
+				weighted += Vector3(wells.x[w], wells.y[w], wells.z[w]) * fabsf(g);
+				weight += fabsf(g);
+				node.minRange = fminf(node.minRange, wells.range[w]);
+				node.maxRange = fmaxf(node.maxRange, wells.range[w]);
+			}
+			node.gravityCenter = weight > 0.0f ? weighted / weight : center;
+			node.weight = weight;
+			return;
+		}
+
+		// counting sort the wells into octants
+		unsigned int cursors[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+		for (unsigned int i = begin; i < end; ++i) {
+			unsigned int w = order[i];
+			unsigned char octant = static_cast<unsigned char>(
+				(wells.x[w] >= center.x ? 1 : 0) | (wells.y[w] >= center.y ? 2 : 0) | (wells.z[w] >= center.z ? 4 : 0));
+			octants[i] = octant;
+			++cursors[octant];
+		}
+		unsigned int starts[9];
+		starts[0] = begin;
+		for (int o = 0; o < 8; ++o) {
+			starts[o + 1] = starts[o] + cursors[o];
+			cursors[o] = starts[o];
+		}
+		for (unsigned int i = begin; i < end; ++i)
+			sorted[cursors[octants[i]]++] = order[i];
+		for (unsigned int i = begin; i < end; ++i)
+			order[i] = sorted[i];
+
+		// add the children next to each other
+		const unsigned int firstChild = static_cast<unsigned int>(nodes.size());
+		const float childHalf = halfSize * 0.5f;
+		for (int o = 0; o < 8; ++o) {
+			Node child;
+			child.center = center + Vector3((o & 1) ? childHalf : -childHalf, (o & 2) ? childHalf : -childHalf, (o & 4) ? childHalf : -childHalf);
+			child.halfSize = childHalf;
+			child.begin = starts[o];
+			child.count = starts[o + 1] - starts[o];
+			child.firstChild = Null;
+			child.gravity = 0.0f;
+			child.weight = 0.0f;
+			child.gravityCenter = child.center;
+			child.minRange = 0.0f;
+			child.maxRange = 0.0f;
+			nodes.push_back(child);
+		}
+		nodes[index].firstChild = firstChild;
+
+		for (unsigned int c = firstChild; c < firstChild + 8; ++c)
+			if (nodes[c].count > 0) BuildNode(wells, c, depth + 1);
+
+		// sum the children
+		Vector3 weighted(0.0f);
+		float weight = 0.0f;
+		float gravity = 0.0f;
+		float minRange = 0.0f;
+		float maxRange = 0.0f;
+		bool first = true;
+		for (unsigned int c = firstChild; c < firstChild + 8; ++c) {
+			const Node& child = nodes[c];
+			if (child.count == 0) continue;
+
+			gravity += child.gravity;
+			weighted += child.gravityCenter * child.weight;
+			weight += child.weight;
+			minRange = first ? child.minRange : fminf(minRange, child.minRange);
+			maxRange = first ? child.maxRange : fmaxf(maxRange, child.maxRange);
+			first = false;
+		}
+
+		Node& node = nodes[index];
+		node.gravity = gravity;
+		node.gravityCenter = weight > 0.0f ? weighted / weight : center;
+		node.weight = weight;
+		node.minRange = minRange;
+		node.maxRange = maxRange;
+	}
+
+	Vector3 WellTree::Evaluate(const WellSet& wells, const Vector3& point, const unsigned int& owner,
+							   const float& theta, const float& softening) const {
+		Vector3 acceleration(0.0f);
+		if (nodes.empty()) return acceleration;
+
+		const float thetaSq = theta * theta;
+		const float softeningSq = softening * softening;
+
+		// every opened node adds at most 8 children
+		unsigned int stack[MaxDepth * 8 + 8];
+		unsigned int top = 0;
+		stack[top++] = 0;
+
+		while (top > 0) {
+			const Node& node = nodes[stack[--top]];
+			if (node.count == 0) continue;
+
+			// the closest and farthest the point is from the node cube
+			Vector3 d = point - node.center;
+			float nearSq = 0.0f, farSq = 0.0f;
+			for (int a = 0; a < 3; ++a) {
+				float ad = fabsf(d[a]);
+				float outside = fmaxf(ad - node.halfSize, 0.0f);
+				nearSq += outside * outside;
+				farSq += (ad + node.halfSize) * (ad + node.halfSize);
+			}
+
+			// no well in the node reaches the point
+			if (nearSq > node.maxRange * node.maxRange) continue;
+
+			if (node.firstChild != Null) {
+				// a far node that every well in it reaches is treated as one well
+				if (nearSq > 0.0f && farSq <= node.minRange * node.minRange) {
+					Vector3 offset = node.gravityCenter - point;
+					float distSq = Vector3::Dot(offset, offset);
+					float size = node.halfSize * 2.0f;
+					if (size * size < thetaSq * distSq) {
+						acceleration += WellAcceleration(offset, distSq, node.gravity, softeningSq);
+						continue;
+					}
+				}
+
+				for (unsigned int c = node.firstChild; c < node.firstChild + 8; ++c)
+					stack[top++] = c;
+				continue;
+			}
+
+			// add each well in the leaf
+			for (unsigned int i = node.begin; i < node.begin + node.count; ++i) {
+				unsigned int w = order[i];
+				if (wells.owners[w] == owner) continue;
+
+				Vector3 offset(wells.x[w] - point.x, wells.y[w] - point.y, wells.z[w] - point.z);
+				float distSq = Vector3::Dot(offset, offset);
+				if (distSq > wells.range[w] * wells.range[w]) continue;
+				acceleration += WellAcceleration(offset, distSq, wells.gravity[w], softeningSq);
+			}
+		}
+
+		return acceleration;
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#ifndef PHYSICS_WELL_TREE_HPP
+#define PHYSICS_WELL_TREE_HPP
+#include "../Math/Vector.hpp"
+#include "../Containers/DArray.hpp"
+
+namespace Physics {
+
+	// the gravity wells of a world gathered into columns
+	struct WellSet {
+		/// world position
+		DArray<float> x;
+		DArray<float> y;
+		DArray<float> z;
+		DArray<float> gravity;
+		DArray<float> range;
+		// the dense index of the body each well is attached to
+		DArray<unsigned int> owners;
+
+		size_t size() const { return owners.size(); }
+		bool empty() const { return owners.empty(); }
+
+		void clear() {
+			x.clear(); y.clear(); z.clear();
+			gravity.clear(); range.clear(); owners.clear();
+		}
+
+		void push_back(const Math::Vector3& position, const float& gravity_, const float& range_, const unsigned int& owner) {
+			x.push_back(position.x); y.push_back(position.y); z.push_back(position.z);
+			gravity.push_back(gravity_); range.push_back(range_); owners.push_back(owner);
+		}
+	};
+
+	// a barnes hut octree over gravity wells
+	// far away nodes are treated as one well at their center of gravity so a point only visits O(log n) nodes
+	class WellTree {
+
+		static const unsigned int Null = 0xffffffff;
+		static const unsigned int MaxDepth = 20;
+
+		struct Node {
+			// the cube the node covers
+			Math::Vector3 center;
+			float halfSize;
+
+			// the sum of the gravity of the wells and where it is centered
+			Math::Vector3 gravityCenter;
+			float gravity;
+			// the sum of the absolute gravity, wells that push and pull both move the center
+			float weight;
+
+			// the smallest and largest range of the wells in the node
+			float minRange;
+			float maxRange;
+
+			// the first of 8 children, Null for leaves
+			unsigned int firstChild;
+
+			// the wells in the node are order[begin, begin + count)
+			unsigned int begin;
+			unsigned int count;
+		};
+
+		DArray<Node> nodes;
+		DArray<unsigned int> order;
+
+		/// scratch for sorting wells into octants
+		DArray<unsigned int> sorted;
+		DArray<unsigned char> octants;
+
+		// nodes with this many wells or less are not split
+		unsigned int leafSize;
+
+		// splits the node into octants and sums the wells up from the leaves
+		void BuildNode(const WellSet& wells, const unsigned int& index, const unsigned int& depth);
+
+	public:
+
+		WellTree() : leafSize(8) { }
+
+		// rebuilds the tree over the wells
+		void Build(const WellSet& wells);
+
+		// adds up the acceleration at point from every well in range
+		// wells attached to owner are skipped so bodies dont pull on themselves
+		// nodes smaller than theta times their distance are treated as one well
+		Math::Vector3 Evaluate(const WellSet& wells, const Math::Vector3& point, const unsigned int& owner,
+							   const float& theta, const float& softening) const;
+
+		/// getters
+
+		size_t GetNodeCount() const { return nodes.size(); }
+		unsigned int GetLeafSize() const { return leafSize; }
+
+		/// setters
+
+		void SetLeafSize(const unsigned int& leafSize_) {
+			leafSize = leafSize_;
+			if (leafSize < 1) leafSize = 1;
+		}
+
+	};
+
+	// the acceleration a well of the given gravity pulls with from offset away
+	// softening keeps the pull finite when the point is on top of the well
+	inline Math::Vector3 WellAcceleration(const Math::Vector3& offset, const float& distSq, const float& gravity, const float& softeningSq) {
+		float d = distSq + softeningSq;
+		return offset * (gravity / (d * sqrtf(d)));
+	}
+
+}
+
+#endif // !PHYSICS_WELL_TREE_HPP
\ No newline at end of file
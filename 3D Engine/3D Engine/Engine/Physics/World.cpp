@@ -0,0 +1,450 @@
+#include "World.hpp"
+#include "Broadphases/DynamicTree.hpp"
+#include "Broadphases/SweepAndPrune.hpp"
+#include "Broadphases/HashGrid.hpp"
+#include "Staticbody.hpp"
+#include "Colliders/SphereCollider.hpp"
+#include "PhysicsProperties/GravityWell.hpp"
+#include <cmath>
+
+namespace Physics {
+
+	World::World(const WorldSettings& settings)
+		: jobs(settings.jobSystem), broadphase(nullptr), broadphaseCurrent(false), allowSleeping(settings.allowSleeping), sleepLinearVelocity(0.05f), sleepAngularVelocity(0.05f)
+		, timeToSleep(0.5f), timestep(1.0f / 60.0f), accumulator(0.0f), maxSubsteps(8) {
+		if (!jobs) jobs = &Jobs::JobSystem::Default();
+
+		solver.SetIterations(settings.solverIterations);
+		solver.SetMode(settings.solverMode);
+		solver.SetSubsteps(settings.solverSubsteps);
+		solver.SetJobSystem(jobs);
+		continuous.SetJobSystem(jobs);
+		gravity.SetJobSystem(jobs);
+		gravity.SetMode(settings.gravityMode);
+		gravity.SetTheta(settings.gravityTheta);
+		gravity.SetGridRange(settings.gravityGridRange);
+
+		// create the broadphase
+		switch (settings.broadphase) {
+			case BroadphaseType::SweepAndPrune:
+				broadphase = new SweepAndPrune(settings.sweepAxes);
+				break;
+			case BroadphaseType::HashGrid:
+				broadphase = new HashGrid(settings.gridCellSize, jobs);
+				break;
+			case BroadphaseType::DynamicTree:
+			default:
+				broadphase = new DynamicTree(settings.treeMargin);
+				break;
+		}
+
+		queries.SetStorage(&storage);
+		queries.SetBroadphase(broadphase);
+		queries.SetJobSystem(jobs);
+	}
+
+	World::~World() {
+		// destroy all the bodies, their memory is released in one go after
+		for (Body* body : storage.bodies)
+			body->~Body();
+		allocator.Release();
+
+		delete broadphase;
+		broadphase = nullptr;
+	}
+
+	void World::AddBody(Body* body) {
+		// rigidbodies are moved by the integrator, everything else stays put
+		unsigned char flags = BodyFlags::Simulated;
+		if (dynamic_cast<Rigidbody*>(body)) flags |= BodyFlags::Dynamic | BodyFlags::Awake;
+
+		body->storage = &storage;
+		body->allocator = &allocator;
+		body->handle = storage.Create(body, flags);
+	}
+
+	void World::DestroyBody(Body* body) {
+		if (!body) return;
+
+		// wake anything resting on the body
+		unsigned int index = body->Index();
+		if (storage.flags[index] & BodyFlags::HasCollider)
+			storage.wakeRegions.push_back(body->GetBounds());
+
+		if (storage.flags[index] & BodyFlags::InBroadphase)
+			broadphase->Remove(body->handle);
+		broadphaseCurrent = false;
+
+		// the body deletes its properties but they have to leave the storage first
+		for (PhysicsProperty* property : body->properties)
+			if (property) storage.RemoveProperty(property);
+
+		storage.Destroy(body->handle);
+		allocator.Delete(body);
+	}
+
+	void World::DestroyBody(const BodyHandle& handle) {
+		if (storage.IsValid(handle))
+			DestroyBody(storage.bodies[storage.GetIndex(handle)]);
+	}
+
+	unsigned int World::Step(const float& deltaTime) {
+		// the one point where other threads' changes reach the bodies
+		ApplyCommands();
+
+		accumulator += deltaTime;
+
+		// dont let a long frame make the world fall further and further behind
+		float maxTime = timestep * maxSubsteps;
+		if (accumulator > maxTime) accumulator = maxTime;
+
+		// run the fixed timesteps
+		unsigned int steps = 0;
+		while (accumulator >= timestep) {
+			Simulate(timestep);
+			accumulator -= timestep;
+			++steps;
+		}
+
+		return steps;
+	}
+
+	void World::ApplyCommands() {
+		if (commands.empty()) return;
+
+		commands.Take(commandBatches);
+		for (CommandBatch* batch : commandBatches) {
+			// creates are numbered from 0 in every batch
+			commandCreated.clear();
+			for (const BodyCommand& command : batch->commands)
+				ApplyCommand(command);
+		}
+		CommandQueue::Free(commandBatches);
+	}
+
+	void World::ApplyCommand(const BodyCommand& command) {
+		// make the body and tell the producer about it
+		if (command.type == CommandType::CreateRigidbody || command.type == CommandType::CreateStaticbody) {
+			Body* body;
+			if (command.type == CommandType::CreateRigidbody) body = CreateBody<Rigidbody>();
+			else body = CreateBody<Staticbody>();
+			commandCreated.push_back(body->GetHandle());
+			if (command.callback) command.callback(command.data, body);
+			return;
+		}
+
+		// find the body, it might have been destroyed since the command was recorded
+		BodyHandle handle = command.body.handle;
+		if (command.body.IsCreated()) {
+			if (command.body.created >= commandCreated.size()) return;
+			handle = commandCreated[command.body.created];
+		}
+		Body* body = GetBody(handle);
+		if (!body) return;
+
+		// only rigidbodies are dynamic
+		Rigidbody* rigidbody = nullptr;
+		if (storage.flags[body->Index()] & BodyFlags::Dynamic) rigidbody = static_cast<Rigidbody*>(body);
+
+		const Math::Vector3& value = command.value;
+		switch (command.type) {
+			case CommandType::DestroyBody: DestroyBody(body); break;
+			case CommandType::SetPosition: body->SetPosition(value); break;
+			case CommandType::SetRotation: body->SetRotation(command.rotation); break;
+			case CommandType::SetVelocity: if (rigidbody) rigidbody->SetVelocity(value); break;
+			case CommandType::SetAngularVelocity: if (rigidbody) rigidbody->SetAngularVelocity(value); break;
+			case CommandType::SetAcceleration: if (rigidbody) rigidbody->SetAcceleration(value); break;
+			case CommandType::SetAngularAcceleration: if (rigidbody) rigidbody->SetAngularAcceleration(value); break;
+			case CommandType::SetSphereCollider: body->SetCollider<SphereColldier>()->SetRadius(value.x); break;
+			case CommandType::DestroyCollider: body->DestroyCollider(); break;
+			case CommandType::SetMass: body->SetMass(value.x); break;
+			case CommandType::SetFriction: body->SetFriction(value.x); break;
+			case CommandType::SetBounce: body->SetBounce(value.x); break;
+			case CommandType::SetAwake: body->SetAwake(value.x != 0.0f); break;
+			case CommandType::SetSimulated: body->SetSimulated(value.x != 0.0f); break;
+			default: break;
+		}
+	}
+
+	void World::Simulate(const float& dt) {
+		// keep where the bodies start so rendering can blend between timesteps
+		const size_t count = storage.size();
+		for (size_t i = 0; i < count; ++i) {
+			storage.previousPositions[i] = storage.positions[i];
+			storage.previousRotations[i] = storage.rotations[i];
+		}
+
+		// find the contacts at the current positions
+		UpdatePairs();
+		narrowphase.Run(storage, pairs);
+		contacts.Update(pairs, narrowphase.GetContacts(), storage);
+		UpdateIslands();
+
+		GatherWells();
+		gravity.Apply(storage);
+
+		// semi implicit euler with the contacts solved between the velocity and position updates
+		if (solver.GetMode() == SolverMode::Substepped) {
+			SimulateSubsteps(dt);
+		} else {
+			IntegrateVelocities(dt);
+			solver.Solve(contacts, storage, islands, dt);
+			// fast bodies are stopped where they first hit something instead of passing through it
+			continuous.Sweep(storage, *broadphase, dt);
+			IntegratePositions(dt);
+			continuous.Clamp(storage, dt);
+		}
+		UpdateSleepTimes(dt);
+
+		// the next timestep starts with these pairs unless something changes before it
+		UpdatePairs();
+	}
+
+	void World::SimulateSubsteps(const float& dt) {
+		const unsigned int substeps = solver.GetSubsteps();
+		const float h = dt / substeps;
+
+		// every substep reuses the contacts found at the start of the timestep
+		solver.BeginSubsteps(contacts, storage, islands, dt);
+		for (unsigned int s = 0; s < substeps; ++s) {
+			IntegrateVelocities(h);
+			solver.SolveSubstep(contacts, storage, islands, h);
+			continuous.Sweep(storage, *broadphase, h);
+			IntegratePositions(h);
+			continuous.Clamp(storage, h);
+			solver.RelaxSubstep(contacts, storage, islands, h);
+		}
+		solver.EndSubsteps(contacts, storage, islands);
+	}
+
+	void World::GatherWells() {
+		WellSet& wells = gravity.GetWells();
+		wells.clear();
+
+		// only the bodies with a well are visited
+		for (PhysicsProperty* property : storage.properties[static_cast<size_t>(PropertyType::GravityWell)]) {
+			GravityWell* well = static_cast<GravityWell*>(property);
+			unsigned int i = storage.GetIndex(well->GetBody()->GetHandle());
+			wells.push_back(storage.positions[i] + well->GetPosition(), well->GetGravity(), well->GetRange(), i);
+		}
+	}
+
+	void World::IntegrateVelocities(const float& dt) {
+		const unsigned char mask = BodyFlags::Simulated | BodyFlags::Dynamic | BodyFlags::Awake;
+		const unsigned char* flags = storage.flags.data();
+		Math::Vector3* velocities = storage.velocities.data();
+		Math::Vector3* angularVelocities = storage.angularVelocities.data();
+		const Math::Vector3* accelerations = storage.accelerations.data();
+		const Math::Vector3* angularAccelerations = storage.angularAccelerations.data();
+		const Math::Vector3* fieldAccelerations = storage.fieldAccelerations.data();
+
+		jobs->ParallelFor(storage.size(), 1024, [=](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				if ((flags[i] & mask) != mask) continue;
+
+				velocities[i] += (accelerations[i] + fieldAccelerations[i]) * dt;
+				angularVelocities[i] += angularAccelerations[i] * dt;
+			}
+		});
+	}
+
+	void World::IntegratePositions(const float& dt) {
+		const unsigned char mask = BodyFlags::Simulated | BodyFlags::Dynamic | BodyFlags::Awake;
+		unsigned char* flags = storage.flags.data();
+		Math::Vector3* positions = storage.positions.data();
+		Math::Quaternion* rotations = storage.rotations.data();
+		const Math::Vector3* velocities = storage.velocities.data();
+		const Math::Vector3* angularVelocities = storage.angularVelocities.data();
+		// the angular velocity is in degrees a second
+		const float halfAngle = static_cast<float>(DEG_TO_RAD(dt)) * 0.5f;
+
+		jobs->ParallelFor(storage.size(), 1024, [=](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				if ((flags[i] & mask) != mask) continue;
+
+				positions[i] += velocities[i] * dt;
+				// q' = q + dt/2 * (0, w) * q, renormalized so the rotation doesnt drift
+				const Math::Vector3& w = angularVelocities[i];
+				if (w.x != 0.0f || w.y != 0.0f || w.z != 0.0f) {
+					Math::Quaternion spin = Math::Quaternion(0.0f, w.x * halfAngle, w.y * halfAngle, w.z * halfAngle) * rotations[i];
+					Math::Quaternion& q = rotations[i];
+					q = Math::Quaternion::Normalize(Math::Quaternion(q.w + spin.w, q.x + spin.x, q.y + spin.y, q.z + spin.z));
+				}
+				flags[i] |= BodyFlags::BoundsDirty;
+			}
+		});
+	}
+
+	// refits the bounds of spheres [begin, end) of indices from the sphere table
+	// the offsets are turned by the bodies' rotations first so the narrowphase and queries see them turned too
+	static void RefitSpheres(BodyStorage& storage, const unsigned int* indices, const size_t& begin, const size_t& end) {
+		SphereTable& spheres = storage.spheres;
+		for (size_t k = begin; k < end; ++k) {
+			unsigned int i = indices[k];
+			spheres.Orient(storage.shapeSlots[i], storage.rotations[i]);
+			storage.bounds[i] = spheres.GetBounds(storage.shapeSlots[i], storage.positions[i]);
+		}
+	}
+
+	void World::RefitBounds() {
+		for (size_t s = 0; s < CollisionShapeCount; ++s)
+			refitLists[s].clear();
+		refitMoved.clear();
+		refitOldBounds.clear();
+
+		// sort the dirty bodies by shape
+		unsigned char* flags = storage.flags.data();
+		const size_t count = storage.size();
+		for (size_t i = 0; i < count; ++i) {
+			if (!(flags[i] & BodyFlags::BoundsDirty)) continue;
+			flags[i] = static_cast<unsigned char>(flags[i] & ~BodyFlags::BoundsDirty);
+			if (!(flags[i] & BodyFlags::HasCollider)) continue;
+			broadphaseCurrent = false;
+
+			refitLists[static_cast<size_t>(storage.shapes[i])].push_back(static_cast<unsigned int>(i));
+
+			// a body that was moved by hand wakes the sleeping bodies between where it was and where it is
+			if (!(flags[i] & BodyFlags::Dynamic) && (flags[i] & BodyFlags::InBroadphase)) {
+				refitMoved.push_back(static_cast<unsigned int>(i));
+				refitOldBounds.push_back(storage.bounds[i]);
+			}
+		}
+
+		// refit each shape in its own loop
+		for (size_t s = 0; s < CollisionShapeCount; ++s) {
+			const DArray<unsigned int>& list = refitLists[s];
+			if (list.empty()) continue;
+			const unsigned int* indices = list.data();
+
+			switch (static_cast<CollisionShape>(s)) {
+				case CollisionShape::Sphere:
+					jobs->ParallelFor(list.size(), 512, [this, indices](size_t begin, size_t end) {
+						RefitSpheres(storage, indices, begin, end);
+					});
+					break;
+				default:
+					// shapes without a loop of their own are worked out one body at a time, so they are never left stale
+					for (size_t k = 0; k < list.size(); ++k)
+						storage.bounds[indices[k]] = storage.ComputeBounds(indices[k]);
+					break;
+			}
+		}
+
+		for (size_t k = 0; k < refitMoved.size(); ++k)
+			storage.wakeRegions.push_back(Math::Bounds3D::Combine(refitOldBounds[k], storage.bounds[refitMoved[k]]));
+	}
+
+	void World::UpdateBroadphase() {
+		const size_t count = storage.size();
+		for (size_t i = 0; i < count; ++i) {
+			unsigned char& f = storage.flags[i];
+			bool wanted = (f & BodyFlags::HasCollider) && (f & BodyFlags::Simulated);
+
+			if (wanted && (f & BodyFlags::InBroadphase)) {
+				// the broadphase ignores bodies that have not left their fattened bounds
+				broadphase->Move(storage.handles[i], storage.bounds[i]);
+			} else if (wanted) {
+				broadphase->Insert(storage.handles[i], storage.bounds[i], !(f & BodyFlags::Dynamic));
+				f |= BodyFlags::InBroadphase;
+				broadphaseCurrent = false;
+			} else if (f & BodyFlags::InBroadphase) {
+				broadphase->Remove(storage.handles[i]);
+				f = static_cast<unsigned char>(f & ~BodyFlags::InBroadphase);
+				broadphaseCurrent = false;
+			}
+		}
+	}
+
+	void World::UpdatePairs() {
+		RefitBounds();
+		UpdateBroadphase();
+		if (broadphaseCurrent) return;
+
+		broadphase->FindPairs(pairs);
+		broadphaseCurrent = true;
+	}
+
+	void World::UpdateIslands() {
+		const unsigned char dynamic = BodyFlags::Simulated | BodyFlags::Dynamic;
+		unsigned char* flags = storage.flags.data();
+		float* sleepTimes = storage.sleepTimes.data();
+		const size_t count = storage.size();
+
+		// wake the sleeping bodies in the wake regions
+		if (!storage.wakeRegions.empty()) {
+			for (size_t i = 0; i < count; ++i) {
+				if ((flags[i] & dynamic) != dynamic || (flags[i] & BodyFlags::Awake)) continue;
+				for (const Math::Bounds3D& region : storage.wakeRegions) {
+					if (!Math::Bounds3D::Intersects(region, storage.bounds[i])) continue;
+					flags[i] |= BodyFlags::Awake;
+					sleepTimes[i] = 0.0f;
+					break;
+				}
+			}
+			storage.wakeRegions.clear();
+		}
+
+		islands.Build(storage, contacts);
+
+		for (size_t island = 0; island < islands.size(); ++island) {
+			const unsigned int* bodies = islands.GetBodies(island);
+			const unsigned int bodyCount = islands.GetBodyCount(island);
+
+			// the island sleeps only when every body in it is ready to
+			// sleeping bodies keep their time so they dont hold the island awake
+			float minSleepTime = timeToSleep;
+			for (unsigned int i = 0; i < bodyCount; ++i)
+				minSleepTime = fminf(minSleepTime, sleepTimes[bodies[i]]);
+			bool sleep = allowSleeping && minSleepTime >= timeToSleep;
+
+			for (unsigned int i = 0; i < bodyCount; ++i) {
+				unsigned int b = bodies[i];
+				bool awake = (flags[b] & BodyFlags::Awake) != 0;
+				if (sleep && awake) {
+					flags[b] = static_cast<unsigned char>(flags[b] & ~BodyFlags::Awake);
+					storage.velocities[b] = Math::Vector3(0.0f);
+					storage.angularVelocities[b] = Math::Vector3(0.0f);
+				} else if (!sleep && !awake) {
+					// an awake body touched the island
+					flags[b] |= BodyFlags::Awake;
+					sleepTimes[b] = 0.0f;
+				}
+			}
+		}
+	}
+
+	void World::UpdateSleepTimes(const float& dt) {
+		const unsigned char mask = BodyFlags::Simulated | BodyFlags::Dynamic | BodyFlags::Awake;
+		const unsigned char* flags = storage.flags.data();
+		const Math::Vector3* velocities = storage.velocities.data();
+		const Math::Vector3* angularVelocities = storage.angularVelocities.data();
+		float* sleepTimes = storage.sleepTimes.data();
+
+		const float linearSq = sleepLinearVelocity * sleepLinearVelocity;
+		const float angularSq = sleepAngularVelocity * sleepAngularVelocity;
+
+		const size_t count = storage.size();
+		for (size_t i = 0; i < count; ++i) {
+			if ((flags[i] & mask) != mask) continue;
+
+			if (Math::Vector3::Dot(velocities[i], velocities[i]) > linearSq ||
+				Math::Vector3::Dot(angularVelocities[i], angularVelocities[i]) > angularSq)
+				sleepTimes[i] = 0.0f;
+			else
+				sleepTimes[i] += dt;
+		}
+	}
+
+	void World::SetAllowSleeping(const bool& allowSleeping_) {
+		allowSleeping = allowSleeping_;
+		if (allowSleeping) return;
+
+		const unsigned char dynamic = BodyFlags::Simulated | BodyFlags::Dynamic;
+		for (size_t i = 0; i < storage.size(); ++i) {
+			if ((storage.flags[i] & dynamic) != dynamic) continue;
+			storage.flags[i] |= BodyFlags::Awake;
+			storage.sleepTimes[i] = 0.0f;
+		}
+	}
+
+}
\ No newline at end of file
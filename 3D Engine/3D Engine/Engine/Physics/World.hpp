@@ -0,0 +1,267 @@
+#ifndef PHYSICS_WORLD_HPP
+#define PHYSICS_WORLD_HPP
+#include "BodyStorage.hpp"
+#include "Broadphase.hpp"
+#include "Narrowphase.hpp"
+#include "ContactCache.hpp"
+#include "ContactSolver.hpp"
+#include "ContinuousCollision.hpp"
+#include "SceneQuery.hpp"
+#include "CommandQueue.hpp"
+#include "Islands.hpp"
+#include "GravityField.hpp"
+#include "../Jobs/JobSystem.hpp"
+#include "Body.hpp"
+#include "Rigidbody.hpp"
+
+namespace Physics {
+
+	// the settings a world is created with
+	struct WorldSettings {
+		// which broadphase finds the pairs of bodies
+		BroadphaseType broadphase;
+		// how much the dynamic tree fattens bounds by
+		float treeMargin;
+		// how many axes sweep and prune keeps sorted, 1 or 3
+		int sweepAxes;
+		// the size of a hash grid cell, about the size of the common body works best
+		float gridCellSize;
+		// how many passes the contact solver makes each timestep
+		unsigned int solverIterations;
+		// if the contact solver solves once per timestep or once per substep
+		SolverMode solverMode;
+		// how many substeps each timestep is split into in substepped mode
+		unsigned int solverSubsteps;
+		// if islands of resting bodies are put to sleep
+		bool allowSleeping;
+		// the threads the world steps on, nullptr uses Jobs::JobSystem::Default()
+		Jobs::JobSystem* jobSystem;
+		// how the pull of long range gravity wells is added up
+		GravityMode gravityMode;
+		// the barnes hut opening angle, smaller is more exact and slower
+		float gravityTheta;
+		// wells with this range or less are summed exactly through a grid
+		float gravityGridRange;
+
+		WorldSettings()
+			: broadphase(BroadphaseType::DynamicTree), treeMargin(0.1f), sweepAxes(3), gridCellSize(1.0f)
+			, solverIterations(3), solverMode(SolverMode::Standard), solverSubsteps(4), allowSleeping(true), jobSystem(nullptr), gravityMode(GravityMode::BarnesHut), gravityTheta(0.5f), gravityGridRange(10.0f) { }
+	};
+
+	class World {
+
+		// the bodies and their colliders and properties are made in here
+		// so spawning lots of bodies doesnt go through the global heap
+		Memory::SlabAllocator allocator;
+
+		// the state of every body in the world
+		BodyStorage storage;
+
+		// runs the parallel parts of a timestep
+		Jobs::JobSystem* jobs;
+
+		// finds the bodies that could be touching
+		Broadphase* broadphase;
+
+		// the overlapping pairs found in the last timestep
+		DArray<BodyPair> pairs;
+		// the broadphase and the pairs match the bodies, cleared when a body moves, is added or is removed
+		bool broadphaseCurrent;
+
+		// turns the pairs into contacts
+		Narrowphase narrowphase;
+
+		// keeps contacts between timesteps so the solver can warm start
+		ContactCache contacts;
+		ContactSolver solver;
+
+		// stops fast bodies from passing through thin ones
+		ContinuousCollision continuous;
+
+		// the groups of touching bodies, rebuilt every timestep
+		Islands islands;
+
+		// the pull of the gravity wells
+		GravityField gravity;
+
+		// raycasts and overlap tests against the bodies
+		SceneQuery queries;
+
+		/// commands
+		// buffers submitted from other threads, applied at the start of every step
+		CommandQueue commands;
+		DArray<CommandBatch*> commandBatches;
+		// the bodies made by the batch being applied
+		DArray<BodyHandle> commandCreated;
+
+		/// bounds refitting
+		// the dirty bodies of each shape
+		DArray<unsigned int> refitLists[CollisionShapeCount];
+		// dirty bodies that dont move themselves and the bounds they had, they wake what they moved past
+		DArray<unsigned int> refitMoved;
+		DArray<Math::Bounds3D> refitOldBounds;
+
+		/// sleeping
+		bool allowSleeping;
+		float sleepLinearVelocity;
+		float sleepAngularVelocity;
+		float timeToSleep;
+
+		/// fixed timestep
+		float timestep;
+		float accumulator;
+		unsigned int maxSubsteps;
+
+		// gives a newly created body its storage and handle
+		void AddBody(Body* body);
+
+		// applies every submitted command buffer in key order
+		void ApplyCommands();
+
+		// applies one command, commandCreated holds the bodies made by its batch so far
+		void ApplyCommand(const BodyCommand& command);
+
+		// advances the world by exactly one timestep
+		void Simulate(const float& dt);
+
+		// integrates and solves the contacts over the solver's substeps
+		void SimulateSubsteps(const float& dt);
+
+		// collects the world position, gravity and range of every gravity well
+		void GatherWells();
+
+		// applies the accelerations of every simulated dynamic body to its velocity
+		void IntegrateVelocities(const float& dt);
+
+		// moves every simulated dynamic body by its velocity
+		void IntegratePositions(const float& dt);
+
+		// adds, removes and moves bodies in the broadphase to match their colliders and bounds
+		void UpdateBroadphase();
+
+		// refits the bounds and finds the pairs again if anything changed since they were last found
+		// run at the start of a timestep for changes made between timesteps and at the end so queries see the new positions
+		void UpdatePairs();
+
+		// wakes the bodies in the wake regions, builds the islands
+		// and puts islands to sleep or wakes them as a whole
+		void UpdateIslands();
+
+		// counts how long each awake body has been moving slowly
+		void UpdateSleepTimes(const float& dt);
+
+	public:
+
+		World(const WorldSettings& settings = WorldSettings());
+		~World();
+
+		World(const World&) = delete;
+		World& operator=(const World&) = delete;
+
+		/// creating/destroying bodies
+
+		// creates a body of type B that is owned by the world
+		template<typename B>
+		B* CreateBody() {
+			B* body = allocator.New<B>();
+			AddBody(body);
+			return body;
+		}
+
+		// removes the body from the world and deletes it
+		void DestroyBody(Body* body);
+		void DestroyBody(const BodyHandle& handle);
+
+		// queues the buffer's commands to be applied at the start of the next step
+		// safe to call from any thread, even while the world is stepping
+		void Submit(CommandBuffer& buffer) { commands.Submit(buffer); }
+
+		/// stepping
+
+		// applies the submitted commands then adds deltaTime to the accumulator and runs as many fixed timesteps as fit
+		// returns the number of timesteps that were run
+		unsigned int Step(const float& deltaTime);
+
+		/// queries
+
+		// finds the closest body the ray hits
+		bool Raycast(const Ray& ray, RaycastHit& hit) const { return queries.Raycast(ray, hit); }
+		// finds the closest body a sphere of radius moving along the ray hits
+		bool SphereCast(const Ray& ray, const float& radius, RaycastHit& hit) const { return queries.SphereCast(ray, radius, hit); }
+		// clears results and writes every body whose collider bounds overlap bounds into it
+		void OverlapBounds(const Math::Bounds3D& bounds, DArray<BodyHandle>& results) const { queries.OverlapBounds(bounds, results); }
+		// casts every ray over the job system, hits[i] is the closest hit of rays[i]
+		void RaycastBatch(const DArray<Ray>& rays, DArray<RaycastHit>& hits, const float& radius = 0.0f) { queries.RaycastBatch(rays, hits, radius); }
+
+		/// functions
+
+		// refits the bounds of every body that moved or had its collider change since the last refit
+		// called at the start of every timestep, call it before reading the storage's bounds between timesteps
+		void RefitBounds();
+
+		/// getters
+
+		size_t GetBodyCount() const { return storage.size(); }
+		// gets a body by its current dense index
+		Body* GetBody(const size_t& index) const { return storage.bodies[index]; }
+		// gets the body the handle points at, nullptr if the body was destroyed
+		Body* GetBody(const BodyHandle& handle) const {
+			return storage.IsValid(handle) ? storage.bodies[storage.GetIndex(handle)] : nullptr;
+		}
+		bool IsValid(const BodyHandle& handle) const { return storage.IsValid(handle); }
+		const BodyStorage& GetStorage() const { return storage; }
+		// the allocator the bodies, colliders and properties come from
+		const Memory::SlabAllocator& GetAllocator() const { return allocator; }
+		Broadphase* GetBroadphase() const { return broadphase; }
+		// the pairs of bodies whose bounds overlapped at the end of the last timestep
+		const DArray<BodyPair>& GetPairs() const { return pairs; }
+		Narrowphase& GetNarrowphase() { return narrowphase; }
+		// the contacts kept from the last timestep
+		const ContactCache& GetContacts() const { return contacts; }
+		ContactSolver& GetSolver() { return solver; }
+		ContinuousCollision& GetContinuous() { return continuous; }
+		const Islands& GetIslands() const { return islands; }
+		Jobs::JobSystem* GetJobSystem() const { return jobs; }
+		GravityField& GetGravityField() { return gravity; }
+		SceneQuery& GetQueries() { return queries; }
+		CommandQueue& GetCommands() { return commands; }
+		bool GetAllowSleeping() const { return allowSleeping; }
+		float GetSleepLinearVelocity() const { return sleepLinearVelocity; }
+		float GetSleepAngularVelocity() const { return sleepAngularVelocity; }
+		float GetTimeToSleep() const { return timeToSleep; }
+		float GetTimestep() const { return timestep; }
+		unsigned int GetMaxSubsteps() const { return maxSubsteps; }
+		// how far between the last and next timestep the world is, used to interpolate rendering
+		float GetInterpolationAlpha() const { return accumulator / timestep; }
+
+		/// setters
+
+		void SetTimestep(const float& timestep_) {
+			timestep = timestep_;
+			if (timestep <= 0.0001f) timestep = 0.0001f;
+		}
+		void SetMaxSubsteps(const unsigned int& maxSubsteps_) {
+			maxSubsteps = maxSubsteps_;
+			if (maxSubsteps == 0) maxSubsteps = 1;
+		}
+		// turning sleeping off wakes every body
+		void SetAllowSleeping(const bool& allowSleeping_);
+		// bodies slower than this for timeToSleep seconds can sleep
+		void SetSleepLinearVelocity(const float& sleepLinearVelocity_) {
+			sleepLinearVelocity = sleepLinearVelocity_;
+			if (sleepLinearVelocity < 0.0f) sleepLinearVelocity = 0.0f;
+		}
+		void SetSleepAngularVelocity(const float& sleepAngularVelocity_) {
+			sleepAngularVelocity = sleepAngularVelocity_;
+			if (sleepAngularVelocity < 0.0f) sleepAngularVelocity = 0.0f;
+		}
+		void SetTimeToSleep(const float& timeToSleep_) {
+			timeToSleep = timeToSleep_;
+			if (timeToSleep < 0.0f) timeToSleep = 0.0f;
+		}
+
+	};
+
+}
+
+#endif // !PHYSICS_WORLD_HPP
\ No newline at end of file
@@ -0,0 +1,9 @@
+#include "RunTransforms.hpp"
+
+void RunAVX2(const TransformInputs& in, TransformResults& out) {
+	RunCase(in, out);
+}
+
+bool AVX2Enabled() {
+	return Math::SIMD::HasAVX2();
+}
\ No newline at end of file
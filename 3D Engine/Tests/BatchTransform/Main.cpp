@@ -0,0 +1,169 @@
+#include "TransformCases.hpp"
+#include "../../3D Engine/Engine/Math/BatchTransform.hpp"
+#include "../../3D Engine/Engine/Math/Transform.hpp"
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+// checks every BatchTransform function against Matrix4 * Vector4 one vector at a time
+// both with the avx2 kernels and with MATH_NO_AVX2, on random matrices and vectors
+// normals are checked against the inverse transpose of the whole matrix, normalized
+// errors are in ulps of the size of the terms that were added up, like Tests/MathSIMD
+// returns 1 if any check goes over its bound
+
+// counts around the 8 wide groups, and one long enough to be split over the job system
+static const size_t Counts[] = { 0, 1, 7, 8, 9, 15, 16, 17, 63, 64, 65, 1000, 1003, Math::BatchParallelCount + 5 };
+static const int CasesPerCount = 4;
+
+struct Check {
+	const char* name;
+	// the bound in ulps
+	double bound;
+	double worst;
+	int count;
+};
+
+static Check checks[] = {
+	{ "TransformPoints", 4.0, 0.0, 0 },
+	{ "TransformDirections", 4.0, 0.0, 0 },
+	{ "TransformNormals", 8.0, 0.0, 0 },
+	{ "TransformVectors Matrix3", 4.0, 0.0, 0 },
+	{ "TransformVectors Vector4", 4.0, 0.0, 0 },
+	{ "axis TransformPoints", 4.0, 0.0, 0 },
+	{ "axis TransformDirections", 4.0, 0.0, 0 },
+	{ "axis TransformNormals", 8.0, 0.0, 0 },
+	{ "TransformPoints in place", 0.0, 0.0, 0 },
+};
+
+enum CheckIndex {
+	Points, Directions, Normals, Vectors, Vectors4,
+	AxisPoints, AxisDirections, AxisNormals, InPlace
+};
+
+// how far apart a and b are in ulps of scale
+static void Compare(const CheckIndex& check, const float& a, const float& b, double scale) {
+	if (scale < FLT_MIN) scale = FLT_MIN;
+	double ulps = fabs(static_cast<double>(a) - static_cast<double>(b)) / (scale * FLT_EPSILON);
+	// nan never compares so it has to be caught on its own
+	if (a != a || b != b) ulps = HUGE_VAL;
+	if (ulps > checks[check].worst) checks[check].worst = ulps;
+	++checks[check].count;
+}
+
+static float Random(std::mt19937& rng, const float& lo, const float& hi) {
+	// std distributions differ between standard libraries, this gives the same cases everywhere
+	return lo + (hi - lo) * static_cast<float>(rng() >> 8) * (1.0f / 16777216.0f);
+}
+
+static Math::Quaternion RandomRotation(std::mt19937& rng) {
+	float q[4], magSq;
+	do {
+		for (int i = 0; i < 4; ++i)
+			q[i] = Random(rng, -1.0f, 1.0f);
+		magSq = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+	} while (magSq < 0.01f);
+	return Math::Quaternion::Normalize(Math::Quaternion(q[0], q[1], q[2], q[3]));
+}
+
+// |m| * |v| for one row, the size of the terms Matrix4 * Vector4 adds up
+static double RowScale(const float* m, const int& row, const Math::Vector4& v) {
+	return fabs(m[row * 4] * v.x) + fabs(m[row * 4 + 1] * v.y) + fabs(m[row * 4 + 2] * v.z) + fabs(m[row * 4 + 3] * v.w);
+}
+
+// compares the x y z results starting at out against matrix * (x, y, z, w)
+static void CompareVectors(const CheckIndex& check, const Math::Matrix4& matrix, const std::vector<float>& in, const float& w, const std::vector<float>& out) {
+	for (size_t i = 0; i < in.size(); i += 3) {
+		Math::Vector4 v(in[i], in[i + 1], in[i + 2], w);
+		Math::Vector4 expected = matrix * v;
+		Compare(check, out[i], expected.x, RowScale(matrix.m, 0, v));
+		Compare(check, out[i + 1], expected.y, RowScale(matrix.m, 1, v));
+		Compare(check, out[i + 2], expected.z, RowScale(matrix.m, 2, v));
+	}
+}
+
+// normals are unit length so they are compared in ulps of 1
+static void CompareNormals(const CheckIndex& check, const Math::Matrix4& inverseTranspose, const std::vector<float>& in, const std::vector<float>& out) {
+	for (size_t i = 0; i < in.size(); i += 3) {
+		// the translation ends up in the bottom row of the inverse transpose, so only x y z are normalized
+		Math::Vector4 turned = inverseTranspose * Math::Vector4(in[i], in[i + 1], in[i + 2], 0.0f);
+		Math::Vector3 expected = Math::Vector3::Normalize(Math::Vector3(turned.x, turned.y, turned.z));
+		Compare(check, out[i], expected.x, 1.0);
+		Compare(check, out[i + 1], expected.y, 1.0);
+		Compare(check, out[i + 2], expected.z, 1.0);
+	}
+}
+
+static void CheckCase(const TransformInputs& in, const TransformResults& out) {
+	const float* m = in.matrix;
+	Math::Matrix4 matrix(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7],
+						 m[8], m[9], m[10], m[11], m[12], m[13], m[14], m[15]);
+	Math::Matrix4 inverseTranspose = matrix.Inverse().Transpose();
+
+	CompareVectors(Points, matrix, in.vectors, 1.0f, out.points);
+	CompareVectors(Directions, matrix, in.vectors, 0.0f, out.directions);
+	CompareNormals(Normals, inverseTranspose, in.vectors, out.normals);
+	CompareVectors(AxisPoints, matrix, in.vectors, 1.0f, out.axisPoints);
+	CompareVectors(AxisDirections, matrix, in.vectors, 0.0f, out.axisDirections);
+	CompareNormals(AxisNormals, inverseTranspose, in.vectors, out.axisNormals);
+
+	// the matrix3 is put in a matrix4 with no translation so it goes through the same Matrix4 * Vector4
+	const float* m3 = in.matrix3;
+	Math::Matrix4 matrix3(m3[0], m3[1], m3[2], 0.0f, m3[3], m3[4], m3[5], 0.0f,
+						  m3[6], m3[7], m3[8], 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+	CompareVectors(Vectors, matrix3, in.vectors, 0.0f, out.vectors);
+
+	for (size_t i = 0; i < in.vectors4.size(); i += 4) {
+		Math::Vector4 v(in.vectors4[i], in.vectors4[i + 1], in.vectors4[i + 2], in.vectors4[i + 3]);
+		Math::Vector4 expected = matrix * v;
+		Compare(Vectors4, out.vectors4[i], expected.x, RowScale(m, 0, v));
+		Compare(Vectors4, out.vectors4[i + 1], expected.y, RowScale(m, 1, v));
+		Compare(Vectors4, out.vectors4[i + 2], expected.z, RowScale(m, 2, v));
+		Compare(Vectors4, out.vectors4[i + 3], expected.w, RowScale(m, 3, v));
+	}
+
+	// writing over the input has to give exactly what writing to another array does
+	for (size_t i = 0; i < out.points.size(); ++i)
+		Compare(InPlace, out.inPlace[i], out.points[i], 1.0);
+}
+
+int main() {
+	printf("avx2 %s\n", AVX2Enabled() ? "on" : "off, both builds are scalar");
+
+	std::mt19937 rng(12345);
+	for (const size_t& count : Counts) {
+		for (int n = 0; n < CasesPerCount; ++n) {
+			TransformInputs in;
+			// a rotation with non uniform scale so the normals need the inverse transpose
+			Math::Vector3 position(Random(rng, -10.0f, 10.0f), Random(rng, -10.0f, 10.0f), Random(rng, -10.0f, 10.0f));
+			Math::Vector3 scale(Random(rng, 0.25f, 4.0f), Random(rng, 0.25f, 4.0f), Random(rng, 0.25f, 4.0f));
+			Math::Transform transform(position, RandomRotation(rng), scale);
+			for (int i = 0; i < 16; ++i)
+				in.matrix[i] = transform.GetMatrix().m[i];
+			for (int i = 0; i < 9; ++i)
+				in.matrix3[i] = Random(rng, -2.0f, 2.0f);
+
+			in.vectors.resize(count * 3);
+			for (float& v : in.vectors)
+				v = Random(rng, -100.0f, 100.0f);
+			in.vectors4.resize(count * 4);
+			for (float& v : in.vectors4)
+				v = Random(rng, -100.0f, 100.0f);
+
+			TransformResults avx2, scalar;
+			RunAVX2(in, avx2);
+			RunScalar(in, scalar);
+			CheckCase(in, avx2);
+			CheckCase(in, scalar);
+		}
+	}
+
+	bool passed = true;
+	for (const Check& check : checks) {
+		bool ok = check.worst <= check.bound;
+		passed = passed && ok;
+		printf("%-26s %8d values  max %8.3f ulps  bound %5.1f  %s\n", check.name, check.count, check.worst, check.bound, ok ? "ok" : "FAILED");
+	}
+	printf(passed ? "all passed\n" : "some checks FAILED\n");
+	return passed ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef TESTS_RUN_TRANSFORMS_HPP
+#define TESTS_RUN_TRANSFORMS_HPP
+#include "TransformCases.hpp"
+#include "../../3D Engine/Engine/Math/BatchTransform.hpp"
+
+// the body of RunAVX2 and RunScalar, each one includes this with a different build of BatchTransform
+// static so the two copies don't collide when they are linked together
+
+static std::vector<Math::Vector3> MakeVectors(const std::vector<float>& v) {
+	std::vector<Math::Vector3> vectors;
+	for (size_t i = 0; i < v.size(); i += 3)
+		vectors.push_back(Math::Vector3(v[i], v[i + 1], v[i + 2]));
+	return vectors;
+}
+
+static void CopyOut(const std::vector<Math::Vector3>& vectors, std::vector<float>& out) {
+	for (const Math::Vector3& v : vectors) {
+		out.push_back(v.x); out.push_back(v.y); out.push_back(v.z);
+	}
+}
+
+static void CopyOut(const std::vector<float>& x, const std::vector<float>& y, const std::vector<float>& z, std::vector<float>& out) {
+	for (size_t i = 0; i < x.size(); ++i) {
+		out.push_back(x[i]); out.push_back(y[i]); out.push_back(z[i]);
+	}
+}
+
+static void RunCase(const TransformInputs& in, TransformResults& out) {
+	const float* m = in.matrix;
+	Math::Matrix4 matrix(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7],
+						 m[8], m[9], m[10], m[11], m[12], m[13], m[14], m[15]);
+	const float* m3 = in.matrix3;
+	Math::Matrix3 matrix3(m3[0], m3[1], m3[2], m3[3], m3[4], m3[5], m3[6], m3[7], m3[8]);
+
+	/// arrays of vectors
+	const std::vector<Math::Vector3> vectors = MakeVectors(in.vectors);
+	const size_t count = vectors.size();
+	std::vector<Math::Vector3> results(count);
+	Math::TransformPoints(matrix, vectors.data(), results.data(), count);
+	CopyOut(results, out.points);
+	Math::TransformDirections(matrix, vectors.data(), results.data(), count);
+	CopyOut(results, out.directions);
+	Math::TransformNormals(matrix, vectors.data(), results.data(), count);
+	CopyOut(results, out.normals);
+	Math::TransformVectors(matrix3, vectors.data(), results.data(), count);
+	CopyOut(results, out.vectors);
+
+	results = vectors;
+	Math::TransformPoints(matrix, results.data(), results.data(), count);
+	CopyOut(results, out.inPlace);
+
+	std::vector<Math::Vector4> vectors4, results4(count);
+	for (size_t i = 0; i < in.vectors4.size(); i += 4)
+		vectors4.push_back(Math::Vector4(in.vectors4[i], in.vectors4[i + 1], in.vectors4[i + 2], in.vectors4[i + 3]));
+	Math::TransformVectors(matrix, vectors4.data(), results4.data(), count);
+	for (const Math::Vector4& v : results4) {
+		out.vectors4.push_back(v.x); out.vectors4.push_back(v.y); out.vectors4.push_back(v.z); out.vectors4.push_back(v.w);
+	}
+
+	/// arrays of each axis
+	std::vector<float> x(count), y(count), z(count), outX(count), outY(count), outZ(count);
+	for (size_t i = 0; i < count; ++i) {
+		x[i] = vectors[i].x; y[i] = vectors[i].y; z[i] = vectors[i].z;
+	}
+	Math::TransformPoints(matrix, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), count);
+	CopyOut(outX, outY, outZ, out.axisPoints);
+	Math::TransformDirections(matrix, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), count);
+	CopyOut(outX, outY, outZ, out.axisDirections);
+	Math::TransformNormals(matrix, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), count);
+	CopyOut(outX, outY, outZ, out.axisNormals);
+}
+
+#endif // !TESTS_RUN_TRANSFORMS_HPP
\ No newline at end of file
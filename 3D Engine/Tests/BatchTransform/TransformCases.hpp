@@ -0,0 +1,34 @@
+#ifndef TESTS_TRANSFORM_CASES_HPP
+#define TESTS_TRANSFORM_CASES_HPP
+#include <vector>
+
+// one random case, plain floats so both builds of BatchTransform can read it
+struct TransformInputs {
+	// the last row is 0 0 0 1
+	float matrix[16];
+	float matrix3[9];
+	// x y z for each vector
+	std::vector<float> vectors;
+	// x y z w for each vector
+	std::vector<float> vectors4;
+};
+
+// what one build of BatchTransform gave for a case, x y z for each vector
+struct TransformResults {
+	std::vector<float> points, directions, normals, vectors;
+	// x y z w for each vector
+	std::vector<float> vectors4;
+	// the same from the versions that take an array for each axis
+	std::vector<float> axisPoints, axisDirections, axisNormals;
+	// TransformPoints with out the same array as in
+	std::vector<float> inPlace;
+};
+
+// runs the case with the avx2 kernels when the cpu has them, defined in AVX2Transforms.cpp
+void RunAVX2(const TransformInputs& in, TransformResults& out);
+// runs the case with MATH_NO_AVX2, defined in ScalarTransforms.cpp
+void RunScalar(const TransformInputs& in, TransformResults& out);
+// whether RunAVX2 really used avx2
+bool AVX2Enabled();
+
+#endif // !TESTS_TRANSFORM_CASES_HPP
\ No newline at end of file
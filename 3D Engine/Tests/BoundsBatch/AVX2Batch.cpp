@@ -0,0 +1,9 @@
+#include "RunBatch.hpp"
+
+void RunAVX2(const BatchInputs& in, BatchResults& out) {
+	RunCase(in, out);
+}
+
+bool AVX2Enabled() {
+	return Math::SIMD::HasAVX2();
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#ifndef TESTS_BATCH_CASES_HPP
+#define TESTS_BATCH_CASES_HPP
+#include <cstddef>
+#include <vector>
+
+// one random case, plain floats so both builds of BoundsBatch can read it
+struct BatchInputs {
+	// min x y z then max x y z for each box
+	std::vector<float> a, b;
+	float bounds[6];
+	// Overlap is also run over [begin, end) of a
+	size_t begin, end;
+};
+
+// what one build of BoundsBatch gave for a case
+struct BatchResults {
+	// one word more than OverlapMask needs, it has to come back untouched
+	std::vector<unsigned int> mask;
+	std::vector<unsigned int> overlap, overlapRange;
+	// the index from the first array then the index from the second for each pair
+	std::vector<unsigned int> pairs, selfPairs;
+};
+
+// the value OverlapMask mustn't write over in the word after the mask
+static const unsigned int MaskGuard = 0xdeadbeefu;
+
+// runs the case with the avx2 kernels when the cpu has them, defined in AVX2Batch.cpp
+void RunAVX2(const BatchInputs& in, BatchResults& out);
+// runs the case with MATH_NO_AVX2, defined in ScalarBatch.cpp
+void RunScalar(const BatchInputs& in, BatchResults& out);
+// whether RunAVX2 really used avx2
+bool AVX2Enabled();
+
+#endif // !TESTS_BATCH_CASES_HPP
\ No newline at end of file
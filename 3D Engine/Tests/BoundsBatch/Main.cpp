@@ -0,0 +1,139 @@
+#include "BatchCases.hpp"
+#include "../../3D Engine/Engine/Math/Bounds.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+// checks OverlapMask, Overlap and OverlapPairs against Bounds3D::Intersects one box at a time
+// both with the avx2 kernels and with MATH_NO_AVX2, on random boxes
+// the corners are whole numbers so plenty of boxes only touch, which has to count as overlapping
+// returns 1 if any result is different
+
+// counts around the 8 wide groups, the 32 bit mask words and the 512 box tiles of OverlapPairs
+static const size_t Counts[] = { 0, 1, 7, 8, 9, 31, 32, 33, 63, 64, 65, 100, 511, 512, 513, 1000, 1024, 1031, 1537 };
+static const int CasesPerCount = 4;
+
+struct Check {
+	const char* name;
+	int cases;
+	int failed;
+};
+
+static Check checks[] = {
+	{ "OverlapMask", 0, 0 },
+	{ "Overlap", 0, 0 },
+	{ "Overlap range", 0, 0 },
+	{ "OverlapPairs a b", 0, 0 },
+	{ "OverlapPairs self", 0, 0 },
+};
+
+enum CheckIndex {
+	Mask, Indices, Range, Pairs, SelfPairs
+};
+
+static void Compare(const CheckIndex& check, const bool& same) {
+	++checks[check].cases;
+	if (!same) ++checks[check].failed;
+}
+
+static float Random(std::mt19937& rng, const int& lo, const int& hi) {
+	// std distributions differ between standard libraries, this gives the same cases everywhere
+	return static_cast<float>(lo + static_cast<int>(rng() % static_cast<unsigned int>(hi - lo + 1)));
+}
+
+// boxes 0 to 4 wide in a space that grows with the count so each box only overlaps a few
+static void RandomBox(std::mt19937& rng, const int& extent, float* box) {
+	for (int i = 0; i < 3; ++i) {
+		box[i] = Random(rng, -extent, extent);
+		box[i + 3] = box[i] + Random(rng, 0, 4);
+	}
+}
+
+static Math::Bounds3D MakeBounds(const float* b) {
+	return Math::Bounds3D(Math::Vector3(b[0], b[1], b[2]), Math::Vector3(b[3], b[4], b[5]));
+}
+
+static bool Intersects(const std::vector<float>& boxes, const size_t& i, const Math::Bounds3D& bounds) {
+	return Math::Bounds3D::Intersects(MakeBounds(&boxes[i * 6]), bounds);
+}
+
+// the pairs as (first, second) sorted, the tiles hand them back in a different order than a plain loop
+static std::vector<std::pair<unsigned int, unsigned int>> Sorted(const std::vector<unsigned int>& pairs) {
+	std::vector<std::pair<unsigned int, unsigned int>> sorted;
+	for (size_t i = 0; i < pairs.size(); i += 2)
+		sorted.push_back(std::make_pair(pairs[i], pairs[i + 1]));
+	std::sort(sorted.begin(), sorted.end());
+	return sorted;
+}
+
+static void CheckCase(const BatchInputs& in, const BatchResults& out) {
+	const size_t countA = in.a.size() / 6, countB = in.b.size() / 6;
+	Math::Bounds3D bounds = MakeBounds(in.bounds);
+
+	/// one against many
+	std::vector<unsigned int> mask((countA + 31) / 32 + 1, 0), overlap, overlapRange;
+	mask.back() = MaskGuard;
+	for (size_t i = 0; i < countA; ++i) {
+		if (!Intersects(in.a, i, bounds)) continue;
+		mask[i / 32] |= 1u << (i % 32);
+		overlap.push_back(static_cast<unsigned int>(i));
+		if (i >= in.begin && i < in.end) overlapRange.push_back(static_cast<unsigned int>(i));
+	}
+	Compare(Mask, out.mask == mask);
+	Compare(Indices, out.overlap == overlap);
+	Compare(Range, out.overlapRange == overlapRange);
+
+	/// many against many
+	std::vector<std::pair<unsigned int, unsigned int>> pairs, selfPairs;
+	for (size_t i = 0; i < countA; ++i) {
+		Math::Bounds3D box = MakeBounds(&in.a[i * 6]);
+		for (size_t j = 0; j < countB; ++j)
+			if (Intersects(in.b, j, box)) pairs.push_back(std::make_pair(static_cast<unsigned int>(i), static_cast<unsigned int>(j)));
+		for (size_t j = i + 1; j < countA; ++j)
+			if (Intersects(in.a, j, box)) selfPairs.push_back(std::make_pair(static_cast<unsigned int>(i), static_cast<unsigned int>(j)));
+	}
+	Compare(Pairs, Sorted(out.pairs) == pairs);
+	Compare(SelfPairs, Sorted(out.selfPairs) == selfPairs);
+}
+
+int main() {
+	printf("avx2 %s\n", AVX2Enabled() ? "on" : "off, both builds are scalar");
+
+	std::mt19937 rng(12345);
+	size_t pairCount = 0;
+	for (const size_t& count : Counts) {
+		const int extent = 4 + static_cast<int>(count) / 16;
+		for (int n = 0; n < CasesPerCount; ++n) {
+			BatchInputs in;
+			in.a.resize(count * 6);
+			in.b.resize((count + n * 3) * 6);
+			for (size_t i = 0; i < in.a.size(); i += 6)
+				RandomBox(rng, extent, &in.a[i]);
+			for (size_t i = 0; i < in.b.size(); i += 6)
+				RandomBox(rng, extent, &in.b[i]);
+			// a big box so the one against many tests find more than a handful
+			RandomBox(rng, extent, in.bounds);
+			for (int i = 3; i < 6; ++i)
+				in.bounds[i] += static_cast<float>(extent);
+			in.begin = count ? rng() % count : 0;
+			in.end = in.begin + (count ? rng() % (count - in.begin + 1) : 0);
+
+			BatchResults avx2, scalar;
+			RunAVX2(in, avx2);
+			RunScalar(in, scalar);
+			CheckCase(in, avx2);
+			CheckCase(in, scalar);
+			pairCount += avx2.pairs.size() / 2 + avx2.selfPairs.size() / 2;
+		}
+	}
+
+	bool passed = true;
+	for (const Check& check : checks) {
+		bool ok = check.failed == 0;
+		passed = passed && ok;
+		printf("%-18s %4d cases  %4d wrong  %s\n", check.name, check.cases, check.failed, ok ? "ok" : "FAILED");
+	}
+	printf("%zu pairs found\n", pairCount);
+	printf(passed ? "all passed\n" : "some checks FAILED\n");
+	return passed ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef TESTS_RUN_BATCH_HPP
+#define TESTS_RUN_BATCH_HPP
+#include "BatchCases.hpp"
+#include "../../3D Engine/Engine/Math/BoundsBatch.hpp"
+
+// the body of RunAVX2 and RunScalar, each one includes this with a different build of BoundsBatch
+// static so the two copies don't collide when they are linked together
+
+static Math::Bounds3D MakeBounds(const float* b) {
+	return Math::Bounds3D(Math::Vector3(b[0], b[1], b[2]), Math::Vector3(b[3], b[4], b[5]));
+}
+
+static void Pack(const std::vector<float>& boxes, Math::PackedBounds3D& packed) {
+	for (size_t i = 0; i < boxes.size(); i += 6)
+		packed.push_back(MakeBounds(&boxes[i]));
+}
+
+static void CopyOut(const DArray<unsigned int>& indices, std::vector<unsigned int>& out) {
+	for (size_t i = 0; i < indices.size(); ++i)
+		out.push_back(indices[i]);
+}
+
+static void CopyOut(const DArray<Math::IndexPair>& pairs, std::vector<unsigned int>& out) {
+	for (size_t i = 0; i < pairs.size(); ++i) {
+		out.push_back(pairs[i].a);
+		out.push_back(pairs[i].b);
+	}
+}
+
+static void RunCase(const BatchInputs& in, BatchResults& out) {
+	Math::PackedBounds3D a, b;
+	Pack(in.a, a);
+	Pack(in.b, b);
+	Math::Bounds3D bounds = MakeBounds(in.bounds);
+
+	/// one against many
+	out.mask.assign((a.size() + 31) / 32 + 1, MaskGuard);
+	Math::OverlapMask(bounds, a, out.mask.data());
+
+	DArray<unsigned int> indices;
+	Math::Overlap(bounds, a, indices);
+	CopyOut(indices, out.overlap);
+	indices.clear();
+	Math::Overlap(bounds, a, in.begin, in.end, indices);
+	CopyOut(indices, out.overlapRange);
+
+	/// many against many
+	DArray<Math::IndexPair> pairs;
+	Math::OverlapPairs(a, b, pairs);
+	CopyOut(pairs, out.pairs);
+	pairs.clear();
+	Math::OverlapPairs(a, pairs);
+	CopyOut(pairs, out.selfPairs);
+}
+
+#endif // !TESTS_RUN_BATCH_HPP
\ No newline at end of file
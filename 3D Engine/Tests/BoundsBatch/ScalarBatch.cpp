@@ -0,0 +1,19 @@
+// the standard headers the math headers use come first so the rename below can't touch them
+#include <math.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+// builds BoundsBatch with only its scalar kernels in this file
+// Math is renamed so it doesn't clash with the build in AVX2Batch.cpp when linked together
+#define MATH_NO_AVX2
+#define Math ScalarMath
+#include "RunBatch.hpp"
+#include "../../3D Engine/Engine/Math/BoundsBatch.cpp"
+
+void RunScalar(const BatchInputs& in, BatchResults& out) {
+	RunCase(in, out);
+}
\ No newline at end of file
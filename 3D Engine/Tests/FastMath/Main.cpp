@@ -0,0 +1,192 @@
+#include "../../3D Engine/Engine/Math/Fast.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// checks the errors of Math::Fast against the table in Fast.hpp and times it against the c library
+// every function runs at each accuracy one at a time (scalar) and through the array versions,
+// which are 8 wide when the cpu has avx2
+// returns 1 if any error goes over the documented bound
+
+using Math::Fast::Accuracy;
+
+static const size_t Count = 1 << 16;
+// the best of this many runs is kept so other work on the machine doesn't show up in the times
+static const int Repeats = 7;
+
+static const char* AccuracyNames[3] = { "Low", "Medium", "Full" };
+
+// the same random numbers on every platform
+struct Random {
+	unsigned int state;
+
+	Random(const unsigned int& seed) : state(seed) { }
+
+	float Next(const float& lo, const float& hi) {
+		state = state * 1664525u + 1013904223u;
+		return lo + (hi - lo) * static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+	}
+};
+
+/// the functions under test
+// each one has the fast versions, the c library version it replaces, a double reference and its inputs
+// y is only used by Atan2
+
+struct SinFunction {
+	static const char* Name() { return "Sin"; }
+	static bool Relative() { return false; }
+	template<Accuracy A> static float Scalar(const float& x, const float&) { return Math::Fast::Sin<A>(x); }
+	static void Array(const float* x, const float*, float* out, const size_t& n, const Accuracy& a) { Math::Fast::Sin(x, out, n, a); }
+	static float Library(const float& x, const float&) { return sinf(x); }
+	static double Reference(const double& x, const double&) { return sin(x); }
+	static void Inputs(Random& r, float& x, float& y) { x = r.Next(-8192.0f, 8192.0f); y = 0.0f; }
+};
+
+struct CosFunction {
+	static const char* Name() { return "Cos"; }
+	static bool Relative() { return false; }
+	template<Accuracy A> static float Scalar(const float& x, const float&) { return Math::Fast::Cos<A>(x); }
+	static void Array(const float* x, const float*, float* out, const size_t& n, const Accuracy& a) { Math::Fast::Cos(x, out, n, a); }
+	static float Library(const float& x, const float&) { return cosf(x); }
+	static double Reference(const double& x, const double&) { return cos(x); }
+	static void Inputs(Random& r, float& x, float& y) { x = r.Next(-8192.0f, 8192.0f); y = 0.0f; }
+};
+
+struct Atan2Function {
+	static const char* Name() { return "Atan2"; }
+	static bool Relative() { return false; }
+	template<Accuracy A> static float Scalar(const float& x, const float& y) { return Math::Fast::Atan2<A>(y, x); }
+	static void Array(const float* x, const float* y, float* out, const size_t& n, const Accuracy& a) { Math::Fast::Atan2(y, x, out, n, a); }
+	static float Library(const float& x, const float& y) { return atan2f(y, x); }
+	static double Reference(const double& x, const double& y) { return atan2(y, x); }
+	static void Inputs(Random& r, float& x, float& y) { x = r.Next(-100.0f, 100.0f); y = r.Next(-100.0f, 100.0f); }
+};
+
+struct ExpFunction {
+	static const char* Name() { return "Exp"; }
+	static bool Relative() { return true; }
+	template<Accuracy A> static float Scalar(const float& x, const float&) { return Math::Fast::Exp<A>(x); }
+	static void Array(const float* x, const float*, float* out, const size_t& n, const Accuracy& a) { Math::Fast::Exp(x, out, n, a); }
+	static float Library(const float& x, const float&) { return expf(x); }
+	static double Reference(const double& x, const double&) { return exp(x); }
+	static void Inputs(Random& r, float& x, float& y) { x = r.Next(Math::Fast::ExpMin, Math::Fast::ExpMax); y = 0.0f; }
+};
+
+struct RsqrtFunction {
+	static const char* Name() { return "Rsqrt"; }
+	static bool Relative() { return true; }
+	template<Accuracy A> static float Scalar(const float& x, const float&) { return Math::Fast::Rsqrt<A>(x); }
+	static void Array(const float* x, const float*, float* out, const size_t& n, const Accuracy& a) { Math::Fast::Rsqrt(x, out, n, a); }
+	static float Library(const float& x, const float&) { return 1.0f / sqrtf(x); }
+	static double Reference(const double& x, const double&) { return 1.0 / sqrt(x); }
+	// spread over many exponents since the estimate is only looked up from the top bits
+	static void Inputs(Random& r, float& x, float& y) { x = ldexpf(r.Next(1.0f, 2.0f), static_cast<int>(r.Next(-100.0f, 100.0f))); y = 0.0f; }
+};
+
+/// the documented bounds, the same table as Fast.hpp
+
+static const double SinCosBounds[3] = { 2.0e-3, 1.1e-5, 1.0e-7 };
+static const double Atan2Bounds[3] = { 6.1e-4, 2.0e-6, 3.5e-7 };
+static const double ExpBounds[3] = { 1.8e-3, 2.8e-6, 1.2e-7 };
+static const double RsqrtBounds[3] = { 3.7e-4, 3.0e-7, 1.2e-7 };
+
+// stops the timed loops from being thrown away
+static volatile float sink;
+
+template<typename T>
+static double BestTime(const T& run) {
+	double best = HUGE_VAL;
+	for (int r = 0; r < Repeats; ++r) {
+		auto start = std::chrono::steady_clock::now();
+		run();
+		auto end = std::chrono::steady_clock::now();
+		best = fmin(best, std::chrono::duration<double, std::nano>(end - start).count());
+	}
+	return best / Count;
+}
+
+template<typename F>
+static double Error(const float& value, const float& x, const float& y) {
+	double reference = F::Reference(x, y);
+	double error = fabs(static_cast<double>(value) - reference);
+	if (F::Relative()) error /= fabs(reference);
+	// nan is never less than a bound so it has to be caught on its own
+	if (value != value) error = HUGE_VAL;
+	return error;
+}
+
+// prints the line for one accuracy and returns false if an error was over its bound
+// the scalar versions are timed with the accuracy as a template argument, the way a caller would use them in a loop
+template<typename F, Accuracy A>
+static bool RunAccuracy(const double& bound, const std::vector<float>& x, const std::vector<float>& y, std::vector<float>& out, const double& libraryTime) {
+	double scalarError = 0.0;
+	for (size_t i = 0; i < Count; ++i)
+		scalarError = fmax(scalarError, Error<F>(F::template Scalar<A>(x[i], y[i]), x[i], y[i]));
+	double scalarTime = BestTime([&]() {
+		for (size_t i = 0; i < Count; ++i)
+			out[i] = F::template Scalar<A>(x[i], y[i]);
+		sink = out[Count - 1];
+	});
+
+	F::Array(x.data(), y.data(), out.data(), Count, A);
+	double arrayError = 0.0;
+	for (size_t i = 0; i < Count; ++i)
+		arrayError = fmax(arrayError, Error<F>(out[i], x[i], y[i]));
+	double arrayTime = BestTime([&]() {
+		F::Array(x.data(), y.data(), out.data(), Count, A);
+		sink = out[Count - 1];
+	});
+
+	bool ok = scalarError <= bound && arrayError <= bound;
+	printf("%-6s %-7s %9.2e %9.2e %9.2e %9.2f %9.2f %9.2f  %s\n", F::Name(), AccuracyNames[static_cast<int>(A)],
+		   bound, scalarError, arrayError, scalarTime, arrayTime, libraryTime, ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// prints one line per accuracy and returns false if an error was over its bound
+template<typename F>
+static bool Run(const double bounds[3], const unsigned int& seed) {
+	std::vector<float> x(Count), y(Count), out(Count);
+	Random random(seed);
+	for (size_t i = 0; i < Count; ++i)
+		F::Inputs(random, x[i], y[i]);
+
+	double libraryTime = BestTime([&]() {
+		for (size_t i = 0; i < Count; ++i)
+			out[i] = F::Library(x[i], y[i]);
+		sink = out[Count - 1];
+	});
+
+	bool passed = RunAccuracy<F, Accuracy::Low>(bounds[0], x, y, out, libraryTime);
+	passed = RunAccuracy<F, Accuracy::Medium>(bounds[1], x, y, out, libraryTime) && passed;
+	passed = RunAccuracy<F, Accuracy::Full>(bounds[2], x, y, out, libraryTime) && passed;
+	return passed;
+}
+
+// halves have to round to even in the scalar versions too, like _mm256_cvtps_epi32 in the avx2 kernels
+static bool RoundsToEven() {
+	static const float halves[] = { -3.5f, -2.5f, -1.5f, -0.5f, 0.5f, 1.5f, 2.5f, 3.5f };
+	static const int even[] = { -4, -2, -2, 0, 0, 2, 2, 4 };
+	bool passed = true;
+	for (int i = 0; i < 8; ++i)
+		passed = passed && Math::Fast::Round(halves[i]) == even[i];
+	printf("Round  halves to even  %s\n\n", passed ? "ok" : "FAILED");
+	return passed;
+}
+
+int main() {
+	printf("array versions are %s\n\n", Math::SIMD::HasAVX2() ? "8 wide with avx2" : "scalar, no avx2");
+	bool passed = RoundsToEven();
+	printf("%-6s %-7s %9s %9s %9s %9s %9s %9s\n", "", "", "bound", "scalar", "array", "scalar", "array", "libm");
+	printf("%-6s %-7s %9s %9s %9s %9s %9s %9s\n", "", "", "", "error", "error", "ns", "ns", "ns");
+
+	passed = Run<SinFunction>(SinCosBounds, 1u) && passed;
+	passed = Run<CosFunction>(SinCosBounds, 2u) && passed;
+	passed = Run<Atan2Function>(Atan2Bounds, 3u) && passed;
+	passed = Run<ExpFunction>(ExpBounds, 4u) && passed;
+	passed = Run<RsqrtFunction>(RsqrtBounds, 5u) && passed;
+
+	printf(passed ? "\nall errors are inside the documented bounds\n" : "\nsome errors are over the documented bounds\n");
+	return passed ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,322 @@
+#include "MathCases.hpp"
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+// checks that the sse and scalar builds of Vector4, Matrix4 and Quaternion agree on random inputs
+// and that Transform undoes and composes the way its matrices do in both builds
+// Cross, Matrix4 * Vector4 and the quaternion products of both builds are also checked against
+// the math worked out in double, and against a few inputs with known answers
+// errors are in ulps of the size of the terms that were added up, not of the result,
+// so a sum that cancels down to almost 0 isn't counted as thousands of ulps off
+// returns 1 if any check goes over its bound
+
+static const int CaseCount = 100000;
+
+// matrices worse than this lose most of their bits in the inverse, their inverses aren't compared
+static const double MaxCondition = 1.0e4;
+
+struct Check {
+	const char* name;
+	// the bound in ulps
+	double bound;
+	double worst;
+	int count;
+};
+
+static Check checks[] = {
+	{ "Vector4 add/sub", 1.0, 0.0, 0 },
+	{ "Vector4 scale/divide", 1.0, 0.0, 0 },
+	{ "Vector4 negate", 0.0, 0.0, 0 },
+	{ "Vector4 compound ops", 4.0, 0.0, 0 },
+	{ "Vector4 Dot", 4.0, 0.0, 0 },
+	{ "Vector4 Normalize", 4.0, 0.0, 0 },
+	{ "Matrix4 multiply", 4.0, 0.0, 0 },
+	{ "Matrix4 * Vector4", 4.0, 0.0, 0 },
+	{ "Matrix4 Transpose", 0.0, 0.0, 0 },
+	{ "Matrix4 Inverse", 4.0, 0.0, 0 },
+	{ "Matrix4 Inverse residual", 8.0, 0.0, 0 },
+	{ "Quaternion multiply", 4.0, 0.0, 0 },
+	{ "Quaternion rotate", 8.0, 0.0, 0 },
+	{ "Vector3 Cross vs double", 2.0, 0.0, 0 },
+	{ "Matrix4*Vector4 vs double", 4.0, 0.0, 0 },
+	{ "Quaternion mul vs double", 4.0, 0.0, 0 },
+	{ "Quaternion rot vs double", 8.0, 0.0, 0 },
+	{ "pinned results", 4.0, 0.0, 0 },
+	{ "Transform undo", 16.0, 0.0, 0 },
+	{ "Transform compose", 16.0, 0.0, 0 },
+	{ "InverseAffine vs Rigid", 16.0, 0.0, 0 },
+	{ "InverseAffine residual", 4.0, 0.0, 0 },
+};
+
+enum CheckIndex {
+	AddSub, ScaleDivide, Negate, Compound, Dot, Normalize,
+	MatMul, MatVec, Transpose, Inverse, InverseResidual,
+	QuatMul, Rotate,
+	CrossReference, MatVecReference, QuatMulReference, RotateReference, Pinned,
+	Undo, Compose, AffineRigid, AffineResidual
+};
+
+// how far apart a and b are in ulps of scale
+static void Compare(const CheckIndex& check, const float& a, const float& b, double scale) {
+	if (scale < FLT_MIN) scale = FLT_MIN;
+	double ulps = fabs(static_cast<double>(a) - static_cast<double>(b)) / (scale * FLT_EPSILON);
+	// nan never compares so it has to be caught on its own
+	if (a != a || b != b) ulps = HUGE_VAL;
+	if (ulps > checks[check].worst) checks[check].worst = ulps;
+	++checks[check].count;
+}
+
+static float Random(std::mt19937& rng, const float& lo, const float& hi) {
+	// std distributions differ between standard libraries, this gives the same cases everywhere
+	return lo + (hi - lo) * static_cast<float>(rng() >> 8) * (1.0f / 16777216.0f);
+}
+
+static void RandomQuaternion(std::mt19937& rng, float* q) {
+	float magSq;
+	do {
+		for (int i = 0; i < 4; ++i)
+			q[i] = Random(rng, -1.0f, 1.0f);
+		magSq = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+	} while (magSq < 0.01f);
+	float inv = 1.0f / sqrtf(magSq);
+	for (int i = 0; i < 4; ++i)
+		q[i] *= inv;
+}
+
+// the largest row sum of a matrix
+static double NormInf(const float* m) {
+	double norm = 0.0;
+	for (int r = 0; r < 4; ++r) {
+		double sum = 0.0;
+		for (int c = 0; c < 4; ++c)
+			sum += fabs(m[r * 4 + c]);
+		if (sum > norm) norm = sum;
+	}
+	return norm;
+}
+
+// the largest entry of m * inverse - identity worked out in double, in ulps of the condition number
+static double Residual(const float* m, const float* inverse, const double& condition) {
+	double worst = 0.0;
+	for (int r = 0; r < 4; ++r)
+		for (int c = 0; c < 4; ++c) {
+			double sum = r == c ? -1.0 : 0.0;
+			for (int k = 0; k < 4; ++k)
+				sum += static_cast<double>(m[r * 4 + k]) * inverse[k * 4 + c];
+			worst = fmax(worst, fabs(sum));
+		}
+	return worst / (condition * FLT_EPSILON);
+}
+
+static void CompareCase(const CaseInputs& in, const CaseResults& sse, const CaseResults& scalar) {
+	/// Vector4
+	for (int i = 0; i < 4; ++i) {
+		double ab = fabs(in.a[i]) + fabs(in.b[i]);
+		Compare(AddSub, sse.add[i], scalar.add[i], ab);
+		Compare(AddSub, sse.sub[i], scalar.sub[i], ab);
+		Compare(ScaleDivide, sse.mul[i], scalar.mul[i], fabs(scalar.mul[i]));
+		Compare(ScaleDivide, sse.div[i], scalar.div[i], fabs(scalar.div[i]));
+		Compare(Negate, sse.neg[i], scalar.neg[i], fabs(scalar.neg[i]));
+		Compare(Compound, sse.compound[i], scalar.compound[i], (1.5 * fabs(in.a[i]) + fabs(in.b[i])) * fabs(in.scalar) / 3.0);
+		Compare(Normalize, sse.normalize[i], scalar.normalize[i], 1.0);
+	}
+	double dotScale = 0.0;
+	for (int i = 0; i < 4; ++i)
+		dotScale += fabs(in.a[i] * in.b[i]);
+	Compare(Dot, sse.dot, scalar.dot, dotScale);
+
+	/// Matrix4
+	for (int r = 0; r < 4; ++r) {
+		for (int c = 0; c < 4; ++c) {
+			double scale = 0.0;
+			for (int k = 0; k < 4; ++k)
+				scale += fabs(in.matA[r * 4 + k] * in.matB[k * 4 + c]);
+			Compare(MatMul, sse.matMul[r * 4 + c], scalar.matMul[r * 4 + c], scale);
+			Compare(Transpose, sse.transpose[r * 4 + c], scalar.transpose[r * 4 + c], fabs(scalar.transpose[r * 4 + c]));
+		}
+		double scale = 0.0;
+		for (int k = 0; k < 4; ++k)
+			scale += fabs(in.matA[r * 4 + k] * in.a[k]);
+		Compare(MatVec, sse.matVec[r], scalar.matVec[r], scale);
+	}
+
+	// an inverse can only be as good as the condition number allows so the errors are in ulps of it
+	double inverseNorm = NormInf(scalar.inverse);
+	double condition = NormInf(in.matA) * inverseNorm;
+	if (condition <= MaxCondition) {
+		for (int i = 0; i < 16; ++i)
+			Compare(Inverse, sse.inverse[i], scalar.inverse[i], condition * inverseNorm);
+		double residual = fmax(Residual(in.matA, sse.inverse, condition), Residual(in.matA, scalar.inverse, condition));
+		if (residual > checks[InverseResidual].worst) checks[InverseResidual].worst = residual;
+		++checks[InverseResidual].count;
+	}
+
+	/// Quaternion
+	// the inputs are normalized so every term is at most 1
+	for (int i = 0; i < 4; ++i)
+		Compare(QuatMul, sse.quatMul[i], scalar.quatMul[i], 1.0);
+	double pointMag = sqrt(in.point[0] * in.point[0] + in.point[1] * in.point[1] + in.point[2] * in.point[2]);
+	for (int i = 0; i < 3; ++i)
+		Compare(Rotate, sse.rotate[i], scalar.rotate[i], pointMag);
+}
+
+// one build against the textbook definitions worked out in double
+static void CheckReference(const CaseInputs& in, const CaseResults& out) {
+	const float* a = in.a;
+	const float* b = in.b;
+	double cross[3] = {
+		static_cast<double>(a[1]) * b[2] - static_cast<double>(a[2]) * b[1],
+		static_cast<double>(a[2]) * b[0] - static_cast<double>(a[0]) * b[2],
+		static_cast<double>(a[0]) * b[1] - static_cast<double>(a[1]) * b[0]
+	};
+	double crossScale[3] = { fabs(a[1] * b[2]) + fabs(a[2] * b[1]), fabs(a[2] * b[0]) + fabs(a[0] * b[2]), fabs(a[0] * b[1]) + fabs(a[1] * b[0]) };
+	for (int i = 0; i < 3; ++i)
+		Compare(CrossReference, out.cross[i], static_cast<float>(cross[i]), crossScale[i]);
+
+	// every column is scaled by its lane of the vector, w too
+	for (int r = 0; r < 4; ++r) {
+		double sum = 0.0, scale = 0.0;
+		for (int k = 0; k < 4; ++k) {
+			sum += static_cast<double>(in.matA[r * 4 + k]) * a[k];
+			scale += fabs(in.matA[r * 4 + k] * a[k]);
+		}
+		Compare(MatVecReference, out.matVec[r], static_cast<float>(sum), scale);
+	}
+
+	// the hamilton product, w x y z
+	double p[4], q[4];
+	for (int i = 0; i < 4; ++i) {
+		p[i] = in.quatA[i];
+		q[i] = in.quatB[i];
+	}
+	double product[4] = {
+		p[0] * q[0] - p[1] * q[1] - p[2] * q[2] - p[3] * q[3],
+		p[0] * q[1] + p[1] * q[0] + p[2] * q[3] - p[3] * q[2],
+		p[0] * q[2] - p[1] * q[3] + p[2] * q[0] + p[3] * q[1],
+		p[0] * q[3] + p[1] * q[2] - p[2] * q[1] + p[3] * q[0]
+	};
+	for (int i = 0; i < 4; ++i)
+		Compare(QuatMulReference, out.quatMul[i], static_cast<float>(product[i]), 1.0);
+
+	// the rotation matrix of quatA times the point
+	double w = p[0], x = p[1], y = p[2], z = p[3];
+	double rotation[9] = {
+		1.0 - 2.0 * (y * y + z * z), 2.0 * (x * y - w * z), 2.0 * (x * z + w * y),
+		2.0 * (x * y + w * z), 1.0 - 2.0 * (x * x + z * z), 2.0 * (y * z - w * x),
+		2.0 * (x * z - w * y), 2.0 * (y * z + w * x), 1.0 - 2.0 * (x * x + y * y)
+	};
+	double pointMag = sqrt(in.point[0] * in.point[0] + in.point[1] * in.point[1] + in.point[2] * in.point[2]);
+	for (int r = 0; r < 3; ++r) {
+		double rotated = rotation[r * 3] * in.point[0] + rotation[r * 3 + 1] * in.point[1] + rotation[r * 3 + 2] * in.point[2];
+		Compare(RotateReference, out.rotate[r], static_cast<float>(rotated), pointMag);
+	}
+}
+
+static void CheckPinned(const PinnedResults& out) {
+	static const float crossXY[3] = { 0.0f, 0.0f, 1.0f };
+	static const float crossYZ[3] = { 1.0f, 0.0f, 0.0f };
+	static const float translatePoint[4] = { 2.0f, 3.0f, 4.0f, 1.0f };
+	static const float translateDirection[4] = { 1.0f, 1.0f, 1.0f, 0.0f };
+	static const float quatIJ[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	static const float quarterTurn[3] = { 0.0f, 1.0f, 0.0f };
+	static const float halfTurn[3] = { -1.0f, 0.0f, 0.0f };
+	for (int i = 0; i < 3; ++i) {
+		Compare(Pinned, out.crossXY[i], crossXY[i], 1.0);
+		Compare(Pinned, out.crossYZ[i], crossYZ[i], 1.0);
+	}
+	for (int i = 0; i < 4; ++i) {
+		Compare(Pinned, out.translatePoint[i], translatePoint[i], 1.0);
+		Compare(Pinned, out.translateDirection[i], translateDirection[i], 1.0);
+		Compare(Pinned, out.quatIJ[i], quatIJ[i], 1.0);
+	}
+	// sqrt(1/2) isn't exact so the turns are a few ulps off
+	for (int i = 0; i < 3; ++i) {
+		Compare(Pinned, out.quarterTurn[i], quarterTurn[i], 1.0);
+		Compare(Pinned, out.halfTurn[i], halfTurn[i], 1.0);
+	}
+}
+
+// the transforms have no sse of their own, each build is checked against what its results should be
+static void CheckTransforms(const CaseInputs& in, const CaseResults& out) {
+	double positionMag = sqrt(in.position[0] * in.position[0] + in.position[1] * in.position[1] + in.position[2] * in.position[2]);
+	for (int r = 0; r < 4; ++r)
+		for (int c = 0; c < 4; ++c) {
+			int i = r * 4 + c;
+			float identity = r == c ? 1.0f : 0.0f;
+			// the translation of T.Inverse() is the position divided by the scale, so it sets the size there
+			double scale = c == 3 ? positionMag * (1.0 + 1.0 / in.uniformScale) : 1.0;
+			Compare(Undo, out.undo[i], identity, scale);
+			Compare(Undo, out.undoLeft[i], identity, scale);
+			Compare(AffineRigid, out.inverseAffine[i], out.inverseRigid[i], c == 3 ? positionMag : 1.0);
+
+			double product = 0.0, productScale = 0.0;
+			for (int k = 0; k < 4; ++k) {
+				product += static_cast<double>(out.composeLeft[r * 4 + k]) * out.composeRight[k * 4 + c];
+				productScale += fabs(out.composeLeft[r * 4 + k] * out.composeRight[k * 4 + c]);
+			}
+			// (T * U) builds its rotation from the product of the quaternions, so its entries are only as
+			// good as the scales even where the two rotation matrices multiply out to something small
+			if (c < 3) productScale = fmax(productScale, in.uniformScale * in.otherScale);
+			Compare(Compose, out.compose[i], static_cast<float>(product), productScale);
+		}
+
+	double condition = NormInf(out.scaled) * NormInf(out.scaledInverse);
+	double residual = Residual(out.scaled, out.scaledInverse, condition);
+	if (residual > checks[AffineResidual].worst) checks[AffineResidual].worst = residual;
+	++checks[AffineResidual].count;
+}
+
+int main() {
+	printf("sse %s\n", SSEEnabled() ? "on" : "off, both builds are scalar");
+
+	std::mt19937 rng(12345);
+	for (int n = 0; n < CaseCount; ++n) {
+		CaseInputs in;
+		for (int i = 0; i < 4; ++i) {
+			in.a[i] = Random(rng, -100.0f, 100.0f);
+			in.b[i] = Random(rng, -100.0f, 100.0f);
+		}
+		in.scalar = Random(rng, 0.1f, 10.0f);
+		if (n & 1) in.scalar = -in.scalar;
+		for (int i = 0; i < 16; ++i) {
+			in.matA[i] = Random(rng, -2.0f, 2.0f);
+			in.matB[i] = Random(rng, -2.0f, 2.0f);
+		}
+		RandomQuaternion(rng, in.quatA);
+		RandomQuaternion(rng, in.quatB);
+		for (int i = 0; i < 3; ++i)
+			in.point[i] = Random(rng, -50.0f, 50.0f);
+		for (int i = 0; i < 3; ++i) {
+			in.position[i] = Random(rng, -50.0f, 50.0f);
+			in.scale[i] = Random(rng, 0.25f, 4.0f);
+		}
+		in.uniformScale = Random(rng, 0.25f, 4.0f);
+		in.otherScale = Random(rng, 0.25f, 4.0f);
+
+		CaseResults sse, scalar;
+		RunSSE(in, sse);
+		RunScalar(in, scalar);
+		CompareCase(in, sse, scalar);
+		CheckReference(in, sse);
+		CheckReference(in, scalar);
+		CheckTransforms(in, sse);
+		CheckTransforms(in, scalar);
+	}
+
+	PinnedResults pinnedSSE, pinnedScalar;
+	PinnedSSE(pinnedSSE);
+	PinnedScalar(pinnedScalar);
+	CheckPinned(pinnedSSE);
+	CheckPinned(pinnedScalar);
+
+	bool passed = true;
+	for (const Check& check : checks) {
+		bool ok = check.worst <= check.bound;
+		passed = passed && ok;
+		printf("%-26s %8d values  max %8.3f ulps  bound %5.1f  %s\n", check.name, check.count, check.worst, check.bound, ok ? "ok" : "FAILED");
+	}
+	printf(passed ? "all passed\n" : "some checks FAILED\n");
+	return passed ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef TESTS_MATH_CASES_HPP
+#define TESTS_MATH_CASES_HPP
+
+// one random case, plain floats so both builds of the math types can read it
+struct CaseInputs {
+	float a[4], b[4];
+	float scalar;
+	float matA[16], matB[16];
+	// normalized
+	float quatA[4], quatB[4];
+	float point[3];
+	// the transforms are built from quatA and position, and from quatB and point
+	float position[3];
+	float uniformScale, otherScale;
+	float scale[3];
+};
+
+// what one build of the math types gave for a case
+struct CaseResults {
+	/// Vector4
+	float add[4], sub[4], mul[4], div[4], neg[4];
+	// +=, -=, *= and /= one after another
+	float compound[4];
+	float dot;
+	float normalize[4];
+
+	/// Vector3
+	// the cross product of the x y z of a and b
+	float cross[3];
+
+	/// Matrix4
+	float matMul[16];
+	float matVec[4];
+	float transpose[16];
+	float inverse[16];
+
+	/// Quaternion
+	float quatMul[4];
+	float rotate[3];
+
+	/// Transform
+	// T * T.Inverse() and T.Inverse() * T as matrices, both should be the identity
+	float undo[16], undoLeft[16];
+	// (T * U).GetMatrix() and the two matrices it should be the product of
+	float compose[16], composeLeft[16], composeRight[16];
+	// the matrix of a transform with no scale inverted both ways
+	float rigid[16], inverseAffine[16], inverseRigid[16];
+	// the matrix of a transform with non uniform scale and its InverseAffine
+	float scaled[16], scaledInverse[16];
+};
+
+// fixed inputs with known answers, these were wrong before the sse versions were added
+struct PinnedResults {
+	// (1, 0, 0) x (0, 1, 0) and (0, 1, 0) x (0, 0, 1)
+	float crossXY[3], crossYZ[3];
+	// Translate(1, 2, 3) times the point (1, 1, 1, 1) and times the direction (1, 1, 1, 0)
+	float translatePoint[4], translateDirection[4];
+	// i * j
+	float quatIJ[4];
+	// a quarter turn about z applied to (1, 0, 0), then the product of two quarter turns applied to it
+	float quarterTurn[3], halfTurn[3];
+};
+
+// runs the case with the sse versions when the compiler targets sse, defined in SSECases.cpp
+void RunSSE(const CaseInputs& in, CaseResults& out);
+// runs the case with MATH_NO_SSE, defined in ScalarCases.cpp
+void RunScalar(const CaseInputs& in, CaseResults& out);
+// the pinned inputs with each build
+void PinnedSSE(PinnedResults& out);
+void PinnedScalar(PinnedResults& out);
+// whether RunSSE really used sse
+bool SSEEnabled();
+
+#endif // !TESTS_MATH_CASES_HPP
\ No newline at end of file
@@ -0,0 +1,108 @@
+#ifndef TESTS_RUN_CASES_HPP
+#define TESTS_RUN_CASES_HPP
+#include "MathCases.hpp"
+#include "../../3D Engine/Engine/Math/Vector.hpp"
+#include "../../3D Engine/Engine/Math/Matrix.hpp"
+#include "../../3D Engine/Engine/Math/Quaternion.hpp"
+#include "../../3D Engine/Engine/Math/Transform.hpp"
+
+// the body of RunSSE and RunScalar, each one includes this with a different build of the math types
+// static so the two copies don't collide when they are linked together
+
+static void CopyOut(const Math::Vector4& v, float* out) {
+	out[0] = v.x; out[1] = v.y; out[2] = v.z; out[3] = v.w;
+}
+
+static void CopyOut(const Math::Matrix4& m, float* out) {
+	for (int i = 0; i < 16; ++i)
+		out[i] = m.m[i];
+}
+
+static void CopyOut(const Math::Quaternion& q, float* out) {
+	out[0] = q.w; out[1] = q.x; out[2] = q.y; out[3] = q.z;
+}
+
+static Math::Matrix4 MakeMatrix(const float* m) {
+	return Math::Matrix4(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7],
+						 m[8], m[9], m[10], m[11], m[12], m[13], m[14], m[15]);
+}
+
+static void RunCase(const CaseInputs& in, CaseResults& out) {
+	/// Vector4
+	Math::Vector4 a(in.a[0], in.a[1], in.a[2], in.a[3]);
+	Math::Vector4 b(in.b[0], in.b[1], in.b[2], in.b[3]);
+	CopyOut(a + b, out.add);
+	CopyOut(a - b, out.sub);
+	CopyOut(a * in.scalar, out.mul);
+	CopyOut(a / in.scalar, out.div);
+	CopyOut(-a, out.neg);
+
+	Math::Vector4 c = a;
+	c += b;
+	c -= a * 0.5f;
+	c *= in.scalar;
+	c /= 3.0f;
+	CopyOut(c, out.compound);
+
+	out.dot = Math::Vector4::Dot(a, b);
+	CopyOut(Math::Vector4::Normalize(a), out.normalize);
+
+	/// Vector3
+	Math::Vector3 cross = Math::Vector3::Cross(Math::Vector3(in.a[0], in.a[1], in.a[2]), Math::Vector3(in.b[0], in.b[1], in.b[2]));
+	out.cross[0] = cross.x; out.cross[1] = cross.y; out.cross[2] = cross.z;
+
+	/// Matrix4
+	Math::Matrix4 matA = MakeMatrix(in.matA);
+	Math::Matrix4 matB = MakeMatrix(in.matB);
+	CopyOut(matA * matB, out.matMul);
+	CopyOut(matA * a, out.matVec);
+	CopyOut(matA.Transpose(), out.transpose);
+	CopyOut(matA.Inverse(), out.inverse);
+
+	/// Quaternion
+	Math::Quaternion quatA(in.quatA[0], in.quatA[1], in.quatA[2], in.quatA[3]);
+	Math::Quaternion quatB(in.quatB[0], in.quatB[1], in.quatB[2], in.quatB[3]);
+	CopyOut(quatA * quatB, out.quatMul);
+	Math::Vector3 rotated = quatA * Math::Vector3(in.point[0], in.point[1], in.point[2]);
+	out.rotate[0] = rotated.x; out.rotate[1] = rotated.y; out.rotate[2] = rotated.z;
+
+	/// Transform
+	Math::Vector3 position(in.position[0], in.position[1], in.position[2]);
+	Math::Vector3 point(in.point[0], in.point[1], in.point[2]);
+	Math::Transform t(position, quatA, Math::Vector3(in.uniformScale, in.uniformScale, in.uniformScale));
+	Math::Transform u(point, quatB, Math::Vector3(in.otherScale, in.otherScale, in.otherScale));
+	CopyOut((t * t.Inverse()).GetMatrix(), out.undo);
+	CopyOut((t.Inverse() * t).GetMatrix(), out.undoLeft);
+	CopyOut((t * u).GetMatrix(), out.compose);
+	CopyOut(t.GetMatrix(), out.composeLeft);
+	CopyOut(u.GetMatrix(), out.composeRight);
+
+	Math::Transform rigid(position, quatA);
+	CopyOut(rigid.GetMatrix(), out.rigid);
+	CopyOut(rigid.GetMatrix().InverseAffine(), out.inverseAffine);
+	CopyOut(rigid.GetMatrix().InverseRigid(), out.inverseRigid);
+
+	Math::Transform scaled(position, quatA, Math::Vector3(in.scale[0], in.scale[1], in.scale[2]));
+	CopyOut(scaled.GetMatrix(), out.scaled);
+	CopyOut(scaled.GetMatrix().InverseAffine(), out.scaledInverse);
+}
+
+static void CopyOut(const Math::Vector3& v, float* out) {
+	out[0] = v.x; out[1] = v.y; out[2] = v.z;
+}
+
+static void RunPinned(PinnedResults& out) {
+	CopyOut(Math::Vector3::Cross(Math::Vector3(1.0f, 0.0f, 0.0f), Math::Vector3(0.0f, 1.0f, 0.0f)), out.crossXY);
+	CopyOut(Math::Vector3::Cross(Math::Vector3(0.0f, 1.0f, 0.0f), Math::Vector3(0.0f, 0.0f, 1.0f)), out.crossYZ);
+
+	Math::Matrix4 translate = Math::Matrix4::Translate(1.0f, 2.0f, 3.0f);
+	CopyOut(translate * Math::Vector4(1.0f, 1.0f, 1.0f, 1.0f), out.translatePoint);
+	CopyOut(translate * Math::Vector4(1.0f, 1.0f, 1.0f, 0.0f), out.translateDirection);
+
+	CopyOut(Math::Quaternion(0.0f, 1.0f, 0.0f, 0.0f) * Math::Quaternion(0.0f, 0.0f, 1.0f, 0.0f), out.quatIJ);
+	Math::Quaternion quarter(M_SQRT1_2, 0.0f, 0.0f, M_SQRT1_2);
+	CopyOut(quarter * Math::Vector3(1.0f, 0.0f, 0.0f), out.quarterTurn);
+	CopyOut((quarter * quarter) * Math::Vector3(1.0f, 0.0f, 0.0f), out.halfTurn);
+}
+
+#endif // !TESTS_RUN_CASES_HPP
\ No newline at end of file
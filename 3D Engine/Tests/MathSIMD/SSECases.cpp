@@ -0,0 +1,13 @@
+#include "RunCases.hpp"
+
+void RunSSE(const CaseInputs& in, CaseResults& out) {
+	RunCase(in, out);
+}
+
+void PinnedSSE(PinnedResults& out) {
+	RunPinned(out);
+}
+
+bool SSEEnabled() {
+	return MATH_SSE != 0;
+}
\ No newline at end of file
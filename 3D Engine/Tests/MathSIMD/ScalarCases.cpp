@@ -0,0 +1,22 @@
+// the standard headers the math headers use come first so the rename below can't touch them
+#include <math.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+// builds the scalar versions of the math types in this file only
+// Math is renamed so they don't clash with the sse versions in SSECases.cpp when linked together
+#define MATH_NO_SSE
+#define Math ScalarMath
+#include "RunCases.hpp"
+
+void RunScalar(const CaseInputs& in, CaseResults& out) {
+	RunCase(in, out);
+}
+
+void PinnedScalar(PinnedResults& out) {
+	RunPinned(out);
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include "../../3D Engine/Engine/Physics.hpp"
+#include "../../3D Engine/Engine/Jobs.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// steps a world through PhysicsThread while other threads read its snapshot, and checks that no read is torn
+// a second world is stepped on this thread with the same timesteps and captured after every step,
+// stepping on another thread gives exactly the same bodies so every read has to match it bit for bit
+// a read that mixes two steps, or sees the snapshot change while the next step runs, doesnt match
+// returns 1 if any check fails
+
+using namespace Physics;
+
+static const int BodyCount = 1000;
+static const int Frames = 120;
+static const int ReaderCount = 3;
+// how many times each reader goes over the whole snapshot in a frame, while the next step is running
+static const int Passes = 16;
+
+// the frame times cycle through these, some are shorter than the world's timestep so not every frame steps
+static const float DeltaTimes[] = { 0.016f, 0.021f, 0.009f, 0.033f, 0.017f };
+
+struct Check {
+	const char* name;
+	unsigned int cases;
+	unsigned int failed;
+};
+
+static Check checks[] = {
+	{ "snapshot reads while stepping", 0, 0 },
+	{ "bodies found by handle", 0, 0 },
+	{ "world after Wait", 0, 0 },
+};
+
+enum CheckIndex {
+	Reads, Handles, AfterWait
+};
+
+// reader threads update the checks at the same time
+static std::atomic<unsigned int> counts[3][2];
+
+static void Count(const CheckIndex& check, const bool& passed) {
+	counts[check][0].fetch_add(1, std::memory_order_relaxed);
+	if (!passed) counts[check][1].fetch_add(1, std::memory_order_relaxed);
+}
+
+// a floor of spinning spheres falling onto a big static one, so every body moves in every step
+static void Fill(World& world) {
+	Staticbody* ground = world.CreateBody<Staticbody>();
+	ground->SetCollider<SphereColldier>()->SetRadius(10000.0f);
+	ground->SetPosition(Math::Vector3(0.0f, -10000.0f, 0.0f));
+	for (int i = 0; i < BodyCount; ++i) {
+		Rigidbody* body = world.CreateBody<Rigidbody>();
+		body->SetCollider<SphereColldier>()->SetRadius(0.5f);
+		body->SetPosition(Math::Vector3((i % 40) * 1.01f, 0.5f, (i / 40 % 40) * 1.01f));
+		body->SetAcceleration(Math::Vector3(0.0f, -9.8f, 0.0f));
+		body->SetAngularVelocity(Math::Vector3(0.0f, 90.0f, 0.0f));
+	}
+}
+
+static bool Same(const Math::Vector3& a, const Math::Vector3& b) {
+	return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+static bool Same(const Math::Quaternion& a, const Math::Quaternion& b) {
+	return a.w == b.w && a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+// goes over every body in the snapshot once, returns false if anything differs from expected
+static bool ReadSnapshot(const BodySnapshot& snapshot, const BodySnapshot& expected) {
+	if (snapshot.size() != expected.size() || snapshot.GetAlpha() != expected.GetAlpha()) return false;
+	bool same = true;
+	for (unsigned int i = 0; i < snapshot.size(); ++i) {
+		same = same && snapshot.GetHandle(i) == expected.GetHandle(i);
+		same = same && Same(snapshot.GetPosition(i, 0.0f), expected.GetPosition(i, 0.0f));
+		same = same && Same(snapshot.GetPosition(i, 1.0f), expected.GetPosition(i, 1.0f));
+		same = same && Same(snapshot.GetRotation(i, 0.0f), expected.GetRotation(i, 0.0f));
+		same = same && Same(snapshot.GetRotation(i, 1.0f), expected.GetRotation(i, 1.0f));
+	}
+	return same;
+}
+
+// hands each frame's expected snapshot to the reader threads and waits for them to finish with it
+struct Readers {
+	std::mutex lock;
+	std::condition_variable signal;
+	const BodySnapshot* expected = nullptr;
+	int frame = -1;
+	int pending = 0;
+	bool quit = false;
+};
+
+static void ReaderLoop(const PhysicsThread* physics, Readers* readers) {
+	int last = -1;
+	while (true) {
+		const BodySnapshot* expected;
+		{
+			std::unique_lock<std::mutex> guard(readers->lock);
+			readers->signal.wait(guard, [&]() { return readers->frame != last || readers->quit; });
+			if (readers->quit) return;
+			last = readers->frame;
+			expected = readers->expected;
+		}
+
+		for (int pass = 0; pass < Passes; ++pass)
+			Count(Reads, ReadSnapshot(physics->GetSnapshot(), *expected));
+
+		const BodySnapshot& snapshot = physics->GetSnapshot();
+		for (unsigned int i = 0; i < expected->size(); ++i) {
+			unsigned int index;
+			Count(Handles, snapshot.Find(expected->GetHandle(i), index) && index == i);
+		}
+
+		{
+			std::lock_guard<std::mutex> guard(readers->lock);
+			--readers->pending;
+		}
+		readers->signal.notify_all();
+	}
+}
+
+int main() {
+	// each world has its own job system so the two never share workers
+	Jobs::JobSystem referenceJobs(2), jobs(2);
+	WorldSettings referenceSettings, settings;
+	referenceSettings.jobSystem = &referenceJobs;
+	settings.jobSystem = &jobs;
+	World reference(referenceSettings), world(settings);
+	Fill(reference);
+	Fill(world);
+
+	// the Step for frame f publishes the world after f steps
+	std::unique_ptr<BodySnapshot[]> expected(new BodySnapshot[Frames]);
+	for (int f = 0; f < Frames; ++f) {
+		expected[f].Capture(reference.GetStorage(), reference.GetInterpolationAlpha(), nullptr);
+		reference.Step(DeltaTimes[f % 5]);
+	}
+
+	Readers readers;
+	PhysicsThread physics(&world);
+	std::vector<std::thread> threads;
+	for (int r = 0; r < ReaderCount; ++r)
+		threads.emplace_back(ReaderLoop, &physics, &readers);
+
+	for (int f = 0; f < Frames; ++f) {
+		physics.Step(DeltaTimes[f % 5]);
+
+		// the next step is running now, the readers have to see the published one stay put
+		{
+			std::lock_guard<std::mutex> guard(readers.lock);
+			readers.expected = &expected[f];
+			readers.frame = f;
+			readers.pending = ReaderCount;
+		}
+		readers.signal.notify_all();
+
+		std::unique_lock<std::mutex> guard(readers.lock);
+		readers.signal.wait(guard, [&]() { return readers.pending == 0; });
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(readers.lock);
+		readers.quit = true;
+	}
+	readers.signal.notify_all();
+	for (std::thread& thread : threads)
+		thread.join();
+
+	// after Wait the last step is done and the world can be read directly
+	physics.Wait();
+	const BodyStorage& stepped = world.GetStorage();
+	const BodyStorage& single = reference.GetStorage();
+	Count(AfterWait, stepped.size() == single.size());
+	for (size_t i = 0; i < stepped.size() && i < single.size(); ++i) {
+		Count(AfterWait, stepped.handles[i] == single.handles[i]
+				  && Same(stepped.positions[i], single.positions[i]) && Same(stepped.rotations[i], single.rotations[i]));
+	}
+
+	bool passed = true;
+	for (int i = 0; i < 3; ++i) {
+		checks[i].cases = counts[i][0].load();
+		checks[i].failed = counts[i][1].load();
+		printf("%-32s %8u cases %8u failed  %s\n", checks[i].name, checks[i].cases, checks[i].failed, checks[i].failed == 0 ? "ok" : "FAILED");
+		passed = passed && checks[i].failed == 0 && checks[i].cases > 0;
+	}
+
+	printf(passed ? "\nall passed\n" : "\nsome checks FAILED\n");
+	return passed ? 0 : 1;
+}
\ No newline at end of file